@@ -13,6 +13,7 @@
 
 #include <gtdynamics/dynamics/DynamicsGraph.h>
 #include <gtdynamics/factors/MinTorqueFactor.h>
+#include <gtdynamics/optimizer/ILQROptimizer.h>
 #include <gtdynamics/universal_robot/Robot.h>
 #include <gtdynamics/universal_robot/sdf.h>
 #include <gtdynamics/utils/Initializer.h>
@@ -21,6 +22,7 @@
 #include <gtsam/linear/NoiseModel.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -63,32 +65,41 @@ int main(int argc, char** argv) {
     graph.addPrior(TorqueKey(j1_id, t), 0.0, Constrained::All(1));
 
   // Add initial conditions to trajectory factor graph.
-  graph.addPrior(JointAngleKey(j0_id, 0), X_i[0], dynamics_model);
-  graph.addPrior(JointVelKey(j0_id, 0), X_i[1], dynamics_model);
-  graph.addPrior(JointAngleKey(j1_id, 0), X_i[3], dynamics_model);
-  graph.addPrior(JointVelKey(j1_id, 0), X_i[4], dynamics_model);
-
-  // Add terminal conditions to the factor graph.
-  graph.addPrior(JointVelKey(j0_id, t_steps), X_T[1], objectives_model);
-  graph.addPrior(JointAccelKey(j0_id, t_steps), X_T[2], objectives_model);
-  graph.addPrior(JointVelKey(j1_id, t_steps), X_T[4], objectives_model);
-  graph.addPrior(JointAccelKey(j1_id, t_steps), X_T[5], objectives_model);
+  gtsam::NonlinearFactorGraph initial_conditions;
+  initial_conditions.addPrior(JointAngleKey(j0_id, 0), X_i[0], dynamics_model);
+  initial_conditions.addPrior(JointVelKey(j0_id, 0), X_i[1], dynamics_model);
+  initial_conditions.addPrior(JointAngleKey(j1_id, 0), X_i[3], dynamics_model);
+  initial_conditions.addPrior(JointVelKey(j1_id, 0), X_i[4], dynamics_model);
+  graph.add(initial_conditions);
+
+  // Add terminal conditions to the objectives.
+  gtsam::NonlinearFactorGraph objectives;
+  objectives.addPrior(JointVelKey(j0_id, t_steps), X_T[1], objectives_model);
+  objectives.addPrior(JointAccelKey(j0_id, t_steps), X_T[2], objectives_model);
+  objectives.addPrior(JointVelKey(j1_id, t_steps), X_T[4], objectives_model);
+  objectives.addPrior(JointAccelKey(j1_id, t_steps), X_T[5], objectives_model);
 
   // Insert position objective (x, theta) factor at every timestep or only at
   // the terminal state. Adding the position objective at every timestep will
   // force the system to converge to the desired state quicker at the cost of
   // more impulsive control actions.
   bool apply_pos_objective_all_dt = false;
-  graph.addPrior(JointAngleKey(j0_id, t_steps), X_T[0], pos_objectives_model);
-  graph.addPrior(JointAngleKey(j1_id, t_steps), X_T[3], pos_objectives_model);
+  objectives.addPrior(JointAngleKey(j0_id, t_steps), X_T[0],
+                      pos_objectives_model);
+  objectives.addPrior(JointAngleKey(j1_id, t_steps), X_T[3],
+                      pos_objectives_model);
   if (apply_pos_objective_all_dt) {
     for (int t = 0; t < t_steps; t++) {
-      graph.addPrior(JointAngleKey(j0_id, t), X_T[0], pos_objectives_model);
-      graph.addPrior(JointAngleKey(j1_id, t), X_T[3], pos_objectives_model);
+      objectives.addPrior(JointAngleKey(j0_id, t), X_T[0],
+                          pos_objectives_model);
+      objectives.addPrior(JointAngleKey(j1_id, t), X_T[3],
+                          pos_objectives_model);
     }
   }
   for (int t = 0; t <= t_steps; t++)
-    graph.emplace_shared<MinTorqueFactor>(TorqueKey(j0_id, t), control_model);
+    objectives.emplace_shared<MinTorqueFactor>(TorqueKey(j0_id, t),
+                                               control_model);
+  graph.add(objectives);
 
   // Initialize solution.
   Initializer initializer;
@@ -121,5 +132,39 @@ int main(int argc, char** argv) {
   }
   traj_file.close();
 
+  // Compare LM and iLQR on the Euler transcription of the same problem. iLQR
+  // enforces the dynamics, and the unactuated pendulum joint, by simulation.
+  auto euler_graph =
+      graph_builder.trajectoryFG(cp, t_steps, dt, CollocationScheme::Euler);
+  for (int t = 0; t <= t_steps; t++)
+    euler_graph.addPrior(TorqueKey(j1_id, t), 0.0, Constrained::All(1));
+  euler_graph.add(initial_conditions);
+  euler_graph.add(objectives);
+
+  ILQRParameters ilqr_params;
+  ilqr_params.max_iterations = 40;
+  ilqr_params.unactuated_joints = {j1_id};
+  ILQROptimizer ilqr(cp, graph_builder, t_steps, dt, ilqr_params);
+
+  auto timed = [](auto&& solve) {
+    auto start = std::chrono::steady_clock::now();
+    gtsam::Values result = solve();
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return std::make_pair(result, elapsed.count());
+  };
+  params.setVerbosityLM("SILENT");
+  auto [lm_result, lm_ms] = timed([&] {
+    return gtsam::LevenbergMarquardtOptimizer(euler_graph, init_vals, params)
+        .optimize();
+  });
+  auto [ilqr_result, ilqr_ms] =
+      timed([&] { return ilqr.optimize(objectives, {}, init_vals); });
+  std::cout << "\nEuler collocation, objective and time [ms]:" << std::endl;
+  std::cout << "LM:   " << objectives.error(lm_result) << ", " << lm_ms
+            << std::endl;
+  std::cout << "iLQR: " << objectives.error(ilqr_result) << ", " << ilqr_ms
+            << std::endl;
+
   return 0;
 }
@@ -0,0 +1,28 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  benchmarkTiming.h
+ * @brief Wall-clock timing shared by the benchmark scripts.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+namespace gtdynamics {
+
+/// Return the wall time of `f` in milliseconds.
+inline double TimeMs(const std::function<void()>& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace gtdynamics
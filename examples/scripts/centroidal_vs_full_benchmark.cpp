@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  centroidal_vs_full_benchmark.cpp
+ * @brief Compare graph construction and solve time of the centroidal model
+ * against the full multi-phase dynamics graph, on the A1 trotting gait.
+ */
+
+#include <gtdynamics/dynamics/CentroidalDynamics.h>
+#include <gtdynamics/factors/ObjectiveFactors.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/Trajectory.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <iostream>
+#include <string>
+
+#include "benchmarkTiming.h"
+
+using namespace gtsam;
+using namespace gtdynamics;
+using gtsam::noiseModel::Isotropic;
+using gtsam::noiseModel::Unit;
+
+/// A1 trot: stand, RR+FL stance, stand, RL+FR stance.
+Trajectory TrotTrajectory(const Robot& robot, size_t repeat) {
+  std::vector<LinkSharedPtr> rlfr = {robot.link("RL_lower"),
+                                     robot.link("FR_lower")};
+  std::vector<LinkSharedPtr> rrfl = {robot.link("RR_lower"),
+                                     robot.link("FL_lower")};
+  auto all_feet = rlfr;
+  all_feet.insert(all_feet.end(), rrfl.begin(), rrfl.end());
+
+  const Point3 contact_in_com(0, 0, -0.07);
+  auto stationary =
+      std::make_shared<FootContactConstraintSpec>(all_feet, contact_in_com);
+  auto RLFR = std::make_shared<FootContactConstraintSpec>(rlfr, contact_in_com);
+  auto RRFL = std::make_shared<FootContactConstraintSpec>(rrfl, contact_in_com);
+
+  WalkCycle walk_cycle({stationary, RRFL, stationary, RLFR}, {1, 5, 1, 5});
+  return Trajectory(walk_cycle, repeat);
+}
+
+/// Print one result row.
+void PrintRow(const std::string& model, const NonlinearFactorGraph& graph,
+              const Values& init, double graph_ms, double opt_ms,
+              size_t iterations, double error) {
+  std::cout << model << "," << graph.size() << "," << init.dim() << ","
+            << graph_ms << "," << opt_ms << "," << iterations << "," << error
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const std::string urdf_path =
+      argc > 1 ? argv[1] : kUrdfPath + std::string("a1/a1.urdf");
+  const size_t repeat = argc > 2 ? std::stoul(argv[2]) : 1;
+
+  Robot robot = CreateRobotFromFile(urdf_path, "a1");
+  Trajectory trajectory = TrotTrajectory(robot, repeat);
+  const int K = trajectory.getEndTimeStep(trajectory.numPhases() - 1);
+  const Vector3 gravity(0, 0, -9.8);
+  const double mu = 1.0, dt = 1. / 240;
+  auto base_link = robot.link("trunk");
+  const Pose3 base_pose(Rot3(), Point3(0, 0, 0.4));
+
+  LevenbergMarquardtParams lm_params;
+  lm_params.setlambdaInitial(1e10);
+  lm_params.setlambdaLowerBound(1e-7);
+  lm_params.setlambdaUpperBound(1e10);
+  lm_params.setAbsoluteErrorTol(1.0);
+
+  std::cout << "model,factors,dim,graph_ms,opt_ms,iterations,error"
+            << std::endl;
+
+  // Full model: every link pose, twist and wrench, every joint.
+  double full_ms = 0;
+  {
+    OptimizerSetting opt(1e-5);
+    DynamicsGraph graph_builder(opt, gravity);
+    NonlinearFactorGraph graph;
+    const double graph_ms = TimeMs([&]() {
+      graph = trajectory.multiPhaseFactorGraph(robot, graph_builder,
+                                               CollocationScheme::Euler, mu);
+      for (int k = 0; k <= K; k++) {
+        graph.add(LinkObjectives(base_link->id(), k)
+                      .pose(base_pose, Isotropic::Sigma(6, 1e-5))
+                      .twist(Z_6x1, Isotropic::Sigma(6, 1e-4)));
+      }
+      trajectory.addBoundaryConditions(
+          &graph, robot, opt.bp_cost_model, opt.bv_cost_model,
+          Isotropic::Sigma(6, 1e-5), Isotropic::Sigma(1, 1e-5),
+          Isotropic::Sigma(1, 1e-5));
+      trajectory.addIntegrationTimeFactors(&graph, dt, 1e-30);
+      trajectory.addMinimumTorqueFactors(&graph, robot, Unit::Create(1));
+    });
+
+    Initializer initializer;
+    Values init =
+        trajectory.multiPhaseInitialValues(robot, initializer, 1e-3, dt);
+    size_t iterations = 0;
+    double error = 0;
+    const double opt_ms = TimeMs([&]() {
+      LevenbergMarquardtOptimizer optimizer(graph, init, lm_params);
+      error = graph.error(optimizer.optimize());
+      iterations = optimizer.iterations();
+    });
+    full_ms = graph_ms + opt_ms;
+    PrintRow("full", graph, init, graph_ms, opt_ms, iterations, error);
+  }
+
+  // Centroidal model: one rigid body plus contact points and forces.
+  double centroidal_ms = 0;
+  {
+    auto model = CentroidalModel::FromRobot(robot, "trunk");
+    CentroidalGraphParams params;
+    params.gravity = gravity;
+    params.mu = mu;
+    params.dt = dt;
+    CentroidalGraph graph_builder(model, params);
+    const Pose3 wTc = base_pose * model.cMbase.inverse();
+
+    NonlinearFactorGraph graph;
+    const double graph_ms = TimeMs([&]() {
+      graph = graph_builder.trajectoryFG(trajectory);
+      for (int k = 0; k <= K; k++) {
+        graph.addPrior(CentroidalPoseKey(k), wTc, Isotropic::Sigma(6, 1e-2));
+      }
+      graph.addPrior<Vector6>(CentroidalMomentumKey(0), Z_6x1,
+                              Isotropic::Sigma(6, 1e-3));
+    });
+
+    Values init = graph_builder.initialValues(trajectory, wTc);
+    size_t iterations = 0;
+    double error = 0;
+    const double opt_ms = TimeMs([&]() {
+      LevenbergMarquardtOptimizer optimizer(graph, init, lm_params);
+      error = graph.error(optimizer.optimize());
+      iterations = optimizer.iterations();
+    });
+    centroidal_ms = graph_ms + opt_ms;
+    PrintRow("centroidal", graph, init, graph_ms, opt_ms, iterations, error);
+  }
+
+  std::cout << "speedup: " << full_ms / centroidal_ms << "x" << std::endl;
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  gait_library.cpp
+ * @brief Generate an A1 gait library over step lengths, phase lengths and
+ * trot or pace contact sequences, and print the solve statistics as CSV.
+ * Usage: gait_library [library file] [number of threads]
+ */
+
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/GaitLibrary.h>
+
+#include <iostream>
+#include <string>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+int main(int argc, char** argv) {
+  const std::string file_path = argc > 1 ? argv[1] : "a1_gait_library.txt";
+  const Robot robot =
+      CreateRobotFromFile(kUrdfPath + std::string("a1/a1.urdf"), "a1");
+
+  // Stationary, then two diagonal (trot) or lateral (pace) pairs in stance.
+  auto feet = [&](const std::vector<std::string>& names) {
+    std::vector<LinkSharedPtr> links;
+    for (auto&& name : names) links.push_back(robot.link(name + "_lower"));
+    return std::make_shared<FootContactConstraintSpec>(links,
+                                                       Point3(0, 0, -0.07));
+  };
+  auto all = feet({"FL", "FR", "RL", "RR"});
+  GaitGrid grid;
+  grid.contact_sequences = {
+      {all, feet({"RR", "FL"}), all, feet({"RL", "FR"})},
+      {all, feet({"FL", "RL"}), all, feet({"FR", "RR"})}};
+  grid.phase_lengths = {{1, 5, 1, 5}, {1, 8, 1, 8}};
+  for (double length : {0.05, 0.1, 0.15, 0.2, 0.25}) {
+    grid.steps.emplace_back(length, 0, 0);
+  }
+
+  const DynamicsGraph graph_builder(OptimizerSetting(1e-5),
+                                    Vector3(0, 0, -9.8));
+  GaitLibraryParams params;
+  params.num_threads = argc > 2 ? std::stoul(argv[2]) : 0;
+  params.lm_params.setlambdaInitial(1e10);
+  params.lm_params.setlambdaLowerBound(1e-7);
+  params.lm_params.setlambdaUpperBound(1e10);
+  params.lm_params.setAbsoluteErrorTol(1.0);
+  const GaitLibrary library(
+      grid, WalkingGaitProblem(robot, graph_builder, 1.0, 1. / 240), params);
+  library.write(robot, file_path);
+
+  std::cout << "index,step,phase_lengths,contact_sequence,iterations,"
+               "initial_error,final_error,solve_ms,warm_start\n";
+  for (size_t i = 0; i < library.size(); i++) {
+    const auto& entry = library.entries()[i];
+    std::cout << i << "," << entry.variant.step.x() << ","
+              << entry.variant.phase_lengths[1] << ","
+              << entry.variant.contact_sequence << ","
+              << entry.stats.iterations << "," << entry.stats.initial_error
+              << "," << entry.stats.final_error << ","
+              << entry.stats.solve_ms << "," << entry.stats.warm_start
+              << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  gtdynamics_replay.cpp
+ * @brief Re-run a captured problem (see ProblemCapture) under one or all
+ * optimizers, and print timing in the benchmark latex table format.
+ *
+ * Usage: gtdynamics_replay problem.bin
+ *                          [captured|soft|manifold|penalty|al|all]
+ *                          [trace.json]
+ *
+ * By default, the problem is solved as it was captured, i.e., with the
+ * captured method and all the captured optimizer parameters. The other modes
+ * compare the benchmark optimizers, with the captured LM parameters only.
+ */
+
+#include <gtdynamics/optimizer/OptimizationBenchmark.h>
+#include <gtdynamics/optimizer/ProblemCapture.h>
+#include <gtdynamics/universal_robot/HelicalJoint.h>
+#include <gtdynamics/universal_robot/PrismaticJoint.h>
+#include <gtdynamics/universal_robot/RevoluteJoint.h>
+#include <gtdynamics/utils/Tracer.h>
+
+#include <iostream>
+#include <string>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+// Declaration needed for serialization of derived classes.
+BOOST_CLASS_EXPORT(gtdynamics::RevoluteJoint)
+BOOST_CLASS_EXPORT(gtdynamics::HelicalJoint)
+BOOST_CLASS_EXPORT(gtdynamics::PrismaticJoint)
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Constrained,
+                        "gtsam_noiseModel_Constrained")
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal,
+                        "gtsam_noiseModel_Diagonal")
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Gaussian,
+                        "gtsam_noiseModel_Gaussian")
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Unit, "gtsam_noiseModel_Unit")
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic,
+                        "gtsam_noiseModel_Isotropic")
+GTSAM_VALUE_EXPORT(double)
+GTSAM_VALUE_EXPORT(gtsam::Vector6)
+GTSAM_VALUE_EXPORT(gtsam::Point3)
+GTSAM_VALUE_EXPORT(gtsam::Pose3)
+#endif
+
+int main(int argc, char** argv) {
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " problem.bin [captured|soft|manifold|penalty|al|all]"
+              << " [trace.json]\n";
+    return 1;
+  }
+  const std::string method = argc > 2 ? argv[2] : "captured";
+  if (argc > 3) Tracer::Instance().enable();
+
+  const ProblemCapture capture = ProblemCapture::Load(argv[1]);
+  const EqConsOptProblem problem = capture.problem();
+  const LevenbergMarquardtParams& lm_params =
+      capture.parameters.lm_parameters;
+  std::cout << "robot: " << capture.robot.numLinks() << " links, "
+            << capture.robot.numJoints() << " joints\n";
+  std::cout << "costs: " << problem.costsDimension()
+            << ", constraints: " << problem.constraintsDimension()
+            << ", variables: " << problem.valuesDimension() << "\n";
+
+  std::ostream& latex_os = std::cout;
+  if (method == "captured" || method == "all") {
+    // Named after the captured method, and always printed first.
+    OptimizeWithParameters(problem, latex_os, capture.parameters);
+  }
+  if (method == "soft" || method == "all") {
+    OptimizeSoftConstraints(problem, latex_os, lm_params);
+  }
+  if (method == "manifold" || method == "all") {
+    OptimizeConstraintManifold(problem, latex_os, DefaultMoptParams(),
+                               lm_params);
+  }
+  if (method == "penalty" || method == "all") {
+    OptimizePenaltyMethod(problem, latex_os,
+                          PenaltyMethodParameters(lm_params));
+  }
+  if (method == "al" || method == "all") {
+    OptimizeAugmentedLagrangian(problem, latex_os,
+                                AugmentedLagrangianParameters(lm_params));
+  }
+
+  if (argc > 3) Tracer::Instance().writeChromeTrace(std::string(argv[3]));
+  return 0;
+#else
+  std::cerr << "gtdynamics_replay requires "
+               "GTDYNAMICS_ENABLE_BOOST_SERIALIZATION.\n";
+  return 1;
+#endif
+}
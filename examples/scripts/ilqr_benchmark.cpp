@@ -0,0 +1,89 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ilqr_benchmark.cpp
+ * @brief iLQR against LM on DynamicsGraph::trajectoryFG, for the A1 legs
+ * swinging from standing to tucked with the trunk held fixed, for growing
+ * horizons, as CSV. iLQR needs a fixed base, hence the fixed trunk.
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/factors/MinTorqueFactor.h>
+#include <gtdynamics/optimizer/ILQROptimizer.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Milliseconds elapsed since start.
+double Elapsed(std::chrono::steady_clock::time_point start) {
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+  const std::string urdf_path =
+      argc > 1 ? argv[1] : kUrdfPath + std::string("a1/a1.urdf");
+  const Robot robot = CreateRobotFromFile(urdf_path, "a1").fixLink("trunk");
+  const DynamicsGraph graph_builder(Vector3(0, 0, -9.8));
+  const double dt = 0.01;
+  auto angle_model = noiseModel::Isotropic::Sigma(1, 1e-3);
+  auto state_model = noiseModel::Isotropic::Sigma(1, 1e-4);
+  auto torque_model = noiseModel::Isotropic::Sigma(1, 10.0);
+
+  std::cout << "solver,num_steps,solve_ms,objective\n";
+  for (int num_steps : {25, 50, 100, 200, 400}) {
+    // Tuck the legs, from standing, with small torques.
+    NonlinearFactorGraph objectives, initial_conditions;
+    Initializer initializer;
+    Values init = initializer.ZeroValuesTrajectory(robot, num_steps);
+    for (auto&& joint : robot.joints()) {
+      const int j = joint->id();
+      double q0 = 0.0, qT = 0.0;
+      if (joint->name().find("upper") != std::string::npos) {
+        q0 = 0.9, qT = 1.5;
+      } else if (joint->name().find("lower") != std::string::npos) {
+        q0 = -1.8, qT = -2.5;
+      }
+      init.update(JointAngleKey(j, 0), q0);
+      initial_conditions.addPrior(JointAngleKey(j, 0), q0, state_model);
+      initial_conditions.addPrior(JointVelKey(j, 0), 0.0, state_model);
+      objectives.addPrior(JointAngleKey(j, num_steps), qT, angle_model);
+      objectives.addPrior(JointVelKey(j, num_steps), 0.0, angle_model);
+      for (int k = 0; k <= num_steps; k++) {
+        objectives.emplace_shared<MinTorqueFactor>(TorqueKey(j, k),
+                                                   torque_model);
+      }
+    }
+
+    auto graph = graph_builder.trajectoryFG(robot, num_steps, dt,
+                                            CollocationScheme::Euler);
+    graph.add(initial_conditions);
+    graph.add(objectives);
+    auto start = std::chrono::steady_clock::now();
+    const Values lm_result =
+        LevenbergMarquardtOptimizer(graph, init).optimize();
+    std::cout << "lm," << num_steps << "," << Elapsed(start) << ","
+              << objectives.error(lm_result) << "\n";
+
+    ILQROptimizer ilqr(robot, graph_builder, num_steps, dt);
+    start = std::chrono::steady_clock::now();
+    const Values ilqr_result = ilqr.optimize(objectives, {}, init);
+    std::cout << "ilqr," << num_steps << "," << Elapsed(start) << ","
+              << objectives.error(ilqr_result) << "\n";
+  }
+  return 0;
+}
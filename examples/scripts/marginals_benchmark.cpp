@@ -0,0 +1,125 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  marginals_benchmark.cpp
+ * @brief Latency of the covariances of the latest link poses and contact
+ * wrenches of an A1 state estimator, for growing horizons, as CSV:
+ * gtsam::Marginals on the whole graph, against BlockMarginals after a batch
+ * solve and on the Bayes tree of iSAM2.
+ */
+
+#include <gtdynamics/factors/JointMeasurementFactor.h>
+#include <gtdynamics/factors/PreintegratedContactFactors.h>
+#include <gtdynamics/optimizer/BlockMarginals.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/nonlinear/Marginals.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <iostream>
+#include <string>
+
+#include "benchmarkTiming.h"
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+int main(int argc, char** argv) {
+  const std::string urdf_path =
+      argc > 1 ? argv[1] : kUrdfPath + std::string("a1/a1.urdf");
+  const Robot robot = CreateRobotFromFile(urdf_path, "a1");
+  const auto trunk = robot.link("trunk");
+  const Point3 contact_in_com(0, 0, -0.07);
+  PointOnLinks contact_points;
+  for (auto&& name : {"FL_lower", "FR_lower", "RL_lower", "RR_lower"}) {
+    contact_points.emplace_back(robot.link(name), contact_in_com);
+  }
+  const double dt = 0.01;
+  auto prior_model = noiseModel::Isotropic::Sigma(6, 1e-3);
+  auto odometry_model = noiseModel::Isotropic::Sigma(6, 1e-2);
+  auto encoder_model = noiseModel::Isotropic::Sigma(6, 1e-3);
+  auto wrench_model = noiseModel::Isotropic::Sigma(6, 1.0);
+
+  // Factors and values of step k: encoders, trunk odometry, preintegrated
+  // foot contacts and force sensors.
+  auto pose = [&](const LinkSharedPtr& link, int k) {
+    return Pose3(Rot3(), Point3(0.01 * k, 0, 0)) * link->bMcom();
+  };
+  auto step = [&](int k, NonlinearFactorGraph* graph, Values* values) {
+    for (auto&& link : robot.links()) {
+      InsertPose(values, link->id(), k, pose(link, k));
+    }
+    for (auto&& joint : robot.joints()) {
+      graph->emplace_shared<JointMeasurementFactor>(encoder_model, joint, 0.0,
+                                                    k);
+    }
+    for (auto&& cp : contact_points) {
+      const Key wrench_key = ContactWrenchKey(cp.link->id(), 0, k);
+      values->insert(wrench_key, Vector6::Zero().eval());
+      graph->addPrior(wrench_key, Vector6::Zero().eval(), wrench_model);
+    }
+    if (k == 0) {
+      graph->addPrior(PoseKey(trunk->id(), 0), pose(trunk, 0), prior_model);
+      return;
+    }
+    graph->emplace_shared<BetweenFactor<Pose3>>(
+        PoseKey(trunk->id(), k - 1), PoseKey(trunk->id(), k),
+        pose(trunk, k - 1).between(pose(trunk, k)), odometry_model);
+    for (auto&& cp : contact_points) {
+      const PreintegratedPointContactMeasurements pcm(
+          pose(trunk, k), pose(cp.link, k), dt, I_3x3 * 1e-2);
+      graph->emplace_shared<PreintegratedPointContactFactor>(
+          PoseKey(trunk->id(), k - 1), PoseKey(cp.link->id(), k - 1),
+          PoseKey(trunk->id(), k), PoseKey(cp.link->id(), k), pcm);
+    }
+  };
+
+  std::cout << "method,num_steps,num_outputs,marginals_ms\n";
+  for (int num_steps : {10, 50, 100, 200, 400}) {
+    NonlinearFactorGraph graph;
+    Values values;
+    ISAM2 isam;
+    for (int k = 0; k <= num_steps; k++) {
+      NonlinearFactorGraph new_factors;
+      Values new_values;
+      step(k, &new_factors, &new_values);
+      graph.add(new_factors);
+      values.insert(new_values);
+
+      // Keep the latest outputs in the root of the Bayes tree.
+      ISAM2UpdateParams params;
+      params.constrainedKeys = FastMap<Key, int>();
+      for (Key key : EstimationOutputKeys(robot, k, contact_points)) {
+        params.constrainedKeys->emplace(key, 1);
+      }
+      isam.update(new_factors, new_values, params);
+    }
+    const KeyVector outputs =
+        EstimationOutputKeys(robot, num_steps, contact_points);
+
+    const double full_ms = TimeMs([&]() {
+      const Marginals marginals(graph, values);
+      for (Key key : outputs) marginals.marginalCovariance(key);
+    });
+    const double batch_ms = TimeMs([&]() {
+      const BlockMarginals block_marginals(graph, values, outputs);
+    });
+    const double isam_ms = TimeMs([&]() {
+      const BlockMarginals block_marginals(isam, outputs);
+    });
+
+    for (auto&& [method, ms] : {std::make_pair("marginals", full_ms),
+                                std::make_pair("block_batch", batch_ms),
+                                std::make_pair("block_isam2", isam_ms)}) {
+      std::cout << method << "," << num_steps << "," << outputs.size() << ","
+                << ms << "\n";
+    }
+  }
+  return 0;
+}
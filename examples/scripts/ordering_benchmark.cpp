@@ -0,0 +1,77 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ordering_benchmark.cpp
+ * @brief Compare COLAMD with the time-structured orderings on trajectory
+ * graphs of growing length, as CSV: time to compute the ordering, time to
+ * eliminate, and size of the resulting Bayes tree.
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "benchmarkTiming.h"
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Time one ordering on a linearized graph and print a CSV row.
+void Benchmark(const std::string& name, size_t num_links, int num_steps,
+               const GaussianFactorGraph& linear,
+               const std::function<Ordering()>& make_ordering) {
+  Ordering ordering;
+  const double ordering_ms = TimeMs([&]() { ordering = make_ordering(); });
+  GaussianBayesTree::shared_ptr bayes_tree;
+  const double eliminate_ms = TimeMs(
+      [&]() { bayes_tree = linear.eliminateMultifrontal(ordering); });
+  std::cout << name << "," << num_links << "," << num_steps << ","
+            << ordering_ms << "," << eliminate_ms << ","
+            << bayes_tree->size() << "\n";
+}
+
+int main(int argc, char** argv) {
+  const size_t num_links = argc > 1 ? std::stoul(argv[1]) : 8;
+  const Robot robot = CreateSerialChain(num_links).fixLink("link0");
+  DynamicsGraph graph_builder(Vector3(0, 0, -9.81));
+  Initializer initializer;
+
+  std::cout << "ordering,num_links,num_steps,ordering_ms,eliminate_ms,"
+               "num_cliques\n";
+  for (int num_steps : {10, 50, 100, 500, 1000}) {
+    auto graph = graph_builder.trajectoryFG(robot, num_steps, 0.01);
+    Values known_values;
+    for (auto&& joint : robot.joints()) {
+      InsertJointAngle(&known_values, joint->id(), 0, 0.0);
+      InsertJointVel(&known_values, joint->id(), 0, 0.0);
+      for (int k = 0; k <= num_steps; k++) {
+        InsertTorque(&known_values, joint->id(), k, 0.1);
+      }
+    }
+    graph.add(graph_builder.trajectoryFDPriors(robot, num_steps, known_values));
+    const Values init = initializer.ZeroValuesTrajectory(robot, num_steps);
+    const auto linear = graph.linearize(init);
+    const KeyVector keys = graph.keyVector();
+
+    Benchmark("colamd", num_links, num_steps, *linear,
+              [&]() { return Ordering::Colamd(*linear); });
+    Benchmark("time", num_links, num_steps, *linear,
+              [&]() { return TimeOrdering(keys); });
+    Benchmark("nested_dissection", num_links, num_steps, *linear,
+              [&]() { return NestedDissectionTimeOrdering(keys); });
+  }
+  return 0;
+}
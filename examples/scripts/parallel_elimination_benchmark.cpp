@@ -0,0 +1,111 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  parallel_elimination_benchmark.cpp
+ * @brief Scaling of multifrontal elimination of a long-horizon trajectory with
+ * the number of threads, for the time and nested dissection orderings, as
+ * CSV. gtsam eliminates independent subtrees of the Bayes tree in parallel
+ * only when built with TBB; otherwise a single thread is reported.
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/config.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/global_control.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Depth of a Bayes tree clique, i.e., its longest path to a leaf.
+size_t Depth(const GaussianBayesTree::sharedClique& clique) {
+  size_t depth = 0;
+  for (auto&& child : clique->children) depth = std::max(depth, Depth(child));
+  return depth + 1;
+}
+
+/// Best wall time in milliseconds of eliminating `linear` over a few runs.
+double EliminateMs(const GaussianFactorGraph& linear, const Ordering& ordering,
+                   GaussianBayesTree::shared_ptr* bayes_tree) {
+  double best_ms = std::numeric_limits<double>::infinity();
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    *bayes_tree = linear.eliminateMultifrontal(ordering);
+    auto end = std::chrono::steady_clock::now();
+    const std::chrono::duration<double, std::milli> elapsed = end - start;
+    best_ms = std::min(best_ms, elapsed.count());
+  }
+  return best_ms;
+}
+
+int main(int argc, char** argv) {
+  const size_t num_links = argc > 1 ? std::stoul(argv[1]) : 8;
+  const int num_steps = argc > 2 ? std::stoi(argv[2]) : 2000;
+  const Robot robot = CreateSerialChain(num_links).fixLink("link0");
+  DynamicsGraph graph_builder(Vector3(0, 0, -9.81));
+  Initializer initializer;
+
+  auto graph = graph_builder.trajectoryFG(robot, num_steps, 0.01);
+  Values known_values;
+  for (auto&& joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), 0, 0.0);
+    InsertJointVel(&known_values, joint->id(), 0, 0.0);
+    for (int k = 0; k <= num_steps; k++) {
+      InsertTorque(&known_values, joint->id(), k, 0.1);
+    }
+  }
+  graph.add(graph_builder.trajectoryFDPriors(robot, num_steps, known_values));
+  const auto linear =
+      graph.linearize(initializer.ZeroValuesTrajectory(robot, num_steps));
+  const KeyVector keys = graph.keyVector();
+
+#ifdef GTSAM_USE_TBB
+  const std::vector<size_t> thread_counts{1, 2, 4, 8, 16, 32};
+#else
+  std::cerr << "gtsam was built without TBB: elimination is sequential.\n";
+  const std::vector<size_t> thread_counts{1};
+#endif
+
+  std::cout << "ordering,num_links,num_steps,num_threads,eliminate_ms,"
+               "speedup,num_cliques,depth\n";
+  const std::vector<std::pair<std::string, Ordering>> orderings{
+      {"time", TimeOrdering(keys)},
+      {"nested_dissection", NestedDissectionTimeOrdering(keys)}};
+  for (auto&& [name, ordering] : orderings) {
+    double sequential_ms = 0.0;
+    for (size_t num_threads : thread_counts) {
+#ifdef GTSAM_USE_TBB
+      tbb::global_control control(
+          tbb::global_control::max_allowed_parallelism, num_threads);
+#endif
+      GaussianBayesTree::shared_ptr bayes_tree;
+      const double eliminate_ms = EliminateMs(*linear, ordering, &bayes_tree);
+      if (num_threads == 1) sequential_ms = eliminate_ms;
+      std::cout << name << "," << num_links << "," << num_steps << ","
+                << num_threads << "," << eliminate_ms << ","
+                << sequential_ms / eliminate_ms << "," << bayes_tree->size()
+                << "," << Depth(bayes_tree->roots().front()) << "\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  pcg_benchmark.cpp
+ * @brief Time and memory of the matrix-free PCG solver against multifrontal
+ * elimination, for trajectories of growing length, as CSV. Memory is counted
+ * as the number of stored scalars: the Bayes tree for the direct solver, the
+ * preconditioner for PCG, which otherwise only keeps the whitened factors.
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Number of scalars stored in the conditionals of a Bayes tree.
+size_t BayesTreeSize(const GaussianBayesTree& bayes_tree) {
+  size_t size = 0;
+  for (auto&& [key, clique] : bayes_tree.nodes()) {
+    // Each clique is indexed by all its frontal keys, count it once.
+    if (clique->conditional()->front() != key) continue;
+    const auto& R = clique->conditional()->R();
+    size += R.rows() * (R.cols() + 1) / 2;
+    size += R.rows() * clique->conditional()->S().cols();
+  }
+  return size;
+}
+
+/// Milliseconds elapsed since start.
+double Elapsed(std::chrono::steady_clock::time_point start) {
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+  const size_t num_links = argc > 1 ? std::stoul(argv[1]) : 8;
+  const Robot robot = CreateSerialChain(num_links).fixLink("link0");
+  DynamicsGraph graph_builder(Vector3(0, 0, -9.81));
+  Initializer initializer;
+
+  std::cout << "solver,num_links,num_steps,solve_ms,stored_scalars,"
+               "iterations,error\n";
+  for (int num_steps : {100, 200, 500, 1000, 2000, 5000}) {
+    auto graph = graph_builder.trajectoryFG(robot, num_steps, 0.01);
+    Values known_values;
+    for (auto&& joint : robot.joints()) {
+      InsertJointAngle(&known_values, joint->id(), 0, 0.0);
+      InsertJointVel(&known_values, joint->id(), 0, 0.0);
+      for (int k = 0; k <= num_steps; k++) {
+        InsertTorque(&known_values, joint->id(), k, 0.1);
+      }
+    }
+    graph.add(graph_builder.trajectoryFDPriors(robot, num_steps, known_values));
+    const auto linear =
+        graph.linearize(initializer.ZeroValuesTrajectory(robot, num_steps));
+    const Ordering ordering = TimeOrdering(graph.keyVector());
+
+    auto start = std::chrono::steady_clock::now();
+    const auto bayes_tree = linear->eliminateMultifrontal(ordering);
+    const VectorValues direct = bayes_tree->optimize();
+    std::cout << "direct," << num_links << "," << num_steps << ","
+              << Elapsed(start) << "," << BayesTreeSize(*bayes_tree) << ",0,"
+              << linear->error(direct) << "\n";
+
+    for (auto preconditioner : {TrajectoryPCGParams::BLOCK_JACOBI,
+                                TrajectoryPCGParams::BLOCK_TRIDIAGONAL}) {
+      TrajectoryPCGParams params;
+      params.preconditioner = preconditioner;
+      start = std::chrono::steady_clock::now();
+      TrajectoryPCGSolver solver(*linear, params);
+      const VectorValues pcg = solver.solve();
+      const double solve_ms = Elapsed(start);
+      std::cout << (preconditioner == TrajectoryPCGParams::BLOCK_JACOBI
+                        ? "pcg_jacobi,"
+                        : "pcg_tridiagonal,")
+                << num_links << "," << num_steps << "," << solve_ms << ","
+                << solver.preconditionerSize() << "," << solver.iterations()
+                << "," << linear->error(pcg) << "\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  robot_scaling_benchmark.cpp
+ * @brief Sweep the size of generated robots (serial chains, binary trees and
+ * legged walkers) and report how forward kinematics, linear forward dynamics,
+ * graph construction and nonlinear optimization scale, as CSV.
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <iostream>
+#include <string>
+
+#include "benchmarkTiming.h"
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Time the pipeline on one robot and print a CSV row.
+void Benchmark(const std::string& family, size_t size, const Robot& robot,
+               const std::string& root_name) {
+  const size_t t = 0;
+  auto root = robot.link(root_name);
+
+  // Rest configuration with the root link at its rest pose.
+  Values known_values;
+  InsertPose(&known_values, root->id(), t, root->bMcom());
+  InsertTwist(&known_values, root->id(), t, Z_6x1);
+  for (auto&& joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), t, 0.0);
+    InsertJointVel(&known_values, joint->id(), t, 0.0);
+  }
+
+  Values fk_results;
+  const double fk_ms = TimeMs(
+      [&]() { fk_results = robot.forwardKinematics(known_values, t, root_name); });
+
+  for (auto&& joint : robot.joints()) {
+    InsertTorque(&fk_results, joint->id(), t, 0.1);
+  }
+  DynamicsGraph graph_builder(Vector3(0, 0, -9.81));
+  const double linear_fd_ms = TimeMs(
+      [&]() { graph_builder.linearSolveFD(robot, t, fk_results); });
+
+  NonlinearFactorGraph graph;
+  const double graph_ms = TimeMs([&]() {
+    graph = graph_builder.dynamicsFactorGraph(robot, t);
+    graph.add(graph_builder.forwardDynamicsPriors(robot, t, fk_results));
+    graph.addPrior(PoseKey(root->id(), t), root->bMcom(),
+                   graph_builder.opt().bp_cost_model);
+    graph.addPrior<Vector6>(TwistKey(root->id(), t), Z_6x1,
+                            graph_builder.opt().bv_cost_model);
+  });
+
+  Initializer initializer;
+  Values init = initializer.ZeroValues(robot, t);
+  size_t num_iterations = 0;
+  const double opt_ms = TimeMs([&]() {
+    LevenbergMarquardtOptimizer optimizer(graph, init);
+    optimizer.optimize();
+    num_iterations = optimizer.iterations();
+  });
+
+  std::cout << family << "," << size << "," << robot.numJoints() << ","
+            << graph.size() << "," << fk_ms << "," << linear_fd_ms << ","
+            << graph_ms << "," << opt_ms << "," << num_iterations << "\n";
+}
+
+int main(int argc, char** argv) {
+  std::cout << "family,size,dofs,num_factors,fk_ms,linear_fd_ms,graph_ms,"
+               "opt_ms,opt_iterations\n";
+  for (size_t n : {4, 8, 16, 32, 64, 128}) {
+    Benchmark("chain", n, CreateSerialChain(n), "link0");
+  }
+  for (size_t depth : {1, 2, 3, 4, 5, 6}) {
+    Benchmark("tree", depth, CreateBinaryTree(depth), "link0");
+  }
+  for (size_t num_legs : {2, 4, 6, 8, 12, 16}) {
+    Benchmark("walker", num_legs, CreateLeggedRobot(num_legs), "body");
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  subt_loading_benchmark.cpp
+ * @brief Benchmark parsing and validating the SubT model library, serially and
+ * in parallel.
+ *
+ * Usage: subt_loading_benchmark [model_dir] [num_threads]
+ */
+
+#include <gtdynamics/config.h>
+#include <gtdynamics/universal_robot/BatchLoader.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace gtdynamics;
+
+int main(int argc, char** argv) {
+  const std::string model_dir = argc > 1 ? argv[1] : kSubtPath;
+  const size_t num_threads = argc > 2 ? std::stoul(argv[2]) : 0;
+
+  std::vector<std::string> files;
+  for (auto&& entry : std::filesystem::directory_iterator(model_dir)) {
+    const std::string extension = entry.path().extension().string();
+    if (extension == ".sdf" || extension == ".urdf") {
+      files.push_back(entry.path().string());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  ModelLoadSummary serial = LoadRobotsFromFiles(files, 1);
+  serial.print(std::cout);
+
+  ModelLoadSummary parallel = LoadRobotsFromFiles(files, num_threads);
+  std::cout << "\n"
+            << files.size() << " files, serial: " << serial.total_time_ms
+            << " ms, parallel: " << parallel.total_time_ms
+            << " ms, speedup: "
+            << serial.total_time_ms / parallel.total_time_ms << "x\n";
+  return parallel.numFailed() == 0 ? 0 : 1;
+}
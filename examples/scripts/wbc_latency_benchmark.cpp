@@ -0,0 +1,105 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  wbc_latency_benchmark.cpp
+ * @brief Latency of the whole-body QP controller on the A1 standing task.
+ */
+
+#include <gtdynamics/dynamics/WholeBodyController.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/values.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+int main(int argc, char** argv) {
+  const std::string urdf_path =
+      argc > 1 ? argv[1] : kUrdfPath + std::string("a1/a1.urdf");
+  const size_t num_ticks = argc > 2 ? std::stoul(argv[2]) : 10000;
+
+  Robot robot = CreateRobotFromFile(urdf_path, "a1");
+  auto trunk = robot.link("trunk");
+
+  PointOnLinks feet;
+  for (auto&& leg : {"FR", "FL", "RR", "RL"}) {
+    feet.emplace_back(robot.link(std::string(leg) + "_lower"),
+                      Point3(0, 0, -0.07));
+  }
+
+  // Standing states, with the trunk swaying slightly, precomputed so only the
+  // controller is timed.
+  const size_t num_states = 100;
+  std::vector<Values> states;
+  for (size_t s = 0; s < num_states; s++) {
+    const double phase = 2 * M_PI * s / num_states;
+    Values values;
+    InsertPose(&values, trunk->id(), Pose3(Rot3(), Point3(0, 0, 0.3)));
+    InsertTwist(&values, trunk->id(),
+                (Vector6() << 0, 0, 0.1 * std::sin(phase), 0.05 * std::cos(phase),
+                 0, 0)
+                    .finished());
+    for (auto&& joint : robot.joints()) {
+      double q = 0.0;
+      if (joint->name().find("upper") != std::string::npos) q = 0.9;
+      if (joint->name().find("lower") != std::string::npos) q = -1.8;
+      InsertJointAngle(&values, joint->id(), q);
+      InsertJointVel(&values, joint->id(), 0.0);
+    }
+    states.push_back(robot.forwardKinematics(values, 0, std::string("trunk")));
+  }
+
+  WholeBodyController controller(robot, feet);
+  for (auto&& joint : robot.joints()) {
+    controller.setJointAccelTask(joint->name(), 0.0, 1.0);
+  }
+
+  std::vector<double> latencies_us;
+  latencies_us.reserve(num_ticks);
+  size_t total_iterations = 0;
+  for (size_t tick = 0; tick < num_ticks; tick++) {
+    const Values& state = states[tick % num_states];
+    // Damp the trunk twist.
+    controller.setLinkAccelTask("trunk", -10.0 * Twist(state, trunk->id()),
+                                1e-2);
+    auto start = std::chrono::steady_clock::now();
+    controller.compute(state);
+    auto end = std::chrono::steady_clock::now();
+    latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+    total_iterations += controller.iterations();
+  }
+
+  const double cold_us = latencies_us.front();
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&](double p) {
+    return latencies_us[std::min(latencies_us.size() - 1,
+                                 size_t(p * latencies_us.size()))];
+  };
+  const double mean_us =
+      std::accumulate(latencies_us.begin(), latencies_us.end(), 0.0) /
+      latencies_us.size();
+
+  std::cout << "ticks: " << num_ticks << std::endl;
+  std::cout << "cold start [us]: " << cold_us << std::endl;
+  std::cout << "mean [us]: " << mean_us << std::endl;
+  std::cout << "p50 [us]: " << percentile(0.5) << std::endl;
+  std::cout << "p99 [us]: " << percentile(0.99) << std::endl;
+  std::cout << "max [us]: " << latencies_us.back() << std::endl;
+  std::cout << "mean active set iterations: "
+            << double(total_iterations) / num_ticks << std::endl;
+  std::cout << "active constraints: " << controller.numActive() << std::endl;
+  return 0;
+}
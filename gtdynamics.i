@@ -263,6 +263,8 @@ class Robot {
 
   int numJoints() const;
 
+  gtdynamics::Link* treeRoot() const;
+
   void print(const string &s = "") const;
 
   gtsam::Values forwardKinematics(
@@ -275,6 +277,20 @@ class Robot {
       const gtsam::Values &known_values, size_t t,
       const std::optional<string> &prior_link_name) const;
 
+  gtsam::Matrix jacobian(const string &link_name,
+                         const gtsam::Values &known_values) const;
+
+  gtsam::Matrix jacobian(const string &link_name,
+                         const gtsam::Values &known_values, size_t t,
+                         const std::optional<string> &prior_link_name) const;
+
+  gtsam::Matrix jacobianDot(const string &link_name,
+                            const gtsam::Values &known_values) const;
+
+  gtsam::Matrix jacobianDot(
+      const string &link_name, const gtsam::Values &known_values, size_t t,
+      const std::optional<string> &prior_link_name) const;
+
   // enabling serialization functionality
   void serialize() const;
 };
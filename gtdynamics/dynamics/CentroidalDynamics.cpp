@@ -0,0 +1,176 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  CentroidalDynamics.cpp
+ * @brief Reduced centroidal dynamics model and factor graph builder.
+ */
+
+#include <gtdynamics/dynamics/CentroidalDynamics.h>
+#include <gtdynamics/factors/CentroidalFactors.h>
+#include <gtdynamics/utils/Tracer.h>
+#include <gtsam/nonlinear/ExpressionFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/expressions.h>
+
+#include <algorithm>
+
+namespace gtdynamics {
+
+using gtsam::Matrix3;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Point3;
+using gtsam::Pose3;
+using gtsam::Values;
+using gtsam::Vector3;
+using gtsam::noiseModel::Isotropic;
+
+/* ************************************************************************* */
+CentroidalModel CentroidalModel::FromRobot(const Robot &robot,
+                                           const std::string &base_name) {
+  CentroidalModel model;
+  Point3 com = Point3::Zero();
+  for (auto &&link : robot.links()) {
+    model.mass += link->mass();
+    com += link->mass() * link->bMcom().translation();
+  }
+  if (model.mass <= 0) {
+    throw std::runtime_error("CentroidalModel: robot has no mass.");
+  }
+  com /= model.mass;
+
+  // Locked inertia about the CoM, in the rest frame, by parallel axis theorem.
+  Matrix3 inertia = gtsam::Z_3x3;
+  for (auto &&link : robot.links()) {
+    const gtsam::Rot3 R = link->bMcom().rotation();
+    const Vector3 r = link->bMcom().translation() - com;
+    inertia += R.matrix() * link->inertia() * R.matrix().transpose() +
+               link->mass() *
+                   (r.squaredNorm() * gtsam::I_3x3 - r * r.transpose());
+  }
+
+  const Pose3 bMbase = robot.link(base_name)->bMcom();
+  model.bMc = Pose3(bMbase.rotation(), com);
+  const Matrix3 cRb = model.bMc.rotation().matrix().transpose();
+  model.inertia = cRb * inertia * cRb.transpose();
+  model.cMbase = model.bMc.between(bMbase);
+  return model;
+}
+
+/* ************************************************************************* */
+Point3 CentroidalModel::nominalContactPoint(const PointOnLink &cp) const {
+  return bMc.transformTo(cp.link->bMcom().transformFrom(cp.point));
+}
+
+/* ************************************************************************* */
+NonlinearFactorGraph CentroidalGraph::intervalFactors(
+    int k, const PointOnLinks &contact_points) const {
+  NonlinearFactorGraph graph;
+  auto dynamics_model = Isotropic::Sigma(6, params_.sigma_dynamics);
+
+  gtsam::KeyVector point_keys, force_keys;
+  for (auto &&cp : contact_points) {
+    point_keys.push_back(ContactPointKey(cp.link->id(), k));
+    force_keys.push_back(ContactForceKey(cp.link->id(), k));
+  }
+  graph.emplace_shared<CentroidalMomentumFactor>(
+      CentroidalMomentumKey(k), CentroidalMomentumKey(k + 1),
+      CentroidalPoseKey(k), point_keys, force_keys, dynamics_model,
+      model_.mass, params_.gravity, params_.dt);
+  graph.emplace_shared<CentroidalKinematicsFactor>(
+      CentroidalPoseKey(k), CentroidalPoseKey(k + 1), CentroidalMomentumKey(k),
+      dynamics_model, model_.mass, model_.inertia, params_.dt);
+
+  const gtsam::Point3_ up(Point3(-params_.gravity.normalized()));
+  const gtsam::Pose3_ wTc(CentroidalPoseKey(k));
+  for (size_t c = 0; c < contact_points.size(); c++) {
+    const gtsam::Point3_ wPc(point_keys[c]);
+    graph.emplace_shared<ForceFrictionConeFactor>(
+        force_keys[c], Isotropic::Sigma(2, params_.sigma_friction),
+        params_.mu, params_.gravity);
+    graph.emplace_shared<gtsam::PriorFactor<Vector3>>(
+        force_keys[c], gtsam::Z_3x1, Isotropic::Sigma(3, params_.sigma_force));
+    graph.emplace_shared<gtsam::ExpressionFactor<double>>(
+        Isotropic::Sigma(1, params_.sigma_contact), params_.ground_height,
+        gtsam::dot(wPc, up));
+    graph.emplace_shared<gtsam::ExpressionFactor<Point3>>(
+        Isotropic::Sigma(3, params_.sigma_reach),
+        model_.nominalContactPoint(contact_points[c]),
+        gtsam::transformTo(wTc, wPc));
+  }
+  return graph;
+}
+
+/* ************************************************************************* */
+NonlinearFactorGraph CentroidalGraph::noSlipFactors(
+    int k, const PointOnLinks &contacts_k,
+    const PointOnLinks &contacts_k1) const {
+  NonlinearFactorGraph graph;
+  auto contact_model = Isotropic::Sigma(3, params_.sigma_contact);
+  for (auto &&cp : contacts_k) {
+    if (std::find(contacts_k1.begin(), contacts_k1.end(), cp) !=
+        contacts_k1.end()) {
+      graph.emplace_shared<gtsam::BetweenFactor<Point3>>(
+          ContactPointKey(cp.link->id(), k),
+          ContactPointKey(cp.link->id(), k + 1), Point3::Zero(),
+          contact_model);
+    }
+  }
+  return graph;
+}
+
+/* ************************************************************************* */
+std::vector<PointOnLinks> CentroidalGraph::StepContactPoints(
+    const Trajectory &trajectory) {
+  const std::vector<PointOnLinks> phase_contact_points =
+      trajectory.phaseContactPoints();
+  const std::vector<int> phase_durations = trajectory.phaseDurations();
+  std::vector<PointOnLinks> step_contact_points;
+  for (size_t p = 0; p < phase_durations.size(); p++) {
+    step_contact_points.insert(step_contact_points.end(), phase_durations[p],
+                               phase_contact_points[p]);
+  }
+  return step_contact_points;
+}
+
+/* ************************************************************************* */
+NonlinearFactorGraph CentroidalGraph::trajectoryFG(
+    const Trajectory &trajectory) const {
+  TraceScope trace("centroidalTrajectoryFG");
+  const std::vector<PointOnLinks> contacts = StepContactPoints(trajectory);
+  NonlinearFactorGraph graph;
+  for (size_t k = 0; k < contacts.size(); k++) {
+    graph.add(intervalFactors(k, contacts[k]));
+    if (k + 1 < contacts.size()) {
+      graph.add(noSlipFactors(k, contacts[k], contacts[k + 1]));
+    }
+  }
+  return graph;
+}
+
+/* ************************************************************************* */
+Values CentroidalGraph::initialValues(const Trajectory &trajectory,
+                                      const Pose3 &wTc) const {
+  const std::vector<PointOnLinks> contacts = StepContactPoints(trajectory);
+  Values values;
+  for (size_t k = 0; k <= contacts.size(); k++) {
+    values.insert(CentroidalPoseKey(k), wTc);
+    values.insert(CentroidalMomentumKey(k), gtsam::Vector6(gtsam::Z_6x1));
+    if (k == contacts.size()) break;
+    const double num_contacts = contacts[k].size();
+    for (auto &&cp : contacts[k]) {
+      values.insert(ContactPointKey(cp.link->id(), k),
+                    wTc.transformFrom(model_.nominalContactPoint(cp)));
+      values.insert<Vector3>(ContactForceKey(cp.link->id(), k),
+                             -model_.mass * params_.gravity / num_contacts);
+    }
+  }
+  return values;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,150 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  CentroidalDynamics.h
+ * @brief Reduced centroidal dynamics model and factor graph builder, for fast
+ * locomotion MPC.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/PointOnLink.h>
+#include <gtdynamics/utils/Trajectory.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Shorthand for Gp_k, for the centroidal pose (base orientation, CoM) at k.
+inline gtsam::Key CentroidalPoseKey(int k) {
+  return DynamicsSymbol::SimpleSymbol("Gp", k);
+}
+
+/// Shorthand for Gh_k, for the centroidal momentum [angular; linear] at k.
+inline gtsam::Key CentroidalMomentumKey(int k) {
+  return DynamicsSymbol::SimpleSymbol("Gh", k);
+}
+
+/// Shorthand for f_i_k, for the world contact force on the i-th link at k.
+inline gtsam::Key ContactForceKey(int i, int k = 0) {
+  return DynamicsSymbol::LinkSymbol("f", i, k);
+}
+
+/// Shorthand for cp_i_k, for the world contact point of the i-th link at k.
+inline gtsam::Key ContactPointKey(int i, int k = 0) {
+  return DynamicsSymbol::LinkSymbol("cp", i, k);
+}
+
+/**
+ * Centroidal model of a robot: the whole robot is lumped into one rigid body
+ * with the total mass and the locked inertia of the rest configuration. The
+ * centroidal frame is located at the CoM with the orientation of the base link.
+ */
+struct CentroidalModel {
+  double mass = 0;
+  gtsam::Matrix3 inertia;  // locked inertia about CoM, centroidal frame
+  gtsam::Pose3 cMbase;     // base link CoM pose in the centroidal frame
+  gtsam::Pose3 bMc;        // centroidal frame in the robot's rest frame
+
+  /**
+   * @fn Compute the centroidal model of a robot in its rest configuration.
+   * @param robot the robot.
+   * @param base_name name of the base link.
+   */
+  static CentroidalModel FromRobot(const Robot &robot,
+                                   const std::string &base_name);
+
+  /// Rest position of a contact point in the centroidal frame.
+  gtsam::Point3 nominalContactPoint(const PointOnLink &cp) const;
+};
+
+/// Noise models and physical parameters of the centroidal graph.
+struct CentroidalGraphParams {
+  gtsam::Vector3 gravity = gtsam::Vector3(0, 0, -9.81);
+  double mu = 1.0;                  // friction coefficient
+  double dt = 0.02;                 // duration of one time step
+  double ground_height = 0.0;       // height of the flat ground
+  double sigma_dynamics = 1e-3;     // momentum and kinematics collocation
+  double sigma_contact = 1e-3;      // contact height and no-slip
+  double sigma_friction = 1e-2;     // friction cone
+  double sigma_reach = 0.1;         // foot distance from its rest position
+  double sigma_force = 1e2;         // regularizes contact forces
+
+  CentroidalGraphParams() {}
+};
+
+/**
+ * CentroidalGraph builds factor graphs of the centroidal dynamics along a
+ * Trajectory's contact schedule. At step k, the variables are the centroidal
+ * pose and momentum, and for every contact point active on the interval
+ * [k, k+1], its world position and force. Contact points do not slip while
+ * they stay active, and may move freely while in swing.
+ */
+class CentroidalGraph {
+ private:
+  CentroidalModel model_;
+  CentroidalGraphParams params_;
+
+ public:
+  /**
+   * Constructor.
+   * @param model centroidal model of the robot.
+   * @param params parameters.
+   */
+  CentroidalGraph(const CentroidalModel &model,
+                  const CentroidalGraphParams &params = CentroidalGraphParams())
+      : model_(model), params_(params) {}
+
+  /// Return the centroidal model.
+  const CentroidalModel &model() const { return model_; }
+
+  /// Return the parameters.
+  const CentroidalGraphParams &params() const { return params_; }
+
+  /**
+   * Factors on the interval [k, k+1]: momentum and pose collocation, and
+   * friction cone, ground contact and reachability of the contact points.
+   * @param k time step.
+   * @param contact_points contact points active on the interval.
+   */
+  gtsam::NonlinearFactorGraph intervalFactors(
+      int k, const PointOnLinks &contact_points) const;
+
+  /**
+   * Contact points that do not slip between k and k+1.
+   * @param k time step.
+   * @param contacts_k contact points active on [k, k+1].
+   * @param contacts_k1 contact points active on [k+1, k+2].
+   */
+  gtsam::NonlinearFactorGraph noSlipFactors(
+      int k, const PointOnLinks &contacts_k,
+      const PointOnLinks &contacts_k1) const;
+
+  /// Contact points active on [k, k+1] for each step of the trajectory.
+  static std::vector<PointOnLinks> StepContactPoints(
+      const Trajectory &trajectory);
+
+  /// Factor graph of the centroidal dynamics along the whole trajectory.
+  gtsam::NonlinearFactorGraph trajectoryFG(const Trajectory &trajectory) const;
+
+  /**
+   * Initial values for standing still at the given centroidal pose, with the
+   * weight shared evenly between the active contacts.
+   * @param trajectory the trajectory.
+   * @param wTc the centroidal pose.
+   */
+  gtsam::Values initialValues(const Trajectory &trajectory,
+                              const gtsam::Pose3 &wTc) const;
+};
+
+}  // namespace gtdynamics
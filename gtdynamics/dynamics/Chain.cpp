@@ -46,7 +46,7 @@ Chain Chain::compose(std::vector<Chain> &chains) {
 }
 
 Pose3 Chain::poe(const Vector &q, std::optional<Pose3> fTe,
-                 gtsam::OptionalJacobian<-1, -1> J) {
+                 gtsam::OptionalJacobian<-1, -1> J) const {
   // Check that input has good size
   if (q.size() != length()) {
     throw std::runtime_error(
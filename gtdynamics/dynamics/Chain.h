@@ -96,7 +96,7 @@ class Chain {
    * Exponentials
    */
   Pose3 poe(const Vector &q, std::optional<Pose3> fTe = {},
-            gtsam::OptionalJacobian<-1, -1> J = {});
+            gtsam::OptionalJacobian<-1, -1> J = {}) const;
 
   /**
    * This function implements the dynamic dependency between the
@@ -136,11 +136,11 @@ class Chain {
 
 // Helper function to create expression with a vector, used in
 // ChainConstraint3.
-gtsam::Vector3 MakeVector3(const double &value0, const double &value1,
-                           const double &value2,
-                           gtsam::OptionalJacobian<3, 1> J0 = {},
-                           gtsam::OptionalJacobian<3, 1> J1 = {},
-                           gtsam::OptionalJacobian<3, 1> J2 = {}) {
+inline gtsam::Vector3 MakeVector3(const double &value0, const double &value1,
+                                  const double &value2,
+                                  gtsam::OptionalJacobian<3, 1> J0 = {},
+                                  gtsam::OptionalJacobian<3, 1> J1 = {},
+                                  gtsam::OptionalJacobian<3, 1> J2 = {}) {
   gtsam::Vector3 q;
   q << value0, value1, value2;
   if (J0) {
@@ -12,13 +12,17 @@
  */
 
 #include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/dynamics/EliminatedWrenches.h>
+#include <gtdynamics/dynamics/LegChains.h>
 #include <gtdynamics/factors/ContactDynamicsFrictionConeFactor.h>
 #include <gtdynamics/factors/ContactDynamicsMomentFactor.h>
 #include <gtdynamics/factors/ContactHeightFactor.h>
 #include <gtdynamics/factors/ContactKinematicsAccelFactor.h>
 #include <gtdynamics/factors/ContactKinematicsTwistFactor.h>
+#include <gtdynamics/factors/WrenchPlanarFactor.h>
 #include <gtdynamics/universal_robot/Joint.h>
 #include <gtdynamics/utils/JsonSaver.h>
+#include <gtdynamics/utils/Tracer.h>
 #include <gtdynamics/utils/utils.h>
 #include <gtdynamics/utils/values.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
@@ -50,7 +54,8 @@ using gtsam::Z_6x1;
 namespace gtdynamics {
 
 GaussianFactorGraph DynamicsGraph::linearDynamicsGraph(
-    const Robot &robot, const int t, const gtsam::Values &known_values) {
+    const Robot &robot, const int t, const gtsam::Values &known_values,
+    const std::optional<PointOnLinks> &contact_points) const {
   GaussianFactorGraph graph;
   auto all_constrained = gtsam::noiseModel::Constrained::All(6);
   for (auto &&link : robot.links()) {
@@ -63,7 +68,6 @@ GaussianFactorGraph DynamicsGraph::linearDynamicsGraph(
       // wrench factor
       // G_i * A_i - F_i_j1 - .. - F_i_jn  = ad(V_i)^T * G_i * V*i + m_i * R_i^T
       // * g
-      const auto &connected_joints = link->joints();
       const gtsam::Matrix6 G_i = link->inertiaMatrix();
       const double m_i = link->mass();
       const Pose3 T_wi = Pose(known_values, i, t);
@@ -76,21 +80,31 @@ GaussianFactorGraph DynamicsGraph::linearDynamicsGraph(
         rhs[i] += gravitational_force[i - 3];
       }
 
-      auto accel_key = TwistAccelKey(i, t);
-      if (connected_joints.size() == 0) {
-        graph.add(accel_key, G_i, rhs, all_constrained);
-      } else if (connected_joints.size() == 1) {
-        graph.add(accel_key, G_i, WrenchKey(i, connected_joints[0]->id(), t),
-                  -I_6x6, rhs, all_constrained);
-      } else if (connected_joints.size() == 2) {
-        graph.add(accel_key, G_i, WrenchKey(i, connected_joints[0]->id(), t),
-                  -I_6x6, WrenchKey(i, connected_joints[1]->id(), t), -I_6x6,
-                  rhs, all_constrained);
+      std::vector<std::pair<gtsam::Key, gtsam::Matrix>> terms;
+      terms.emplace_back(TwistAccelKey(i, t), G_i);
+      for (auto &&joint : link->joints()) {
+        terms.emplace_back(WrenchKey(i, joint->id(), t), -I_6x6);
+      }
+
+      // Contact wrenches, with zero moment at the contact point.
+      if (contact_points) {
+        for (auto &&cp : *contact_points) {
+          if (cp.link->id() != i) continue;
+          auto wrench_key = ContactWrenchKey(i, 0, t);
+          terms.emplace_back(wrench_key, -I_6x6);
+          const Pose3 cTcom(gtsam::Rot3(), -cp.point);
+          gtsam::Matrix36 H_moment = gtsam::Matrix36::Zero();
+          H_moment.leftCols<3>().setIdentity();
+          graph.add(wrench_key,
+                    H_moment * cTcom.inverse().AdjointMap().transpose(),
+                    gtsam::Vector3::Zero(),
+                    gtsam::noiseModel::Constrained::All(3));
+        }
       }
+      graph.add(terms, rhs, all_constrained);
     }
   }
 
-  OptimizerSetting opt_;
   for (auto &&joint : robot.joints()) {
     graph.push_back(joint->linearAFactors(t, known_values, opt_, planar_axis_));
     graph.push_back(
@@ -201,15 +215,30 @@ gtsam::NonlinearFactorGraph DynamicsGraph::qFactors(
                      opt_.bp_cost_model);
 
   // TODO(frank): call Kinematics::graph<Slice> instead
-  for (auto &&joint : robot.joints()) {
-    graph.add(PoseFactor(
-        PoseKey(joint->parent()->id(), k), PoseKey(joint->child()->id(), k),
-        JointAngleKey(joint->id(), k), opt_.p_cost_model, joint));
+  if (opt_.dynamics_formulation == OptimizerSetting::ReduceLegChains) {
+    const LegChains chains(robot);
+    for (auto &&leg : chains.legs()) {
+      graph.emplace_shared<ExpressionFactor<Vector6>>(
+          opt_.p_cost_model, Z_6x1,
+          gtsam::logmap(gtsam::Pose3_(PoseKey(leg.foot->id(), k)),
+                        chains.footPose(leg, k)));
+    }
+  } else {
+    for (auto &&joint : robot.joints()) {
+      graph.add(PoseFactor(
+          PoseKey(joint->parent()->id(), k), PoseKey(joint->child()->id(), k),
+          JointAngleKey(joint->id(), k), opt_.p_cost_model, joint));
+    }
   }
 
   // Add contact factors.
   if (contact_points) {
     for (auto &&cp : *contact_points) {
+      if (terrain_) {
+        graph.emplace_shared<ContactHeightFactor>(
+            PoseKey(cp.link->id(), k), opt_.cp_cost_model, cp.point, terrain_);
+        continue;
+      }
       ContactHeightFactor contact_pose_factor(
           PoseKey(cp.link->id(), k), opt_.cp_cost_model, cp.point, gravity_);
       graph.add(contact_pose_factor);
@@ -228,8 +257,18 @@ gtsam::NonlinearFactorGraph DynamicsGraph::vFactors(
       graph.addPrior<gtsam::Vector6>(TwistKey(link->id(), t), gtsam::Z_6x1,
                                      opt_.bv_cost_model);
 
-  for (auto &&joint : robot.joints())
-    graph.add(TwistFactor(opt_.v_cost_model, joint, t));
+  if (opt_.dynamics_formulation == OptimizerSetting::ReduceLegChains) {
+    const LegChains chains(robot);
+    for (auto &&leg : chains.legs()) {
+      graph.emplace_shared<ExpressionFactor<Vector6>>(
+          opt_.v_cost_model, Z_6x1,
+          chains.footTwist(leg, t) -
+              gtsam::Vector6_(TwistKey(leg.foot->id(), t)));
+    }
+  } else {
+    for (auto &&joint : robot.joints())
+      graph.add(TwistFactor(opt_.v_cost_model, joint, t));
+  }
 
   // Add contact factors.
   if (contact_points) {
@@ -252,8 +291,18 @@ gtsam::NonlinearFactorGraph DynamicsGraph::aFactors(
     if (link->isFixed())
       graph.addPrior<gtsam::Vector6>(TwistAccelKey(link->id(), t), gtsam::Z_6x1,
                                      opt_.ba_cost_model);
-  for (auto &&joint : robot.joints())
-    graph.add(TwistAccelFactor(opt_.a_cost_model, joint, t));
+  if (opt_.dynamics_formulation == OptimizerSetting::ReduceLegChains) {
+    const LegChains chains(robot);
+    for (auto &&leg : chains.legs()) {
+      graph.emplace_shared<ExpressionFactor<Vector6>>(
+          opt_.a_cost_model, Z_6x1,
+          chains.footTwistAccel(leg, t) -
+              gtsam::Vector6_(TwistAccelKey(leg.foot->id(), t)));
+    }
+  } else {
+    for (auto &&joint : robot.joints())
+      graph.add(TwistAccelFactor(opt_.a_cost_model, joint, t));
+  }
 
   // Add contact factors.
   if (contact_points) {
@@ -274,6 +323,8 @@ gtsam::NonlinearFactorGraph DynamicsGraph::dynamicsFactors(
     const std::optional<PointOnLinks> &contact_points,
     const std::optional<double> &mu) const {
   NonlinearFactorGraph graph;
+  const bool wrench_variables =
+      opt_.dynamics_formulation == OptimizerSetting::WrenchVariables;
 
   double mu_;  // Static friction coefficient.
   if (mu)
@@ -300,9 +351,15 @@ gtsam::NonlinearFactorGraph DynamicsGraph::dynamicsFactors(
           wrench_keys.push_back(wrench_key);
 
           // Add contact dynamics constraints.
-          graph.emplace_shared<ContactDynamicsFrictionConeFactor>(
-              PoseKey(i, k), wrench_key, opt_.cfriction_cost_model, mu_,
-              gravity_);
+          if (terrain_) {
+            graph.emplace_shared<ContactDynamicsFrictionConeFactor>(
+                PoseKey(i, k), wrench_key, opt_.cfriction_cost_model, mu_,
+                terrain_, cp.point);
+          } else {
+            graph.emplace_shared<ContactDynamicsFrictionConeFactor>(
+                PoseKey(i, k), wrench_key, opt_.cfriction_cost_model, mu_,
+                gravity_);
+          }
 
           graph.emplace_shared<ContactDynamicsMomentFactor>(
               wrench_key, opt_.cm_cost_model,
@@ -311,11 +368,22 @@ gtsam::NonlinearFactorGraph DynamicsGraph::dynamicsFactors(
       }
 
       // add wrench factor for link
-      graph.add(
-          WrenchFactor(opt_.fa_cost_model, link, wrench_keys, k, gravity_));
+      if (wrench_variables) {
+        graph.add(
+            WrenchFactor(opt_.fa_cost_model, link, wrench_keys, k, gravity_));
+      }
     }
   }
 
+  if (opt_.dynamics_formulation == OptimizerSetting::EliminateWrenches) {
+    graph.add(eliminatedWrenchFactors(robot, k, contact_points));
+    return graph;
+  }
+  if (opt_.dynamics_formulation == OptimizerSetting::ReduceLegChains) {
+    graph.add(legChainFactors(robot, k, contact_points));
+    return graph;
+  }
+
   // TODO(frank): use Statics<Slice> calls
   // TODO(frank): sort out const shared ptr mess
   for (auto &&joint : robot.joints()) {
@@ -331,6 +399,70 @@ gtsam::NonlinearFactorGraph DynamicsGraph::dynamicsFactors(
   return graph;
 }
 
+gtsam::NonlinearFactorGraph DynamicsGraph::eliminatedWrenchFactors(
+    const Robot &robot, const int k,
+    const std::optional<PointOnLinks> &contact_points) const {
+  NonlinearFactorGraph graph;
+  const EliminatedWrenches eliminated(robot, gravity_, contact_points);
+  const auto wrenches = eliminated.childWrenches(k);
+  for (auto &&joint : robot.joints()) {
+    // Torque factor, on the eliminated wrench of the child link.
+    const gtsam::Vector6_ &wrench = wrenches.at(joint->id());
+    const Double_ torque_hat(
+        std::bind(&Joint::transformWrenchToTorque, joint, joint->child(),
+                  std::placeholders::_1, std::placeholders::_2),
+        wrench);
+    const Double_ torque(TorqueKey(joint->id(), k));
+    graph.emplace_shared<ExpressionFactor<double>>(opt_.t_cost_model, 0.0,
+                                                   torque_hat - torque);
+    if (planar_axis_) {
+      graph.emplace_shared<ExpressionFactor<gtsam::Vector3>>(
+          opt_.planar_cost_model, gtsam::Vector3::Zero(),
+          WrenchPlanarConstraint(*planar_axis_, wrench));
+    }
+  }
+
+  // Without a fixed root, the wrench balance of the whole tree remains.
+  if (!eliminated.root()->isFixed()) {
+    graph.emplace_shared<ExpressionFactor<Vector6>>(
+        opt_.fa_cost_model, Z_6x1, eliminated.rootWrenchBalance(k));
+  }
+  return graph;
+}
+
+gtsam::NonlinearFactorGraph DynamicsGraph::legChainFactors(
+    const Robot &robot, const int k,
+    const std::optional<PointOnLinks> &contact_points) const {
+  NonlinearFactorGraph graph;
+  const LegChains chains(robot, gravity_, contact_points);
+  for (auto &&leg : chains.legs()) {
+    const std::vector<gtsam::Vector6_> wrenches = chains.childWrenches(leg, k);
+    for (size_t i = 0; i < leg.joints.size(); i++) {
+      // Torque factor, on the wrench balancing the links below the joint.
+      const JointSharedPtr &joint = leg.joints[i];
+      const Double_ torque_hat(
+          std::bind(&Joint::transformWrenchToTorque, joint, joint->child(),
+                    std::placeholders::_1, std::placeholders::_2),
+          wrenches[i]);
+      const Double_ torque(TorqueKey(joint->id(), k));
+      graph.emplace_shared<ExpressionFactor<double>>(opt_.t_cost_model, 0.0,
+                                                     torque_hat - torque);
+      if (planar_axis_) {
+        graph.emplace_shared<ExpressionFactor<gtsam::Vector3>>(
+            opt_.planar_cost_model, gtsam::Vector3::Zero(),
+            WrenchPlanarConstraint(*planar_axis_, wrenches[i]));
+      }
+    }
+  }
+
+  // The legs pass their wrenches to the trunk through the first joints.
+  if (!chains.trunk()->isFixed()) {
+    graph.emplace_shared<ExpressionFactor<Vector6>>(
+        opt_.fa_cost_model, Z_6x1, chains.trunkWrenchBalance(k));
+  }
+  return graph;
+}
+
 gtsam::NonlinearFactorGraph DynamicsGraph::dynamicsFactorGraph(
     const Robot &robot, const int t,
     const std::optional<PointOnLinks> &contact_points,
@@ -348,12 +480,17 @@ gtsam::NonlinearFactorGraph DynamicsGraph::trajectoryFG(
     const CollocationScheme collocation,
     const std::optional<PointOnLinks> &contact_points,
     const std::optional<double> &mu) const {
+  TraceScope trace("trajectoryFG");
   NonlinearFactorGraph graph;
   for (int t = 0; t < num_steps + 1; t++) {
     graph.add(dynamicsFactorGraph(robot, t, contact_points, mu));
     if (t < num_steps) {
       graph.add(collocationFactors(robot, t, dt, collocation));
     }
+    if (opt_.obstacle_sdf) {
+      graph.add(
+          obstacleFactors(robot, t, opt_.obstacle_sdf, opt_.obstacle_spheres));
+    }
   }
   return graph;
 }
@@ -364,6 +501,7 @@ gtsam::NonlinearFactorGraph DynamicsGraph::multiPhaseTrajectoryFG(
     const CollocationScheme collocation,
     const std::optional<std::vector<PointOnLinks>> &phase_contact_points,
     const std::optional<double> &mu) const {
+  TraceScope trace("multiPhaseTrajectoryFG");
   NonlinearFactorGraph graph;
   int num_phases = phase_steps.size();
 
@@ -401,6 +539,14 @@ gtsam::NonlinearFactorGraph DynamicsGraph::multiPhaseTrajectoryFG(
       graph.add(multiPhaseCollocationFactors(robot, k++, p, collocation));
     }
   }
+
+  // add obstacle factors, including at the transitions
+  if (opt_.obstacle_sdf) {
+    for (int t = 0; t <= k; t++) {
+      graph.add(
+          obstacleFactors(robot, t, opt_.obstacle_sdf, opt_.obstacle_spheres));
+    }
+  }
   return graph;
 }
 
@@ -569,6 +715,19 @@ gtsam::NonlinearFactorGraph DynamicsGraph::jointLimitFactors(
   return graph;
 }
 
+gtsam::NonlinearFactorGraph DynamicsGraph::obstacleFactors(
+    const Robot &robot, const int t, const SignedDistanceFieldSharedPtr &sdf,
+    const RobotSpheres &spheres) const {
+  NonlinearFactorGraph graph;
+  for (auto &&[name, link_spheres] : spheres) {
+    graph.emplace_shared<ObstacleSDFFactor>(
+        PoseKey(robot.link(name)->id(), t),
+        gtsam::noiseModel::Isotropic::Sigma(link_spheres.size(), opt_.obsSigma),
+        sdf, link_spheres, opt_.epsilon);
+  }
+  return graph;
+}
+
 gtsam::NonlinearFactorGraph DynamicsGraph::targetAngleFactors(
     const Robot &robot, const int t, const std::string &joint_name,
     const double target_angle) const {
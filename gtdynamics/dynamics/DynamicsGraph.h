@@ -14,7 +14,9 @@
 #pragma once
 
 #include <gtdynamics/dynamics/OptimizerSetting.h>
+#include <gtdynamics/factors/ObstacleSDFFactor.h>
 #include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/Heightmap.h>
 #include <gtdynamics/utils/PointOnLink.h>
 #include <gtsam/linear/NoiseModel.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
@@ -42,6 +44,7 @@ class DynamicsGraph {
   OptimizerSetting opt_;
   const gtsam::Vector3 gravity_;
   std::optional<gtsam::Vector3> planar_axis_;
+  HeightmapSharedPtr terrain_;  // flat ground if null
 
  public:
   /**
@@ -73,9 +76,12 @@ class DynamicsGraph {
    * @param robot        the robot
    * @param t            time step
    * @param known_values Values with kinematics, must include poses and twists
+   * @param contact_points optional contact points, each adds a contact wrench
+   * with zero moment at the contact point to the link's wrench balance
    */
   gtsam::GaussianFactorGraph linearDynamicsGraph(
-      const Robot &robot, const int t, const gtsam::Values &known_values);
+      const Robot &robot, const int t, const gtsam::Values &known_values,
+      const std::optional<PointOnLinks> &contact_points = {}) const;
 
   /// Return linear factor graph with priors on torques.
   static gtsam::GaussianFactorGraph linearFDPriors(
@@ -130,6 +136,27 @@ class DynamicsGraph {
       const std::optional<PointOnLinks> &contact_points = {},
       const std::optional<double> &mu = {}) const;
 
+  /**
+   * Return torque and planar factors on the joint wrenches eliminated through
+   * the kinematic tree, see EliminatedWrenches, which dynamicsFactors uses in
+   * place of the wrench variables when the OptimizerSetting asks for it.
+   * Without a fixed root, the wrench balance of the root is added too.
+   */
+  gtsam::NonlinearFactorGraph eliminatedWrenchFactors(
+      const Robot &robot, const int t,
+      const std::optional<PointOnLinks> &contact_points = {}) const;
+
+  /**
+   * Return torque, planar and trunk wrench balance factors of the legs
+   * reduced to serial chains, see LegChains, which
+   * dynamicsFactors uses in place of the joint wrench variables when the
+   * OptimizerSetting asks for it. qFactors, vFactors and aFactors then relate
+   * the feet to the trunk through the chains, without the other links.
+   */
+  gtsam::NonlinearFactorGraph legChainFactors(
+      const Robot &robot, const int t,
+      const std::optional<PointOnLinks> &contact_points = {}) const;
+
   /**
    * Return nonlinear factor graph of all dynamics factors
    * @param robot          the robot
@@ -172,7 +199,8 @@ class DynamicsGraph {
       const gtsam::Values &known_values) const;
 
   /**
-   * Return nonlinear factor graph of the entire trajectory
+   * Return nonlinear factor graph of the entire trajectory, with obstacle
+   * factors at every step if the setting has obstacles.
    * @param robot       the robot
    * @param num_steps   total time steps
    * @param dt          duration of each time step
@@ -185,7 +213,8 @@ class DynamicsGraph {
       const std::optional<double> &mu = {}) const;
 
   /**
-   * Return nonlinear factor graph of the entire trajectory for multi-phase
+   * Return nonlinear factor graph of the entire trajectory for multi-phase,
+   * with obstacle factors at every step if the setting has obstacles.
    * @param robot                the robot configuration
    * @param phase_steps          number of time steps for each phase
    * @param transition_graphs    transition step graphs with guardian factors
@@ -268,6 +297,19 @@ class DynamicsGraph {
   gtsam::NonlinearFactorGraph jointLimitFactors(const Robot &robot,
                                                 const int t) const;
 
+  /**
+   * Return obstacle avoidance factors on the link poses, keeping each sphere
+   * at least epsilon away from the obstacles. With ReduceLegChains, only the
+   * trunk and feet have pose variables, so only their spheres may be given.
+   * @param robot the robot
+   * @param t time step
+   * @param sdf signed distance field of the obstacles
+   * @param spheres sphere approximations of the links, by link name
+   */
+  gtsam::NonlinearFactorGraph obstacleFactors(
+      const Robot &robot, const int t, const SignedDistanceFieldSharedPtr &sdf,
+      const RobotSpheres &spheres) const;
+
   /**
    * Return goal factors of joint angle
    * @param robot        the robot
@@ -381,6 +423,16 @@ class DynamicsGraph {
 
   /// Return the optimizer setting.
   const OptimizerSetting &opt() const { return opt_; }
+
+  /**
+   * Plan contacts on rough terrain: contact height and friction cone factors
+   * use the heightmap instead of a flat ground plane. Pass null to go back to
+   * flat ground.
+   */
+  void setTerrain(const HeightmapSharedPtr &terrain) { terrain_ = terrain; }
+
+  /// Return the heightmap of the terrain, null for flat ground.
+  const HeightmapSharedPtr &terrain() const { return terrain_; }
 };
 
 }  // namespace gtdynamics
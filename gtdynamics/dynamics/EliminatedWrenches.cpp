@@ -0,0 +1,137 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  EliminatedWrenches.cpp
+ * @brief Joint wrenches of a kinematic tree as expressions of the motion of
+ * the links outboard of each joint, in place of wrench variables.
+ */
+
+#include <gtdynamics/dynamics/EliminatedWrenches.h>
+#include <gtdynamics/universal_robot/Joint.h>
+#include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/utils/values.h>
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+using gtsam::Vector6_;
+using gtsam::Z_6x1;
+
+/* ************************************************************************* */
+EliminatedWrenches::EliminatedWrenches(
+    const Robot &robot, const std::optional<gtsam::Vector3> &gravity,
+    const std::optional<PointOnLinks> &contact_points)
+    : joints_(robot.joints()),
+      gravity_(gravity),
+      contact_points_(contact_points),
+      root_(robot.treeRoot()) {
+  for (auto &&link : robot.links()) {
+    if (link->isFixed() && link != root_) {
+      throw std::invalid_argument("EliminatedWrenches: fixed link " +
+                                  link->name() + " is not the root " +
+                                  root_->name() + ".");
+    }
+  }
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::linkWrench(const LinkSharedPtr &link,
+                                        uint64_t k) const {
+  std::vector<gtsam::Key> contact_wrench_keys;
+  if (contact_points_) {
+    for (auto &&cp : *contact_points_) {
+      if (cp.link->id() != link->id()) continue;
+      contact_wrench_keys.push_back(ContactWrenchKey(link->id(), 0, k));
+    }
+  }
+  return link->wrenchConstraint(contact_wrench_keys, k, gravity_);
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::childWrench(const JointSharedPtr &joint,
+                                         uint64_t k, WrenchMemo *memo) const {
+  const auto it = memo->find(joint->id());
+  if (it != memo->end()) return it->second;
+
+  // Wrench balance of the child: the wrenches through all its joints cancel
+  // the Coriolis, inertial, gravity and contact wrenches.
+  const LinkSharedPtr child = joint->child();
+  Vector6_ wrench = Vector6_(Z_6x1) - linkWrench(child, k);
+  for (auto &&other : child->joints()) {
+    if (other == joint) continue;
+    wrench = wrench - parentWrench(other, k, memo);
+  }
+  memo->emplace(joint->id(), wrench);
+  return wrench;
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::parentWrench(const JointSharedPtr &joint,
+                                          uint64_t k, WrenchMemo *memo) const {
+  // Wrench equivalence across the joint.
+  gtsam::Double_ q(JointAngleKey(joint->id(), k));
+  Vector6_ transformed_wrench(
+      std::bind(&Joint::transformWrenchCoordinate, joint, joint->child(),
+                std::placeholders::_1, std::placeholders::_2,
+                std::placeholders::_3, std::placeholders::_4),
+      q, childWrench(joint, k, memo));
+  return Vector6_(Z_6x1) - transformed_wrench;
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::childWrench(const JointSharedPtr &joint,
+                                         uint64_t k) const {
+  WrenchMemo memo;
+  return childWrench(joint, k, &memo);
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::parentWrench(const JointSharedPtr &joint,
+                                          uint64_t k) const {
+  WrenchMemo memo;
+  return parentWrench(joint, k, &memo);
+}
+
+/* ************************************************************************* */
+std::map<int, Vector6_> EliminatedWrenches::childWrenches(uint64_t k) const {
+  WrenchMemo memo;
+  for (auto &&joint : joints_) childWrench(joint, k, &memo);
+  return memo;
+}
+
+/* ************************************************************************* */
+Vector6_ EliminatedWrenches::rootWrenchBalance(uint64_t k) const {
+  WrenchMemo memo;
+  Vector6_ balance = linkWrench(root_, k);
+  for (auto &&joint : root_->joints()) {
+    balance = balance + parentWrench(joint, k, &memo);
+  }
+  return balance;
+}
+
+/* ************************************************************************* */
+gtsam::Values EliminatedWrenches::wrenches(const gtsam::Values &values,
+                                           uint64_t k) const {
+  gtsam::Values result;
+  WrenchMemo memo;
+  for (auto &&joint : joints_) {
+    const auto j = joint->id();
+    result.insert(WrenchKey(joint->child()->id(), j, k),
+                  childWrench(joint, k, &memo).value(values));
+    result.insert(WrenchKey(joint->parent()->id(), j, k),
+                  parentWrench(joint, k, &memo).value(values));
+  }
+  return result;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,114 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  EliminatedWrenches.h
+ * @brief Joint wrenches of a kinematic tree as expressions of the motion of
+ * the links outboard of each joint, in place of wrench variables.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/PointOnLink.h>
+#include <gtsam/nonlinear/expressions.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * EliminatedWrenches eliminates the joint wrenches of a kinematic tree
+ * analytically, by recursive Newton-Euler from the leaves to the root.
+ *
+ * The wrench balance of a link (Lynch & Park, Equation 8.48) gives the wrench
+ * exerted on it through its parent joint, given the wrenches through its
+ * child joints, which the wrench equivalence across each child joint gives in
+ * turn from the outboard links. The wrench on the child link of a joint is
+ * thus an expression of the poses, twists and twist accelerations of the
+ * links outboard of it, of the joint angles between them, and of their
+ * contact wrenches. Only torques and contact wrenches remain as variables.
+ *
+ * The root is the only link that is not the child of any joint. If it is not
+ * fixed, its wrench balance remains as a constraint on the whole tree.
+ *
+ * Within a time step, the wrench expressions of the joints are built once and
+ * shared by those of the joints inboard of them, see childWrenches, so that
+ * building them all is linear in the number of links. Evaluating the torque
+ * factor of a joint still traverses its whole subtree, however, and couples
+ * all variables outboard of the joint: a tree of n links with depth d has
+ * factors on O(n d) variables in total, and eliminating a subtree fills in
+ * the Hessian block of all its variables, where wrench variables keep the
+ * factors local to each link and joint.
+ */
+class EliminatedWrenches {
+ private:
+  std::vector<JointSharedPtr> joints_;
+  std::optional<gtsam::Vector3> gravity_;
+  std::optional<PointOnLinks> contact_points_;
+  LinkSharedPtr root_;
+
+  /// Wrench expressions on the child links of joints, by joint id.
+  using WrenchMemo = std::map<int, gtsam::Vector6_>;
+
+  /// Sum of the Coriolis, inertial, gravity and contact wrenches on a link.
+  gtsam::Vector6_ linkWrench(const LinkSharedPtr &link, uint64_t k) const;
+
+  /// childWrench, reusing and filling the memo of the time step k.
+  gtsam::Vector6_ childWrench(const JointSharedPtr &joint, uint64_t k,
+                              WrenchMemo *memo) const;
+
+  /// parentWrench, reusing and filling the memo of the time step k.
+  gtsam::Vector6_ parentWrench(const JointSharedPtr &joint, uint64_t k,
+                               WrenchMemo *memo) const;
+
+ public:
+  /**
+   * Constructor.
+   * @param robot a kinematic tree, in which only the root may be fixed.
+   * @param gravity gravity in world frame.
+   * @param contact_points optional contact points, each adds a contact wrench
+   * to the wrench balance of its link.
+   * @throws std::invalid_argument if the robot is not a tree rooted at its
+   * only fixed link, if any.
+   */
+  EliminatedWrenches(const Robot &robot,
+                     const std::optional<gtsam::Vector3> &gravity = {},
+                     const std::optional<PointOnLinks> &contact_points = {});
+
+  /// The root link.
+  LinkSharedPtr root() const { return root_; }
+
+  /// Wrench on the child link of a joint, i.e., WrenchKey(child, j, k).
+  gtsam::Vector6_ childWrench(const JointSharedPtr &joint, uint64_t k) const;
+
+  /// Wrench on the parent link of a joint, i.e., WrenchKey(parent, j, k).
+  gtsam::Vector6_ parentWrench(const JointSharedPtr &joint, uint64_t k) const;
+
+  /**
+   * Wrenches on the child links of all joints at time step k, by joint id.
+   * Each one shares the expressions of the joints outboard of it, so prefer
+   * this to calling childWrench for every joint.
+   */
+  std::map<int, gtsam::Vector6_> childWrenches(uint64_t k) const;
+
+  /// Wrench balance of the root link, zero when the tree is in equilibrium.
+  gtsam::Vector6_ rootWrenchBalance(uint64_t k) const;
+
+  /**
+   * Values of the eliminated joint wrenches at time step k, e.g., to compare
+   * with, or initialize, the formulation with wrench variables.
+   * @param values poses, twists and twist accelerations of the links, joint
+   * angles, and contact wrenches, at time step k.
+   */
+  gtsam::Values wrenches(const gtsam::Values &values, uint64_t k) const;
+};
+
+}  // namespace gtdynamics
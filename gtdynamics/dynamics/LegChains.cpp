@@ -0,0 +1,247 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  LegChains.cpp
+ * @brief Legs of a legged robot as serial chains from the trunk to the feet,
+ * in place of per-link pose, twist and wrench variables.
+ */
+
+#include <gtdynamics/dynamics/LegChains.h>
+#include <gtdynamics/universal_robot/Joint.h>
+#include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/utils/values.h>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+using gtsam::Double_;
+using gtsam::Pose3_;
+using gtsam::Vector6;
+using gtsam::Vector6_;
+using gtsam::Z_6x1;
+
+/* ************************************************************************* */
+LegChains::LegChains(const Robot &robot,
+                     const std::optional<gtsam::Vector3> &gravity,
+                     const std::optional<PointOnLinks> &contact_points)
+    : trunk_(robot.treeRoot()),
+      gravity_(gravity),
+      contact_points_(contact_points) {
+  auto in_contact = [&](const LinkSharedPtr &link) {
+    if (!contact_points_) return false;
+    for (auto &&cp : *contact_points_) {
+      if (cp.link->id() == link->id()) return true;
+    }
+    return false;
+  };
+
+  for (auto &&first : robot.joints()) {
+    if (first->parent() != trunk_) continue;
+    Leg leg;
+    std::vector<Chain> chains;
+    for (JointSharedPtr joint = first; joint;) {
+      leg.joints.push_back(joint);
+      chains.emplace_back(joint->pMc(), joint->cScrewAxis());
+      leg.foot = joint->child();
+      if (leg.foot->isFixed()) {
+        throw std::invalid_argument("LegChains: link " + leg.foot->name() +
+                                    " of the leg of joint " + first->name() +
+                                    " is fixed.");
+      }
+
+      // The next joint down the leg, if any.
+      joint = nullptr;
+      for (auto &&other : leg.foot->joints()) {
+        if (other->parent() != leg.foot) continue;
+        if (joint) {
+          throw std::invalid_argument(
+              "LegChains: link " + leg.foot->name() + " branches, the leg of " +
+              "joint " + first->name() + " is not a serial chain.");
+        }
+        joint = other;
+      }
+      if (joint && in_contact(leg.foot)) {
+        throw std::invalid_argument("LegChains: link " + leg.foot->name() +
+                                    " is in contact but is not a foot.");
+      }
+    }
+    leg.chain = Chain::compose(chains);
+    legs_.push_back(leg);
+  }
+}
+
+/* ************************************************************************* */
+std::vector<gtsam::Key> LegChains::contactWrenchKeys(const LinkSharedPtr &link,
+                                                     uint64_t k) const {
+  std::vector<gtsam::Key> keys;
+  if (contact_points_) {
+    for (auto &&cp : *contact_points_) {
+      if (cp.link->id() != link->id()) continue;
+      keys.push_back(ContactWrenchKey(link->id(), 0, k));
+    }
+  }
+  return keys;
+}
+
+/* ************************************************************************* */
+std::vector<Pose3_> LegChains::linkPoses(const Leg &leg, uint64_t k) const {
+  // Product of exponentials, composed one joint at a time.
+  std::vector<Pose3_> poses;
+  Pose3_ pose(PoseKey(trunk_->id(), k));
+  for (auto &&joint : leg.joints) {
+    Pose3_ pTc(std::bind(&Joint::parentTchild, joint, std::placeholders::_1,
+                         std::placeholders::_2),
+               Double_(JointAngleKey(joint->id(), k)));
+    pose = pose * pTc;
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+/// Twist of the child link of a joint, given that of its parent.
+static Vector6_ ChildTwist(const JointSharedPtr &joint, uint64_t k,
+                           const Vector6_ &parent_twist) {
+  return Vector6_(
+      std::bind(&Joint::transformTwistTo, joint, joint->child(),
+                std::placeholders::_1, std::placeholders::_2,
+                std::placeholders::_3, std::placeholders::_4,
+                std::placeholders::_5, std::placeholders::_6),
+      Double_(JointAngleKey(joint->id(), k)),
+      Double_(JointVelKey(joint->id(), k)), parent_twist);
+}
+
+/* ************************************************************************* */
+std::vector<Vector6_> LegChains::linkTwists(const Leg &leg,
+                                            uint64_t k) const {
+  std::vector<Vector6_> twists;
+  Vector6_ twist(TwistKey(trunk_->id(), k));
+  for (auto &&joint : leg.joints) {
+    twist = ChildTwist(joint, k, twist);
+    twists.push_back(twist);
+  }
+  return twists;
+}
+
+/* ************************************************************************* */
+std::vector<Vector6_> LegChains::linkTwistAccels(const Leg &leg,
+                                                 uint64_t k) const {
+  // As in Joint::twistAccelConstraint, split in two expressions of at most
+  // three arguments: the twist acceleration of the parent in the child frame,
+  // and that due to the joint, which depends on the twist of the child.
+  const std::vector<Vector6_> twists = linkTwists(leg, k);
+  std::vector<Vector6_> twist_accels;
+  Vector6_ twist_accel(TwistAccelKey(trunk_->id(), k));
+  for (size_t i = 0; i < leg.joints.size(); i++) {
+    const JointSharedPtr &joint = leg.joints[i];
+
+    auto transformed = [joint](double q, const Vector6 &parent_twist_accel,
+                               gtsam::OptionalJacobian<6, 1> H_q,
+                               gtsam::OptionalJacobian<6, 6> H_accel) {
+      gtsam::Matrix61 cTp_H_q;
+      gtsam::Matrix6 H_cTp;
+      const gtsam::Pose3 cTp =
+          joint->childTparent(q, H_q ? &cTp_H_q : nullptr);
+      const Vector6 result = cTp.Adjoint(
+          parent_twist_accel, H_q ? &H_cTp : nullptr, H_accel);
+      if (H_q) *H_q = H_cTp * cTp_H_q;
+      return result;
+    };
+    auto joint_accel = [joint](double q_dot, double q_ddot,
+                               const Vector6 &child_twist,
+                               gtsam::OptionalJacobian<6, 1> H_q_dot,
+                               gtsam::OptionalJacobian<6, 1> H_q_ddot,
+                               gtsam::OptionalJacobian<6, 6> H_twist) {
+      const Vector6 &A = joint->cScrewAxis();
+      if (H_q_dot) *H_q_dot = gtsam::Pose3::adjointMap(child_twist) * A;
+      if (H_q_ddot) *H_q_ddot = A;
+      return Vector6(gtsam::Pose3::adjoint(child_twist, A * q_dot, H_twist) +
+                     A * q_ddot);
+    };
+
+    twist_accel =
+        Vector6_(transformed, Double_(JointAngleKey(joint->id(), k)),
+                 twist_accel) +
+        Vector6_(joint_accel, Double_(JointVelKey(joint->id(), k)),
+                 Double_(JointAccelKey(joint->id(), k)), twists[i]);
+    twist_accels.push_back(twist_accel);
+  }
+  return twist_accels;
+}
+
+/* ************************************************************************* */
+Pose3_ LegChains::footPose(const Leg &leg, uint64_t k) const {
+  return linkPoses(leg, k).back();
+}
+
+/* ************************************************************************* */
+Vector6_ LegChains::footTwist(const Leg &leg, uint64_t k) const {
+  return linkTwists(leg, k).back();
+}
+
+/* ************************************************************************* */
+Vector6_ LegChains::footTwistAccel(const Leg &leg, uint64_t k) const {
+  return linkTwistAccels(leg, k).back();
+}
+
+/* ************************************************************************* */
+std::vector<Vector6_> LegChains::childWrenches(const Leg &leg,
+                                               uint64_t k) const {
+  // The wrench through each joint balances the inertial and gravity wrench of
+  // its child link, and the wrench through the next joint; that through the
+  // last one also balances the contact wrenches of the foot.
+  const std::vector<Pose3_> poses = linkPoses(leg, k);
+  const std::vector<Vector6_> twists = linkTwists(leg, k);
+  const std::vector<Vector6_> twist_accels = linkTwistAccels(leg, k);
+  auto link_wrench = [&](size_t i) {
+    const LinkSharedPtr &link = leg.joints[i]->child();
+    std::vector<gtsam::Key> contact_keys;
+    if (i + 1 == leg.joints.size()) contact_keys = contactWrenchKeys(link, k);
+    return link->wrenchConstraint(contact_keys, poses[i], twists[i],
+                                  twist_accels[i], gravity_);
+  };
+
+  const size_t n = leg.joints.size();
+  std::vector<Vector6_> wrenches(n, Vector6_(Z_6x1));
+  wrenches[n - 1] = Vector6_(Z_6x1) - link_wrench(n - 1);
+  for (size_t i = n - 1; i-- > 0;) {
+    const JointSharedPtr &next = leg.joints[i + 1];
+    Vector6_ transformed_wrench(
+        std::bind(&Joint::transformWrenchCoordinate, next, next->child(),
+                  std::placeholders::_1, std::placeholders::_2,
+                  std::placeholders::_3, std::placeholders::_4),
+        Double_(JointAngleKey(next->id(), k)), wrenches[i + 1]);
+    wrenches[i] = transformed_wrench - link_wrench(i);
+  }
+  return wrenches;
+}
+
+/* ************************************************************************* */
+Vector6_ LegChains::trunkWrench(const Leg &leg, uint64_t k) const {
+  // Wrench equivalence across the first joint.
+  const JointSharedPtr &first = leg.joints.front();
+  Vector6_ transformed_wrench(
+      std::bind(&Joint::transformWrenchCoordinate, first, first->child(),
+                std::placeholders::_1, std::placeholders::_2,
+                std::placeholders::_3, std::placeholders::_4),
+      Double_(JointAngleKey(first->id(), k)), childWrenches(leg, k).front());
+  return Vector6_(Z_6x1) - transformed_wrench;
+}
+
+/* ************************************************************************* */
+Vector6_ LegChains::trunkWrenchBalance(uint64_t k) const {
+  Vector6_ balance =
+      trunk_->wrenchConstraint(contactWrenchKeys(trunk_, k), k, gravity_);
+  for (auto &&leg : legs_) balance = balance + trunkWrench(leg, k);
+  return balance;
+}
+
+}  // namespace gtdynamics
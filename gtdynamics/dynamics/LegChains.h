@@ -0,0 +1,124 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  LegChains.h
+ * @brief Legs of a legged robot as serial chains from the trunk to the feet,
+ * in place of per-link pose, twist and wrench variables.
+ */
+
+#pragma once
+
+#include <gtdynamics/dynamics/Chain.h>
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/PointOnLink.h>
+#include <gtsam/nonlinear/expressions.h>
+#include <gtsam/slam/expressions.h>
+
+#include <optional>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * LegChains reduces each leg of a robot to a single serial chain, from the
+ * trunk to the foot, as Chain does for the three-link legs of the examples.
+ *
+ * The trunk is the only link that is not the child of any joint, and every
+ * joint whose parent is the trunk starts a leg, which must be a serial chain
+ * down to its foot. The pose, twist and twist acceleration of each foot are
+ * expressions of those of the trunk and of the joint angles, velocities and
+ * accelerations of its leg, i.e., the product of exponentials and its
+ * derivatives, so that only the trunk and the feet keep link variables.
+ *
+ * The wrench on the child link of each joint balances the inertial and
+ * gravity wrench of that link, evaluated on the expressions of its pose, twist
+ * and twist acceleration, and the wrench through the next joint down the leg,
+ * or the contact wrenches of the foot. The trunk receives the wrenches through
+ * the first joints of the legs, so no joint wrench variables remain, and the
+ * reduction is exact: it matches the per-link wrench variables.
+ *
+ * The wrench through a joint depends on the motion of all links below it,
+ * hence on the trunk and on all joints of the leg: each torque factor couples
+ * those variables.
+ */
+class LegChains {
+ public:
+  /// A leg: serial chain of joints from the trunk to a foot.
+  struct Leg {
+    std::vector<JointSharedPtr> joints;  ///< From the trunk to the foot.
+    LinkSharedPtr foot;                  ///< Child link of the last joint.
+    Chain chain;  ///< Rest pose of the foot in the trunk frame, and screw
+                  ///< axes in the foot frame.
+  };
+
+ private:
+  LinkSharedPtr trunk_;
+  std::vector<Leg> legs_;
+  std::optional<gtsam::Vector3> gravity_;
+  std::optional<PointOnLinks> contact_points_;
+
+  /// Keys of the contact wrenches on a link, empty without contact.
+  std::vector<gtsam::Key> contactWrenchKeys(const LinkSharedPtr &link,
+                                            uint64_t k) const;
+
+ public:
+  /**
+   * Constructor.
+   * @param robot a kinematic tree, whose root is the trunk.
+   * @param gravity gravity in world frame.
+   * @param contact_points optional contact points, on the trunk or the feet.
+   * @throws std::invalid_argument if the robot is not a tree, if a leg
+   * branches, or if a link of a leg is fixed or in contact before its foot.
+   */
+  LegChains(const Robot &robot,
+            const std::optional<gtsam::Vector3> &gravity = {},
+            const std::optional<PointOnLinks> &contact_points = {});
+
+  /// The trunk link.
+  LinkSharedPtr trunk() const { return trunk_; }
+
+  /// The legs, in the order of the joints attached to the trunk.
+  const std::vector<Leg> &legs() const { return legs_; }
+
+  /**
+   * Poses of the child links of the joints of a leg, i.e., PoseKey(child, k),
+   * given that of the trunk, in the order of Leg::joints.
+   */
+  std::vector<gtsam::Pose3_> linkPoses(const Leg &leg, uint64_t k) const;
+
+  /// Twists of the child links of the joints of a leg, i.e., TwistKey.
+  std::vector<gtsam::Vector6_> linkTwists(const Leg &leg, uint64_t k) const;
+
+  /// Twist accelerations of the child links of the joints of a leg.
+  std::vector<gtsam::Vector6_> linkTwistAccels(const Leg &leg,
+                                               uint64_t k) const;
+
+  /// Pose of the foot, i.e., PoseKey(foot, k), given that of the trunk.
+  gtsam::Pose3_ footPose(const Leg &leg, uint64_t k) const;
+
+  /// Twist of the foot, i.e., TwistKey(foot, k), given that of the trunk.
+  gtsam::Vector6_ footTwist(const Leg &leg, uint64_t k) const;
+
+  /// Twist acceleration of the foot, i.e., TwistAccelKey(foot, k).
+  gtsam::Vector6_ footTwistAccel(const Leg &leg, uint64_t k) const;
+
+  /**
+   * Wrenches on the child links of the joints of a leg, i.e.,
+   * WrenchKey(child, j, k), in the order of Leg::joints.
+   */
+  std::vector<gtsam::Vector6_> childWrenches(const Leg &leg,
+                                             uint64_t k) const;
+
+  /// Wrench on the trunk through the first joint of a leg.
+  gtsam::Vector6_ trunkWrench(const Leg &leg, uint64_t k) const;
+
+  /// Wrench balance of the trunk, zero when the robot is in equilibrium.
+  gtsam::Vector6_ trunkWrenchBalance(uint64_t k) const;
+};
+
+}  // namespace gtdynamics
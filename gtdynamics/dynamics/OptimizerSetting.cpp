@@ -46,7 +46,10 @@ OptimizerSetting::OptimizerSetting()
       time_cost_model(gtsam::noiseModel::Isotropic::Sigma(1, 0.001)),
       jl_cost_model(gtsam::noiseModel::Isotropic::Sigma(1, 0.001)),
       rel_thresh(1e-2),
-      max_iter(50) {}
+      max_iter(50),
+      dynamics_formulation(WrenchVariables),
+      epsilon(kObstacleEpsilon),
+      obsSigma(kObstacleSigma) {}
 
 // void OptimizerSetting::setQcModelPose3(const gtsam::Matrix &Qc) {
 //   Qc_model_pose3 = gtsam::noiseModel::Gaussian::Covariance(Qc);
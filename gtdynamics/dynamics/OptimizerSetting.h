@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/utils/SignedDistanceField.h>
 #include <gtsam/linear/NoiseModel.h>
 
 namespace gtdynamics {
@@ -23,6 +24,15 @@ class OptimizerSetting {
   /// optimization iteration types
   enum IterationType { GaussNewton, LM, Dogleg };
   enum VerbosityLevel { None, Error };
+  /**
+   * dynamics formulations, see EliminatedWrenches and LegChains. All three
+   * are exact, and differ in the variables they keep.
+   */
+  enum DynamicsFormulation {
+    WrenchVariables,
+    EliminateWrenches,
+    ReduceLegChains
+  };
 
   // factor cost models
   gtsam::noiseModel::Base::shared_ptr bp_cost_model,  // pose of fixed link
@@ -62,9 +72,14 @@ class OptimizerSetting {
                       // optimization
   int max_iter;       // max iteration for stopping optimization
 
-  /// collision checking setting
+  /// dynamics formulation
+  DynamicsFormulation dynamics_formulation;
+
+  /// collision checking setting, see DynamicsGraph::obstacleFactors
   double epsilon;   // obstacle clearance
   double obsSigma;  // obstacle cost model covariance
+  SignedDistanceFieldSharedPtr obstacle_sdf;  // obstacles, none if null
+  RobotSpheres obstacle_spheres;  // link spheres kept clear of obstacles
 
   /// default constructor
   OptimizerSetting();
@@ -121,7 +136,10 @@ class OptimizerSetting {
         time_cost_model(gtsam::noiseModel::Isotropic::Sigma(1, sigma_time)),
         jl_cost_model(gtsam::noiseModel::Isotropic::Sigma(1, sigma_joint)),
         rel_thresh(1e-2),
-        max_iter(50) {}
+        max_iter(50),
+        dynamics_formulation(WrenchVariables),
+        epsilon(kObstacleEpsilon),
+        obsSigma(kObstacleSigma) {}
 
   // default destructor
   ~OptimizerSetting() {}
@@ -140,6 +158,19 @@ class OptimizerSetting {
 
   // set maximum iteration number
   void setMaxIteration(size_t iter) { max_iter = iter; }
+
+  // eliminate joint wrenches through the kinematic tree
+  void setEliminateWrenches() { dynamics_formulation = EliminateWrenches; }
+
+  // reduce each leg to a serial chain from the trunk to the foot
+  void setReduceLegChains() { dynamics_formulation = ReduceLegChains; }
+
+  // keep the link spheres clear of the obstacles in the trajectory graphs
+  void setObstacles(const SignedDistanceFieldSharedPtr &sdf,
+                    const RobotSpheres &spheres) {
+    obstacle_sdf = sdf;
+    obstacle_spheres = spheres;
+  }
 };
 
 }  // namespace gtdynamics
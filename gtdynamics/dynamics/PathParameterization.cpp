@@ -0,0 +1,270 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  PathParameterization.cpp
+ * @brief Time-optimal parameterization of a fixed joint-space path, by
+ * reachability analysis (TOPP-RA).
+ */
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/dynamics/PathParameterization.h>
+#include <gtdynamics/utils/values.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::Values;
+using gtsam::Vector;
+
+namespace {
+
+/// Linear inequality alpha * sdd + beta * sd^2 <= gamma.
+struct Inequality {
+  double alpha, beta, gamma;
+};
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+/**
+ * Interval of x = sd^2 for which some u = sdd satisfies all inequalities,
+ * by Fourier-Motzkin elimination of u. Empty if lower > upper.
+ */
+std::pair<double, double> ProjectOnX(const std::vector<Inequality> &ineqs,
+                                     double tol) {
+  std::vector<Inequality> lower, upper, on_x;
+  for (auto &&ineq : ineqs) {
+    if (ineq.alpha > tol) {
+      upper.push_back(ineq);
+    } else if (ineq.alpha < -tol) {
+      lower.push_back(ineq);
+    } else {
+      on_x.push_back(ineq);
+    }
+  }
+  // Each pair of a lower and an upper bound on u gives a bound on x.
+  for (auto &&l : lower) {
+    for (auto &&h : upper) {
+      on_x.push_back({0.0, h.alpha * l.beta - l.alpha * h.beta,
+                      h.alpha * l.gamma - l.alpha * h.gamma});
+    }
+  }
+  double x_min = -kInf, x_max = kInf;
+  for (auto &&ineq : on_x) {
+    if (ineq.beta > tol) {
+      x_max = std::min(x_max, ineq.gamma / ineq.beta);
+    } else if (ineq.beta < -tol) {
+      x_min = std::max(x_min, ineq.gamma / ineq.beta);
+    } else if (ineq.gamma < -tol) {
+      return {kInf, -kInf};
+    }
+  }
+  return {x_min, x_max};
+}
+
+/// Interval of u = sdd satisfying all inequalities at a given x = sd^2.
+std::pair<double, double> RangeOfU(const std::vector<Inequality> &ineqs,
+                                   double x, double tol) {
+  double u_min = -kInf, u_max = kInf;
+  for (auto &&ineq : ineqs) {
+    const double rhs = ineq.gamma - ineq.beta * x;
+    if (ineq.alpha > tol) {
+      u_max = std::min(u_max, rhs / ineq.alpha);
+    } else if (ineq.alpha < -tol) {
+      u_min = std::max(u_min, rhs / ineq.alpha);
+    }
+  }
+  return {u_min, u_max};
+}
+
+/// Velocity, acceleration and torque limits at a gridpoint.
+std::vector<Inequality> PathConstraints(
+    const Robot &robot, const PathParameterization::GridPoint &point) {
+  std::vector<Inequality> ineqs{{0.0, -1.0, 0.0}};  // sd^2 >= 0
+  for (auto &&joint : robot.joints()) {
+    const int j = joint->id();
+    const auto &limits = joint->parameters();
+    const double dq = point.dq(j), ddq = point.ddq(j);
+    const double v_max = limits.velocity_limit;
+    const double a_max = limits.acceleration_limit;
+    const double tau_max = limits.torque_limit;
+    ineqs.push_back({0.0, dq * dq, v_max * v_max});
+    ineqs.push_back({dq, ddq, a_max});
+    ineqs.push_back({-dq, -ddq, a_max});
+    ineqs.push_back({point.a(j), point.b(j), tau_max - point.c(j)});
+    ineqs.push_back({-point.a(j), -point.b(j), tau_max + point.c(j)});
+  }
+  return ineqs;
+}
+
+/// Inequalities keeping x + 2 * ds * u within [lower, upper].
+void AddTransition(double ds, const std::pair<double, double> &next,
+                   std::vector<Inequality> *ineqs) {
+  ineqs->push_back({2 * ds, 1.0, next.second});
+  ineqs->push_back({-2 * ds, -1.0, -next.first});
+}
+
+/// Joint torques by inverse dynamics at joint angles q, velocities v and
+/// accelerations a.
+Vector InverseDynamics(const Robot &robot, DynamicsGraph &graph,
+                       const Vector &q, const Vector &v, const Vector &a) {
+  Values known_values;
+  for (auto &&joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), q(joint->id()));
+    InsertJointVel(&known_values, joint->id(), v(joint->id()));
+  }
+  known_values = robot.forwardKinematics(known_values);
+  for (auto &&joint : robot.joints()) {
+    InsertJointAccel(&known_values, joint->id(), a(joint->id()));
+  }
+  const Values result = graph.linearSolveID(robot, 0, known_values);
+  Vector tau(robot.numJoints());
+  for (auto &&joint : robot.joints()) {
+    tau(joint->id()) = Torque(result, joint->id());
+  }
+  return tau;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+PathParameterization::PathParameterization(
+    const Robot &robot, const std::vector<Vector> &path,
+    const PathParameterizationParams &params)
+    : robot_(robot), params_(params) {
+  const size_t num_points = path.size();
+  const size_t n = robot.numJoints();
+  if (num_points < 3) {
+    throw std::invalid_argument(
+        "PathParameterization: need at least 3 waypoints.");
+  }
+  for (auto &&q : path) {
+    if (static_cast<size_t>(q.size()) != n) {
+      throw std::invalid_argument(
+          "PathParameterization: waypoints should have " + std::to_string(n) +
+          " joint angles.");
+    }
+  }
+
+  // Derivatives w.r.t. s by finite differences, one-sided at the ends.
+  const double ds = 1.0 / (num_points - 1);
+  grid_.resize(num_points);
+  for (size_t k = 0; k < num_points; k++) {
+    const size_t k0 = std::max<size_t>(k, 1) - 1;
+    const size_t k1 = std::min(k + 1, num_points - 1);
+    const size_t kc = std::min(std::max<size_t>(k, 1), num_points - 2);
+    GridPoint &point = grid_[k];
+    point.s = k * ds;
+    point.q = path[k];
+    point.dq = (path[k1] - path[k0]) / ((k1 - k0) * ds);
+    point.ddq = (path[kc + 1] - 2 * path[kc] + path[kc - 1]) / (ds * ds);
+  }
+
+  // Dynamics coefficients, using that the torque is linear in the joint
+  // accelerations and quadratic in the joint velocities.
+  DynamicsGraph graph(params.gravity, params.planar_axis);
+  const Vector zero = Vector::Zero(n);
+  for (auto &&point : grid_) {
+    point.c = InverseDynamics(robot, graph, point.q, zero, zero);
+    point.a = InverseDynamics(robot, graph, point.q, zero, point.dq) - point.c;
+    point.b = InverseDynamics(robot, graph, point.q, point.dq, point.ddq) -
+              point.c;
+  }
+}
+
+/* ************************************************************************* */
+std::vector<std::pair<double, double>> PathParameterization::controllableSets()
+    const {
+  const size_t N = grid_.size() - 1;
+  const double x_end = params_.end_velocity * params_.end_velocity;
+  std::vector<std::pair<double, double>> sets(N + 1);
+  sets[N] = {x_end, x_end};
+  for (size_t k = N; k-- > 0;) {
+    auto ineqs = PathConstraints(robot_, grid_[k]);
+    AddTransition(grid_[k + 1].s - grid_[k].s, sets[k + 1], &ineqs);
+    sets[k] = ProjectOnX(ineqs, params_.tol);
+    sets[k].first = std::max(sets[k].first, 0.0);
+    if (sets[k].first > sets[k].second + params_.tol) {
+      throw std::runtime_error(
+          "PathParameterization: the end of the path cannot be reached from "
+          "gridpoint " +
+          std::to_string(k) + ".");
+    }
+  }
+  return sets;
+}
+
+/* ************************************************************************* */
+PathParameterization::Result PathParameterization::compute() const {
+  const auto sets = controllableSets();
+  const size_t N = grid_.size() - 1;
+
+  double x = params_.start_velocity * params_.start_velocity;
+  if (x < sets[0].first - params_.tol || x > sets[0].second + params_.tol) {
+    throw std::runtime_error(
+        "PathParameterization: the start velocity is not controllable.");
+  }
+
+  Result result;
+  result.s.reserve(N + 1);
+  result.sd.reserve(N + 1);
+  result.sdd.reserve(N + 1);
+  result.t.reserve(N + 1);
+  result.t.push_back(0.0);
+  for (size_t k = 0; k <= N; k++) {
+    result.s.push_back(grid_[k].s);
+    result.sd.push_back(std::sqrt(x));
+    if (k == N) break;
+
+    // Greedy step: the largest acceleration that stays controllable.
+    const double ds = grid_[k + 1].s - grid_[k].s;
+    auto ineqs = PathConstraints(robot_, grid_[k]);
+    AddTransition(ds, sets[k + 1], &ineqs);
+    const double u = RangeOfU(ineqs, x, params_.tol).second;
+    result.sdd.push_back(u);
+
+    const double x_next = std::min(std::max(x + 2 * ds * u, sets[k + 1].first),
+                                   sets[k + 1].second);
+    const double sd_sum = std::sqrt(x) + std::sqrt(x_next);
+    if (sd_sum <= 0) {
+      throw std::runtime_error(
+          "PathParameterization: the path stalls at gridpoint " +
+          std::to_string(k) + ".");
+    }
+    result.t.push_back(result.t.back() + 2 * ds / sd_sum);
+    x = x_next;
+  }
+  result.sdd.push_back(0.0);
+  return result;
+}
+
+/* ************************************************************************* */
+Values PathParameterization::values(const Result &result) const {
+  Values values;
+  for (size_t k = 0; k < grid_.size(); k++) {
+    const GridPoint &point = grid_[k];
+    const double sd = result.sd[k], sdd = result.sdd[k];
+    const Vector qdot = point.dq * sd;
+    const Vector qddot = point.dq * sdd + point.ddq * sd * sd;
+    const Vector tau = point.a * sdd + point.b * sd * sd + point.c;
+    for (auto &&joint : robot_.joints()) {
+      const int j = joint->id();
+      InsertJointAngle(&values, j, k, point.q(j));
+      InsertJointVel(&values, j, k, qdot(j));
+      InsertJointAccel(&values, j, k, qddot(j));
+      InsertTorque(&values, j, k, tau(j));
+    }
+  }
+  return values;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,127 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  PathParameterization.h
+ * @brief Time-optimal parameterization of a fixed joint-space path, by
+ * reachability analysis (TOPP-RA).
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Parameters of the path parameterization.
+struct PathParameterizationParams {
+  gtsam::Vector3 gravity = gtsam::Vector3(0, 0, -9.8);
+  std::optional<gtsam::Vector3> planar_axis;
+  double start_velocity = 0.0;  // path velocity ds/dt at the start
+  double end_velocity = 0.0;    // path velocity ds/dt at the end
+  double tol = 1e-9;            // tolerance on constraint violation
+
+  PathParameterizationParams() {}
+};
+
+/**
+ * PathParameterization finds the fastest timing s(t) of a fixed path q(s),
+ * s in [0, 1], subject to the joint velocity, acceleration and torque limits
+ * in JointParams. Along the path,
+ *    qdot  = q'(s) sd,
+ *    qddot = q'(s) sdd + q''(s) sd^2,
+ *    tau   = a(s) sdd + b(s) sd^2 + c(s),
+ * with a = M q', b = M q'' + C(q, q') q' and c = g(q) obtained from the mass
+ * matrix M, Coriolis C and gravity g terms of the robot. All limits are
+ * linear in (sdd, sd^2), so on a grid of the path:
+ *  - a backward pass computes the set of sd^2 at each gridpoint from which the
+ *    end of the path can be reached, each an interval found by eliminating
+ *    sdd from a small set of linear inequalities;
+ *  - a forward pass greedily picks the largest feasible sdd while staying in
+ *    those sets, which yields the time-optimal timing.
+ *
+ * The dynamics coefficients are evaluated once at construction, by inverse
+ * dynamics on the linear dynamics graph, so the path can be retimed with
+ * different boundary velocities in milliseconds. The robot must have a fixed
+ * link.
+ */
+class PathParameterization {
+ public:
+  /// Path and its dynamics at a gridpoint, vectors indexed by joint id.
+  struct GridPoint {
+    double s;
+    gtsam::Vector q, dq, ddq;  // path and its derivatives w.r.t. s
+    gtsam::Vector a, b, c;     // torque = a * sdd + b * sd^2 + c
+  };
+
+  /// Timing of the path at the gridpoints.
+  struct Result {
+    std::vector<double> s;    // path parameter
+    std::vector<double> sd;   // path velocity
+    std::vector<double> sdd;  // path acceleration until the next gridpoint
+    std::vector<double> t;    // time
+
+    /// Total traversal time.
+    double duration() const { return t.back(); }
+  };
+
+ private:
+  Robot robot_;
+  PathParameterizationParams params_;
+  std::vector<GridPoint> grid_;
+
+ public:
+  /**
+   * Constructor.
+   * @param robot the robot, with a fixed link.
+   * @param path at least 3 waypoints of joint angles, indexed by joint id,
+   * evenly spaced in s. Derivatives are taken by finite differences.
+   * @param params parameters.
+   */
+  PathParameterization(
+      const Robot &robot, const std::vector<gtsam::Vector> &path,
+      const PathParameterizationParams &params = PathParameterizationParams());
+
+  /// Path and dynamics coefficients at the gridpoints.
+  const std::vector<GridPoint> &grid() const { return grid_; }
+
+  /// Parameters.
+  const PathParameterizationParams &params() const { return params_; }
+
+  /// Set the path velocities at the start and end of the path.
+  void setBoundaryVelocities(double start_velocity, double end_velocity) {
+    params_.start_velocity = start_velocity;
+    params_.end_velocity = end_velocity;
+  }
+
+  /**
+   * Compute the controllable sets: at each gridpoint, the interval of sd^2
+   * from which the end velocity can be reached.
+   * @return lower and upper bounds of the intervals.
+   */
+  std::vector<std::pair<double, double>> controllableSets() const;
+
+  /**
+   * Compute the time-optimal timing of the path.
+   * Throws std::runtime_error if no feasible timing exists.
+   */
+  Result compute() const;
+
+  /**
+   * Joint angles, velocities, accelerations and torques of a timing, with
+   * gridpoint k at time step k.
+   * @param result timing returned by compute().
+   */
+  gtsam::Values values(const Result &result) const;
+};
+
+}  // namespace gtdynamics
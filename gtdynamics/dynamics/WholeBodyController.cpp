@@ -0,0 +1,191 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  WholeBodyController.cpp
+ * @brief Inverse-dynamics whole-body QP controller built on the linear
+ * dynamics graph.
+ */
+
+#include <gtdynamics/dynamics/WholeBodyController.h>
+#include <gtdynamics/utils/values.h>
+
+#include <cmath>
+
+namespace gtdynamics {
+
+using gtsam::GaussianFactorGraph;
+using gtsam::Matrix;
+using gtsam::Pose3;
+using gtsam::Vector1;
+using gtsam::Vector3;
+using gtsam::VectorValues;
+using gtsam::noiseModel::Constrained;
+using gtsam::noiseModel::Isotropic;
+
+/* ************************************************************************* */
+WholeBodyController::WholeBodyController(
+    const Robot &robot, const PointOnLinks &contact_points,
+    const WholeBodyControllerParams &params, int k)
+    : robot_(robot),
+      contact_points_(contact_points),
+      params_(params),
+      k_(k),
+      graph_builder_(params.gravity),
+      active_model_(Isotropic::Sigma(1, params.sigma_active)) {}
+
+/* ************************************************************************* */
+void WholeBodyController::resetCache() {
+  ordering_.reset();
+  active_.clear();
+}
+
+/* ************************************************************************* */
+void WholeBodyController::setContactPoints(
+    const PointOnLinks &contact_points) {
+  contact_points_ = contact_points;
+  resetCache();
+}
+
+/* ************************************************************************* */
+void WholeBodyController::setLinkAccelTask(const std::string &link_name,
+                                           const gtsam::Vector6 &desired_accel,
+                                           double sigma) {
+  tasks_[TwistAccelKey(robot_.link(link_name)->id(), k_)] =
+      Task{desired_accel, Isotropic::Sigma(6, sigma)};
+}
+
+/* ************************************************************************* */
+void WholeBodyController::setJointAccelTask(const std::string &joint_name,
+                                            double desired_accel,
+                                            double sigma) {
+  tasks_[JointAccelKey(robot_.joint(joint_name)->id(), k_)] =
+      Task{Vector1(desired_accel), Isotropic::Sigma(1, sigma)};
+}
+
+/* ************************************************************************* */
+void WholeBodyController::clearTasks() { tasks_.clear(); }
+
+/* ************************************************************************* */
+GaussianFactorGraph WholeBodyController::qp(
+    const gtsam::Values &state) const {
+  GaussianFactorGraph graph =
+      graph_builder_.linearDynamicsGraph(robot_, k_, state, contact_points_);
+
+  // Contact points do not accelerate.
+  gtsam::Matrix36 H_accel = gtsam::Matrix36::Zero();
+  H_accel.rightCols<3>().setIdentity();
+  for (auto &&cp : contact_points_) {
+    const Pose3 cTcom(gtsam::Rot3(), -cp.point);
+    graph.add(TwistAccelKey(cp.link->id(), k_), H_accel * cTcom.AdjointMap(),
+              Vector3::Zero(), Constrained::All(3));
+  }
+
+  // Tasks take precedence over regularization on the same variable.
+  for (auto &&[key, task] : tasks_) {
+    graph.add(key, Matrix::Identity(task.b.size(), task.b.size()), task.b,
+              task.model);
+  }
+
+  auto torque_model = Isotropic::Sigma(1, params_.sigma_torque);
+  auto accel_model = Isotropic::Sigma(1, params_.sigma_accel);
+  for (auto &&joint : robot_.joints()) {
+    graph.add(TorqueKey(joint->id(), k_), gtsam::I_1x1, Vector1::Zero(),
+              torque_model);
+    if (!tasks_.count(JointAccelKey(joint->id(), k_))) {
+      graph.add(JointAccelKey(joint->id(), k_), gtsam::I_1x1, Vector1::Zero(),
+                accel_model);
+    }
+  }
+  auto wrench_model = Isotropic::Sigma(6, params_.sigma_wrench);
+  for (auto &&cp : contact_points_) {
+    graph.add(ContactWrenchKey(cp.link->id(), 0, k_), gtsam::I_6x6,
+              gtsam::Vector6::Zero(), wrench_model);
+  }
+  return graph;
+}
+
+/* ************************************************************************* */
+std::vector<LinearInequality> WholeBodyController::inequalities(
+    const gtsam::Values &state) const {
+  std::vector<LinearInequality> constraints;
+
+  for (auto &&joint : robot_.joints()) {
+    const double limit = joint->parameters().torque_limit;
+    const gtsam::Key key = TorqueKey(joint->id(), k_);
+    constraints.push_back({key, gtsam::I_1x1, limit});
+    constraints.push_back({key, -gtsam::I_1x1, limit});
+  }
+
+  // Inner friction pyramid around the up direction.
+  const Vector3 n = -params_.gravity.normalized();
+  const Vector3 t1 = n.cross(std::abs(n.x()) < 0.9 ? Vector3::UnitX()
+                                                   : Vector3::UnitY())
+                         .normalized();
+  const Vector3 t2 = n.cross(t1);
+  const double mu = params_.mu / std::sqrt(2.0);
+  gtsam::Matrix36 H_force = gtsam::Matrix36::Zero();
+  H_force.rightCols<3>().setIdentity();
+  for (auto &&cp : contact_points_) {
+    const int i = cp.link->id();
+    const gtsam::Key key = ContactWrenchKey(i, 0, k_);
+    // Contact force in the world frame, as a function of the contact wrench.
+    const Matrix H = Pose(state, i, k_).rotation().matrix() * H_force;
+    constraints.push_back({key, -n.transpose() * H, -params_.min_normal_force});
+    for (const Vector3 &t : {t1, t2}) {
+      constraints.push_back({key, (t - mu * n).transpose() * H, 0.0});
+      constraints.push_back({key, (-t - mu * n).transpose() * H, 0.0});
+    }
+  }
+  return constraints;
+}
+
+/* ************************************************************************* */
+VectorValues WholeBodyController::compute(const gtsam::Values &state) {
+  const GaussianFactorGraph graph = qp(state);
+  const std::vector<LinearInequality> constraints = inequalities(state);
+  if (!ordering_) ordering_ = gtsam::Ordering::Colamd(graph);
+  if (active_.size() != constraints.size()) {
+    active_.assign(constraints.size(), false);
+  }
+
+  VectorValues result;
+  for (iterations_ = 1;; iterations_++) {
+    GaussianFactorGraph active_graph = graph;
+    for (size_t c = 0; c < constraints.size(); c++) {
+      if (!active_[c]) continue;
+      active_graph.add(constraints[c].key, constraints[c].a,
+                       Vector1(constraints[c].b), active_model_);
+    }
+    result = active_graph.optimize(*ordering_);
+    if (iterations_ >= params_.max_active_set_iterations) break;
+
+    // Release constraints the solution pulls away from, add violated ones.
+    bool changed = false;
+    for (size_t c = 0; c < constraints.size(); c++) {
+      const double violation = constraints[c].violation(result);
+      if (active_[c] && violation < 0) {
+        active_[c] = false;
+        changed = true;
+      } else if (!active_[c] && violation > params_.inequality_tol) {
+        active_[c] = true;
+        changed = true;
+      }
+    }
+    if (!changed) break;
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+size_t WholeBodyController::numActive() const {
+  size_t num_active = 0;
+  for (bool active : active_) num_active += active;
+  return num_active;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,163 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  WholeBodyController.h
+ * @brief Inverse-dynamics whole-body QP controller built on the linear
+ * dynamics graph.
+ */
+
+#pragma once
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/PointOnLink.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Parameters of the whole-body controller.
+struct WholeBodyControllerParams {
+  gtsam::Vector3 gravity = gtsam::Vector3(0, 0, -9.8);
+  double mu = 1.0;                  // friction coefficient
+  double min_normal_force = 0.0;    // lower bound on contact normal forces
+  double sigma_torque = 1e2;        // regularizes joint torques
+  double sigma_accel = 1e2;         // regularizes joint accelerations
+  double sigma_wrench = 1e2;        // regularizes contact wrenches
+  double sigma_active = 1e-6;       // pins active inequality constraints
+  double inequality_tol = 1e-6;     // tolerated inequality violation
+  size_t max_active_set_iterations = 20;
+
+  WholeBodyControllerParams() {}
+};
+
+/// Linear inequality a * x_key <= b on a single variable.
+struct LinearInequality {
+  gtsam::Key key;
+  gtsam::Matrix a;
+  double b;
+
+  /// Signed violation a * x - b, positive when violated.
+  double violation(const gtsam::VectorValues &x) const {
+    return (a * x.at(key))(0) - b;
+  }
+};
+
+/**
+ * WholeBodyController solves, at each control tick, a small QP over joint
+ * and link accelerations, joint torques, joint wrenches and contact wrenches:
+ *  - equality constraints: the exact linear dynamics at the measured state
+ *    (DynamicsGraph::linearDynamicsGraph), zero contact point acceleration
+ *    and zero contact moment;
+ *  - objectives: weighted link and joint acceleration tasks, and
+ *    regularization of torques, joint accelerations and contact wrenches;
+ *  - inequality constraints: torque limits, unilateral contact and a
+ *    friction pyramid, handled by a primal active set.
+ *
+ * The factor graph structure is the same at every tick, so the elimination
+ * ordering is computed once and cached. The active set of the previous tick
+ * is used as warm start. Active inequalities are pinned by stiff priors, and
+ * the sign of the remaining residual is the sign of their multiplier: a
+ * constraint is released when the solution pulls away from it.
+ */
+class WholeBodyController {
+ private:
+  /// Weighted least-squares task x_key = b.
+  struct Task {
+    gtsam::Vector b;
+    gtsam::SharedDiagonal model;
+  };
+
+  Robot robot_;
+  PointOnLinks contact_points_;
+  WholeBodyControllerParams params_;
+  int k_;
+  DynamicsGraph graph_builder_;
+  std::map<gtsam::Key, Task> tasks_;
+
+  // Cached structure and warm start.
+  gtsam::SharedDiagonal active_model_;
+  std::optional<gtsam::Ordering> ordering_;
+  std::vector<bool> active_;
+  size_t iterations_ = 0;
+
+ public:
+  /**
+   * Constructor.
+   * @param robot the robot.
+   * @param contact_points contact points held fixed on the ground.
+   * @param params controller parameters.
+   * @param k time index of the variables.
+   */
+  WholeBodyController(
+      const Robot &robot, const PointOnLinks &contact_points,
+      const WholeBodyControllerParams &params = WholeBodyControllerParams(),
+      int k = 0);
+
+  /// Change the contact points, e.g., at a contact switch.
+  void setContactPoints(const PointOnLinks &contact_points);
+
+  /**
+   * Set the desired twist acceleration of a link, in its CoM frame.
+   * @param link_name name of the link.
+   * @param desired_accel desired twist acceleration.
+   * @param sigma standard deviation of the task.
+   */
+  void setLinkAccelTask(const std::string &link_name,
+                        const gtsam::Vector6 &desired_accel, double sigma);
+
+  /**
+   * Set the desired acceleration of a joint.
+   * @param joint_name name of the joint.
+   * @param desired_accel desired joint acceleration.
+   * @param sigma standard deviation of the task.
+   */
+  void setJointAccelTask(const std::string &joint_name, double desired_accel,
+                         double sigma);
+
+  /// Remove all tasks.
+  void clearTasks();
+
+  /**
+   * Equality constraints and objectives at the given state.
+   * @param state poses, twists, joint angles and velocities at time k.
+   */
+  gtsam::GaussianFactorGraph qp(const gtsam::Values &state) const;
+
+  /// Torque limit, unilateral contact and friction constraints at the state.
+  std::vector<LinearInequality> inequalities(const gtsam::Values &state) const;
+
+  /**
+   * Solve the QP at the given state.
+   * @param state poses, twists, joint angles and velocities at time k.
+   * @return accelerations, torques and wrenches at time k.
+   */
+  gtsam::VectorValues compute(const gtsam::Values &state);
+
+  /// Number of active inequality constraints after the last solve.
+  size_t numActive() const;
+
+  /// Number of active set iterations of the last solve.
+  size_t iterations() const { return iterations_; }
+
+  /// Return the contact points.
+  const PointOnLinks &contactPoints() const { return contact_points_; }
+
+ private:
+  /// Drop cached structure, when the set of variables changes.
+  void resetCache();
+};
+
+}  // namespace gtdynamics
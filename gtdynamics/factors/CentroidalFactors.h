@@ -0,0 +1,362 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  CentroidalFactors.h
+ * @brief Factors of the reduced centroidal dynamics formulation.
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/base/Vector.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * CentroidalMomentumFactor is an Euler collocation factor on the centroidal
+ * momentum h = [k; l] (angular momentum about the CoM, linear momentum, both
+ * in the world frame), driven by gravity and point contact forces:
+ *
+ *   k1 = k0 + dt * sum_c (p_c - com) x f_c
+ *   l1 = l0 + dt * (sum_c f_c + m * g)
+ *
+ * Keys are h0, h1, the centroidal pose at the first step (whose translation is
+ * the CoM), and a (contact point, contact force) pair per active contact.
+ */
+class CentroidalMomentumFactor : public gtsam::NoiseModelFactor {
+ private:
+  using This = CentroidalMomentumFactor;
+  using Base = gtsam::NoiseModelFactor;
+
+  double dt_;
+  gtsam::Vector3 mg_;  // mass times gravity
+
+  static gtsam::KeyVector MakeKeys(gtsam::Key h0_key, gtsam::Key h1_key,
+                                   gtsam::Key pose_key,
+                                   const gtsam::KeyVector &point_keys,
+                                   const gtsam::KeyVector &force_keys) {
+    gtsam::KeyVector keys{h0_key, h1_key, pose_key};
+    for (size_t c = 0; c < point_keys.size(); c++) {
+      keys.push_back(point_keys[c]);
+      keys.push_back(force_keys[c]);
+    }
+    return keys;
+  }
+
+ public:
+  /**
+   * Constructor.
+   * @param h0_key momentum at step k.
+   * @param h1_key momentum at step k+1.
+   * @param pose_key centroidal pose at step k.
+   * @param point_keys world positions of the active contact points.
+   * @param force_keys world contact forces, in the same order.
+   * @param cost_model noise model of dimension 6.
+   * @param mass total mass of the robot.
+   * @param gravity gravity vector.
+   * @param dt duration of the time step.
+   */
+  CentroidalMomentumFactor(
+      gtsam::Key h0_key, gtsam::Key h1_key, gtsam::Key pose_key,
+      const gtsam::KeyVector &point_keys, const gtsam::KeyVector &force_keys,
+      const gtsam::noiseModel::Base::shared_ptr &cost_model, double mass,
+      const gtsam::Vector3 &gravity, double dt)
+      : Base(cost_model,
+             MakeKeys(h0_key, h1_key, pose_key, point_keys, force_keys)),
+        dt_(dt),
+        mg_(mass * gravity) {
+    if (point_keys.size() != force_keys.size()) {
+      throw std::invalid_argument(
+          "CentroidalMomentumFactor: need one force per contact point.");
+    }
+  }
+
+  virtual ~CentroidalMomentumFactor() {}
+
+  /// Number of active contacts.
+  size_t numContacts() const { return (size() - 3) / 2; }
+
+  gtsam::Vector unwhitenedError(
+      const gtsam::Values &x,
+      gtsam::OptionalMatrixVecType H = nullptr) const override {
+    const gtsam::Vector6 h0 = x.at<gtsam::Vector6>(keys_[0]);
+    const gtsam::Vector6 h1 = x.at<gtsam::Vector6>(keys_[1]);
+    gtsam::Matrix36 H_com_pose;
+    const gtsam::Point3 com =
+        x.at<gtsam::Pose3>(keys_[2]).translation(H ? &H_com_pose : nullptr);
+
+    gtsam::Vector6 error = h1 - h0;
+    error.tail<3>() -= dt_ * mg_;
+    gtsam::Matrix3 H_k_com = gtsam::Z_3x3;
+    if (H) H->resize(size());
+    for (size_t c = 0; c < numContacts(); c++) {
+      const gtsam::Point3 p = x.at<gtsam::Point3>(keys_[3 + 2 * c]);
+      const gtsam::Vector3 f = x.at<gtsam::Vector3>(keys_[4 + 2 * c]);
+      const gtsam::Vector3 r = p - com;
+      error.head<3>() -= dt_ * r.cross(f);
+      error.tail<3>() -= dt_ * f;
+      if (H) {
+        // d(r x f)/dp = -[f]x, d(r x f)/df = [r]x.
+        const gtsam::Matrix3 f_hat = gtsam::skewSymmetric(f);
+        gtsam::Matrix63 H_p, H_f;
+        H_p << dt_ * f_hat, gtsam::Z_3x3;
+        H_f << -dt_ * gtsam::skewSymmetric(r), -dt_ * gtsam::I_3x3;
+        (*H)[3 + 2 * c] = H_p;
+        (*H)[4 + 2 * c] = H_f;
+        H_k_com -= dt_ * f_hat;
+      }
+    }
+    if (H) {
+      (*H)[0] = -gtsam::I_6x6;
+      (*H)[1] = gtsam::I_6x6;
+      gtsam::Matrix6 H_pose = gtsam::Z_6x6;
+      H_pose.topRows<3>() = H_k_com * H_com_pose;
+      (*H)[2] = H_pose;
+    }
+    return error;
+  }
+
+  //// @return a deep copy of this factor
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    return std::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
+  /// print contents
+  void print(const std::string &s = "",
+             const gtsam::KeyFormatter &keyFormatter =
+                 gtsam::DefaultKeyFormatter) const override {
+    std::cout << (s.empty() ? "" : s + " ") << "CentroidalMomentumFactor"
+              << std::endl;
+    Base::print("", keyFormatter);
+  }
+
+ private:
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &boost::serialization::make_nvp(
+        "NoiseModelFactor", boost::serialization::base_object<Base>(*this));
+    ar &BOOST_SERIALIZATION_NVP(dt_);
+    ar &BOOST_SERIALIZATION_NVP(mg_);
+  }
+#endif
+};
+
+/**
+ * CentroidalKinematicsFactor is an Euler collocation factor integrating the
+ * centroidal pose (base orientation, CoM position) with the velocities implied
+ * by the centroidal momentum:
+ *
+ *   R1 = R0 * Exp(dt * I^-1 * R0^T k0),   c1 = c0 + dt * l0 / m,
+ *
+ * where I is the locked rotational inertia in the centroidal frame.
+ */
+class CentroidalKinematicsFactor
+    : public gtsam::NoiseModelFactorN<gtsam::Pose3, gtsam::Pose3,
+                                      gtsam::Vector6> {
+ private:
+  using This = CentroidalKinematicsFactor;
+  using Base =
+      gtsam::NoiseModelFactorN<gtsam::Pose3, gtsam::Pose3, gtsam::Vector6>;
+
+  double dt_;
+  double inv_mass_;
+  gtsam::Matrix3 inv_inertia_;
+
+ public:
+  /**
+   * Constructor.
+   * @param pose0_key centroidal pose at step k.
+   * @param pose1_key centroidal pose at step k+1.
+   * @param h0_key centroidal momentum at step k.
+   * @param cost_model noise model of dimension 6.
+   * @param mass total mass of the robot.
+   * @param inertia locked rotational inertia in the centroidal frame.
+   * @param dt duration of the time step.
+   */
+  CentroidalKinematicsFactor(
+      gtsam::Key pose0_key, gtsam::Key pose1_key, gtsam::Key h0_key,
+      const gtsam::noiseModel::Base::shared_ptr &cost_model, double mass,
+      const gtsam::Matrix3 &inertia, double dt)
+      : Base(cost_model, pose0_key, pose1_key, h0_key),
+        dt_(dt),
+        inv_mass_(1.0 / mass),
+        inv_inertia_(inertia.inverse()) {}
+
+  virtual ~CentroidalKinematicsFactor() {}
+
+  /**
+   * Evaluate the rotation (tangent space) and CoM position errors.
+   * @param pose0 centroidal pose at step k.
+   * @param pose1 centroidal pose at step k+1.
+   * @param h0 centroidal momentum at step k.
+   */
+  gtsam::Vector evaluateError(
+      const gtsam::Pose3 &pose0, const gtsam::Pose3 &pose1,
+      const gtsam::Vector6 &h0, gtsam::OptionalMatrixType H_pose0 = nullptr,
+      gtsam::OptionalMatrixType H_pose1 = nullptr,
+      gtsam::OptionalMatrixType H_h0 = nullptr) const override {
+    gtsam::Matrix36 H_R0, H_R1, H_c0, H_c1;
+    const gtsam::Rot3 R0 = pose0.rotation(H_R0);
+    const gtsam::Rot3 R1 = pose1.rotation(H_R1);
+    const gtsam::Point3 c0 = pose0.translation(H_c0);
+    const gtsam::Point3 c1 = pose1.translation(H_c1);
+
+    // Rotation increment from body angular velocity.
+    gtsam::Matrix3 H_kb_R0, H_kb_k, H_E_phi, H_Rp_R0, H_Rp_E, H_D_Rp, H_D_R1,
+        H_e_D;
+    const gtsam::Vector3 k_body = R0.unrotate(h0.head<3>(), H_kb_R0, H_kb_k);
+    const gtsam::Vector3 phi = dt_ * inv_inertia_ * k_body;
+    const gtsam::Rot3 E = gtsam::Rot3::Expmap(phi, H_E_phi);
+    const gtsam::Rot3 R_pred = R0.compose(E, H_Rp_R0, H_Rp_E);
+    const gtsam::Rot3 D = R_pred.between(R1, H_D_Rp, H_D_R1);
+    const gtsam::Vector3 error_R = gtsam::Rot3::Logmap(D, H_e_D);
+
+    gtsam::Vector6 error;
+    error << error_R, c1 - c0 - dt_ * inv_mass_ * h0.tail<3>();
+
+    const gtsam::Matrix3 H_e_Rp = H_e_D * H_D_Rp;
+    const gtsam::Matrix3 H_e_kb = H_e_Rp * H_Rp_E * H_E_phi * dt_ * inv_inertia_;
+    if (H_pose0) {
+      H_pose0->resize(6, 6);
+      *H_pose0 << (H_e_Rp * H_Rp_R0 + H_e_kb * H_kb_R0) * H_R0, -H_c0;
+    }
+    if (H_pose1) {
+      H_pose1->resize(6, 6);
+      *H_pose1 << H_e_D * H_D_R1 * H_R1, H_c1;
+    }
+    if (H_h0) {
+      H_h0->resize(6, 6);
+      *H_h0 << H_e_kb * H_kb_k, gtsam::Z_3x3, gtsam::Z_3x3,
+          -dt_ * inv_mass_ * gtsam::I_3x3;
+    }
+    return error;
+  }
+
+  //// @return a deep copy of this factor
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    return std::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
+  /// print contents
+  void print(const std::string &s = "",
+             const gtsam::KeyFormatter &keyFormatter =
+                 gtsam::DefaultKeyFormatter) const override {
+    std::cout << (s.empty() ? "" : s + " ") << "CentroidalKinematicsFactor"
+              << std::endl;
+    Base::print("", keyFormatter);
+  }
+
+ private:
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &boost::serialization::make_nvp(
+        "NoiseModelFactorN", boost::serialization::base_object<Base>(*this));
+    ar &BOOST_SERIALIZATION_NVP(dt_);
+    ar &BOOST_SERIALIZATION_NVP(inv_mass_);
+    ar &BOOST_SERIALIZATION_NVP(inv_inertia_);
+  }
+#endif
+};
+
+/**
+ * ForceFrictionConeFactor is a unary factor which penalizes a world-frame
+ * point contact force leaving the friction cone of a flat ground, including
+ * pulling on the ground. Error is [max(0, fx^2 + fy^2 - mu^2 fz^2),
+ * max(0, -fz)], for z along -gravity.
+ */
+class ForceFrictionConeFactor : public gtsam::NoiseModelFactorN<gtsam::Vector3> {
+ private:
+  using This = ForceFrictionConeFactor;
+  using Base = gtsam::NoiseModelFactorN<gtsam::Vector3>;
+
+  double mu_squared_;
+  gtsam::Vector3 up_;  // unit vector opposite to gravity
+
+ public:
+  /**
+   * Constructor.
+   * @param force_key world contact force.
+   * @param cost_model noise model of dimension 2.
+   * @param mu static friction coefficient.
+   * @param gravity gravity vector, defines the ground normal.
+   */
+  ForceFrictionConeFactor(gtsam::Key force_key,
+                          const gtsam::noiseModel::Base::shared_ptr &cost_model,
+                          double mu, const gtsam::Vector3 &gravity)
+      : Base(cost_model, force_key),
+        mu_squared_(mu * mu),
+        up_(-gravity.normalized()) {}
+
+  virtual ~ForceFrictionConeFactor() {}
+
+  gtsam::Vector evaluateError(
+      const gtsam::Vector3 &f,
+      gtsam::OptionalMatrixType H_f = nullptr) const override {
+    const double f_n = up_.dot(f);
+    const gtsam::Vector3 f_t = f - f_n * up_;
+    const double cone = f_t.squaredNorm() - mu_squared_ * f_n * f_n;
+
+    gtsam::Vector2 error(std::max(0.0, cone), std::max(0.0, -f_n));
+    if (H_f) {
+      H_f->setZero(2, 3);
+      if (cone > 0) {
+        H_f->row(0) = 2 * f_t.transpose() - 2 * mu_squared_ * f_n *
+                                                up_.transpose();
+      }
+      if (f_n < 0) H_f->row(1) = -up_.transpose();
+    }
+    return error;
+  }
+
+  //// @return a deep copy of this factor
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    return std::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
+  /// print contents
+  void print(const std::string &s = "",
+             const gtsam::KeyFormatter &keyFormatter =
+                 gtsam::DefaultKeyFormatter) const override {
+    std::cout << (s.empty() ? "" : s + " ") << "ForceFrictionConeFactor"
+              << std::endl;
+    Base::print("", keyFormatter);
+  }
+
+ private:
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &boost::serialization::make_nvp(
+        "NoiseModelFactorN", boost::serialization::base_object<Base>(*this));
+    ar &BOOST_SERIALIZATION_NVP(mu_squared_);
+    ar &BOOST_SERIALIZATION_NVP(up_);
+  }
+#endif
+};
+
+}  // namespace gtdynamics
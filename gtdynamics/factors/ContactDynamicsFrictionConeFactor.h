@@ -13,22 +13,31 @@
 
 #pragma once
 
+#include <gtdynamics/utils/Heightmap.h>
 #include <gtdynamics/utils/utils.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 
+#include <cmath>
 #include <iostream>
 #include <optional>
 #include <string>
 #include <vector>
 
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/version.hpp>
+#endif
+
 namespace gtdynamics {
 
 /**
  * ContactDynamicsFrictionConeFactor is binary nonlinear factor which enforces
- * that the linear contact force lies within a friction cone.
+ * that the linear contact force lies within a friction cone. The cone is
+ * around the up axis for flat ground, or around the terrain normal below the
+ * contact point when given a heightmap.
  */
 class ContactDynamicsFrictionConeFactor
     : public gtsam::NoiseModelFactorN<gtsam::Pose3, gtsam::Vector6> {
@@ -36,19 +45,18 @@ class ContactDynamicsFrictionConeFactor
   using This = ContactDynamicsFrictionConeFactor;
   using Base = gtsam::NoiseModelFactorN<gtsam::Pose3, gtsam::Vector6>;
 
-  int up_axis_;  // Which axis is up (assuming flat ground)? {0: x, 1: y, 2: z}.
-  double mu_prime_;  // static friction coefficient squared.
+  gtsam::Vector3 up_ = gtsam::Vector3::UnitZ();  // Up axis for flat ground.
+  double mu_prime_ = 0.0;  // static friction coefficient squared.
+  HeightmapSharedPtr terrain_;  // Rough terrain, if any.
+  gtsam::Point3 comPc_ = gtsam::Point3::Zero();  // Contact point, CoM frame.
   const gtsam::Matrix36 H_wrench_ = (gtsam::Matrix(3, 6) << 0, 0, 0, 1, 0, 0, 0,
                                      0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1)
                                         .finished();
-  const gtsam::Matrix33 H_x_ =
-      (gtsam::Matrix(3, 3) << 1, 0, 0, 0, 0, 0, 0, 0, 0).finished();
-  const gtsam::Matrix33 H_y_ =
-      (gtsam::Matrix(3, 3) << 0, 0, 0, 0, 1, 0, 0, 0, 0).finished();
-  const gtsam::Matrix33 H_z_ =
-      (gtsam::Matrix(3, 3) << 0, 0, 0, 0, 0, 0, 0, 0, 1).finished();
 
  public:
+  /** default constructor - only use for serialization */
+  ContactDynamicsFrictionConeFactor() {}
+
   /**
    * Contact dynamics factor for zero moment at contact.
    *
@@ -63,13 +71,33 @@ class ContactDynamicsFrictionConeFactor
       const gtsam::Vector3 &gravity)
       : Base(cost_model, pose_key, contact_wrench_key), mu_prime_(mu * mu) {
     if (gravity[0] != 0)
-      up_axis_ = 0;  // x.
+      up_ = gtsam::Vector3::UnitX();
     else if (gravity[1] != 0)
-      up_axis_ = 1;  // y.
+      up_ = gtsam::Vector3::UnitY();
     else
-      up_axis_ = 2;  // z.
+      up_ = gtsam::Vector3::UnitZ();
   }
 
+  /**
+   * Friction cone around the normal of rough terrain.
+   *
+   * @param pose_key Key corresponding to the link's CoM pose.
+   * @param contact_wrench_key Key corresponding to this link's contact wrench.
+   * @param cost_model Noise model for this factor.
+   * @param mu Static friction coefficient.
+   * @param terrain Heightmap of the terrain in the world frame.
+   * @param comPc Contact point in the link CoM frame.
+   */
+  ContactDynamicsFrictionConeFactor(
+      gtsam::Key pose_key, gtsam::Key contact_wrench_key,
+      const gtsam::noiseModel::Base::shared_ptr &cost_model, double mu,
+      const HeightmapSharedPtr &terrain, const gtsam::Point3 &comPc)
+      : Base(cost_model, pose_key, contact_wrench_key),
+        up_(gtsam::Vector3::UnitZ()),
+        mu_prime_(mu * mu),
+        terrain_(terrain),
+        comPc_(comPc) {}
+
   virtual ~ContactDynamicsFrictionConeFactor() {}
 
   /**
@@ -87,37 +115,32 @@ class ContactDynamicsFrictionConeFactor
     gtsam::Matrix36 H_p;
     gtsam::Vector3 f_s = pose.rotation(H_p) * f_c;
 
-    // Compute the squared force values.
-    gtsam::Matrix A = f_s.transpose() * H_x_;
-    gtsam::Matrix B = f_s.transpose() * H_y_;
-    gtsam::Matrix C = f_s.transpose() * H_z_;
-
-    if (up_axis_ == 0)
-      A *= -mu_prime_;
-    else if (up_axis_ == 1)
-      B *= -mu_prime_;
-    else
-      C *= -mu_prime_;
-
-    // a = f_x^2, b = f_z^2, c = f_z^2.
-    gtsam::Matrix a = A * f_s;
-    gtsam::Matrix b = B * f_s;
-    gtsam::Matrix c = C * f_s;
+    // Normal of the ground below the contact point.
+    gtsam::Vector3 n = up_;
+    gtsam::Matrix36 H_point;
+    gtsam::Matrix33 H_n;
+    if (terrain_) {
+      n = terrain_->normal(
+          pose.transformFrom(comPc_, H_pose ? &H_point : nullptr),
+          H_pose ? &H_n : nullptr);
+    }
 
-    gtsam::Matrix resultant = a + b + c;
-    gtsam::Vector error;
+    // Squared tangential force minus mu^2 times squared normal force,
+    // f' (I - (1 + mu^2) n n') f.
+    const double f_n = n.dot(f_s);
+    const double resultant = f_s.squaredNorm() - (1 + mu_prime_) * f_n * f_n;
 
     // Ramp function.
-    if (resultant(0, 0) > 0)
-      error = resultant;
-    else
-      error = (gtsam::Vector(1) << 0).finished();
+    const bool active = resultant > 0;
+    gtsam::Vector error = (gtsam::Vector(1) << (active ? resultant : 0))
+                              .finished();
 
     // Compute the gradients based on whether or not the inequality constraint
     // is active.
-    gtsam::Matrix H_f_s = (2 * A + 2 * B + 2 * C);
+    gtsam::Matrix13 H_f_s =
+        2 * f_s.transpose() - 2 * (1 + mu_prime_) * f_n * n.transpose();
     if (H_contact_wrench) {
-      if (resultant(0, 0) > 0) {  // Active.
+      if (active) {  // Active.
         gtsam::Matrix H_f_c = H_f_s * pose.rotation().matrix();
         *H_contact_wrench = H_f_c * H_wrench_;
       } else {  // Inactive.
@@ -127,11 +150,16 @@ class ContactDynamicsFrictionConeFactor
     }
 
     if (H_pose) {
-      if (resultant(0, 0) > 0) {  // Active.
+      if (active) {  // Active.
         gtsam::Matrix33 H_r = pose.rotation().matrix() *
                               gtsam::skewSymmetric(-f_c(0), -f_c(1), -f_c(2));
-        gtsam::Matrix H_rot = gtsam::Matrix(H_f_s * H_r);
-        *H_pose = H_rot * H_p;
+        gtsam::Matrix16 H = H_f_s * H_r * H_p;
+        if (terrain_) {
+          const gtsam::Matrix13 H_normal =
+              -2 * (1 + mu_prime_) * f_n * f_s.transpose();
+          H += H_normal * H_n * H_point;
+        }
+        *H_pose = H;
       } else {  // Inactive.
         *H_pose = (gtsam::Matrix(1, 6) << 0, 0, 0, 0, 0, 0).finished();
       }
@@ -140,6 +168,21 @@ class ContactDynamicsFrictionConeFactor
     return error;
   }
 
+  /// Return the heightmap of the terrain, null for flat ground.
+  const HeightmapSharedPtr &terrain() const { return terrain_; }
+
+  /// Check equality, including the terrain.
+  bool equals(const gtsam::NonlinearFactor &other,
+              double tol = 1e-9) const override {
+    const This *e = dynamic_cast<const This *>(&other);
+    if (!e || !Base::equals(other, tol)) return false;
+    if (bool(terrain_) != bool(e->terrain_)) return false;
+    return gtsam::equal_with_abs_tol(up_, e->up_, tol) &&
+           std::abs(mu_prime_ - e->mu_prime_) <= tol &&
+           (!terrain_ || terrain_->equals(*e->terrain_, tol)) &&
+           gtsam::traits<gtsam::Point3>::Equals(comPc_, e->comPc_, tol);
+  }
+
   //// @return a deep copy of this factor
   gtsam::NonlinearFactor::shared_ptr clone() const override {
     return std::static_pointer_cast<gtsam::NonlinearFactor>(
@@ -162,8 +205,19 @@ class ContactDynamicsFrictionConeFactor
   void serialize(ARCHIVE const &ar, const unsigned int version) {
     ar &boost::serialization::make_nvp(
         "NoiseModelFactorN", boost::serialization::base_object<Base>(*this));
+    // Version 1: friction cone and terrain.
+    if (version >= 1) {
+      ar &BOOST_SERIALIZATION_NVP(up_);
+      ar &BOOST_SERIALIZATION_NVP(mu_prime_);
+      ar &BOOST_SERIALIZATION_NVP(terrain_);
+      ar &BOOST_SERIALIZATION_NVP(comPc_);
+    }
   }
 #endif
 };
 
 }  // namespace gtdynamics
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+BOOST_CLASS_VERSION(gtdynamics::ContactDynamicsFrictionConeFactor, 1)
+#endif
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/utils/SharedParameters.h>
 #include <gtdynamics/utils/utils.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
@@ -40,10 +41,7 @@ inline gtsam::Vector3_ ContactDynamicsMomentConstraint(
   gtsam::Matrix36 H =
       H_contact_wrench * cTcom.inverse().AdjointMap().transpose();
   gtsam::Vector6_ contact_wrench(contact_wrench_key);
-  const std::function<gtsam::Vector3(gtsam::Vector6)> f =
-      [H](const gtsam::Vector6 &F) { return H * F; };
-  gtsam::Vector3_ error = gtsam::linearExpression(f, contact_wrench, H);
-  return error;
+  return SharedLinearExpression(H, contact_wrench);
 }
 
 /**
@@ -56,9 +54,6 @@ class ContactDynamicsMomentFactor
   using This = ContactDynamicsMomentFactor;
   using Base = gtsam::ExpressionFactor<gtsam::Vector3>;
 
-  gtsam::Pose3 cTcom_;
-  gtsam::Matrix36 H_contact_wrench_;
-
  public:
   /**
    * Contact dynamics factor for zero moment at contact.
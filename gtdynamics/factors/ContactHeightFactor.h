@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/utils/Heightmap.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
 #include <gtsam/geometry/Pose3.h>
@@ -40,10 +41,26 @@ inline gtsam::Double_ ContactHeightConstraint(
   return error;
 }
 
+/**
+ * ContactHeightConstraint on rough terrain: the height of the contact point
+ * above a heightmap, along the world z-axis.
+ */
+inline gtsam::Double_ ContactHeightConstraint(
+    gtsam::Key pose_key, const gtsam::Point3 &comPc,
+    const HeightmapSharedPtr &terrain) {
+  gtsam::Pose3_ sTl(pose_key);
+  gtsam::Point3_ sPc = gtsam::transformFrom(sTl, gtsam::Point3_(comPc));
+  return gtsam::Double_(
+      [terrain](const gtsam::Point3 &point, gtsam::OptionalJacobian<1, 3> H) {
+        return terrain->heightAbove(point, H);
+      },
+      sPc);
+}
+
 /**
  * ContactHeightFactor is a one-way nonlinear factor which enforces a
  * known ground plane height for the contact point. This factor assumes that the
- * ground is flat and level.
+ * ground is flat and level, unless it is given a heightmap of the terrain.
  */
 class ContactHeightFactor : public gtsam::ExpressionFactor<double> {
  private:
@@ -70,6 +87,21 @@ class ContactHeightFactor : public gtsam::ExpressionFactor<double> {
              ContactHeightConstraint(pose_key, comPc, gravity,
                                      ground_plane_height)) {}
 
+  /**
+   * Factor for link end to remain in contact with rough terrain.
+   *
+   * @param pose_key The key corresponding to the link's CoM pose.
+   * @param cost_model Noise model associated with this factor.
+   * @param comPc Static transform from point of contact to link CoM.
+   * @param terrain Heightmap of the terrain in the world frame.
+   */
+  ContactHeightFactor(gtsam::Key pose_key,
+                      const gtsam::noiseModel::Base::shared_ptr &cost_model,
+                      const gtsam::Point3 &comPc,
+                      const HeightmapSharedPtr &terrain)
+      : Base(cost_model, 0.0,
+             ContactHeightConstraint(pose_key, comPc, terrain)) {}
+
   virtual ~ContactHeightFactor() {}
 
   //// @return a deep copy of this factor
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/utils/SharedParameters.h>
 #include <gtdynamics/utils/utils.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
@@ -39,10 +40,7 @@ inline gtsam::Vector3_ ContactKinematicsAccelConstraint(
 
   gtsam::Matrix36 H = H_acc * cTcom.AdjointMap();
   gtsam::Vector6_ accel(accel_key);
-  const std::function<gtsam::Vector3(gtsam::Vector6)> f =
-      [H](const gtsam::Vector6 &A) { return H * A; };
-  gtsam::Vector3_ error = gtsam::linearExpression(f, accel, H);
-  return error;
+  return SharedLinearExpression(H, accel);
 }
 
 /**
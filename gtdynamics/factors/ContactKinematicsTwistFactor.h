@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/utils/SharedParameters.h>
 #include <gtdynamics/utils/utils.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
@@ -39,10 +40,7 @@ inline gtsam::Vector3_ ContactKinematicsTwistConstraint(
 
   gtsam::Matrix36 H = H_vel * cTcom.AdjointMap();
   gtsam::Vector6_ twist(twist_key);
-  const std::function<gtsam::Vector3(gtsam::Vector6)> f =
-      [H](const gtsam::Vector6 &V) { return H * V; };
-  gtsam::Vector3_ error = gtsam::linearExpression(f, twist, H);
-  return error;
+  return SharedLinearExpression(H, twist);
 }
 
 /**
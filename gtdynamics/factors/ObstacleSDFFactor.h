@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ObstacleSDFFactor.h
+ * @brief Obstacle avoidance factor on a link pose, using a precomputed signed
+ * distance field and a sphere approximation of the link.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Joint.h>
+#include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/utils/SignedDistanceField.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/nonlinear/NonlinearFactor.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * @fn Approximate a link by spheres of equal radius along the segments from
+ * its CoM to each of its joints, since links carry no collision geometry.
+ * @param link the link.
+ * @param radius radius of the spheres.
+ * @param spheres_per_segment number of spheres on each segment, besides the
+ * one at the CoM.
+ */
+inline LinkSpheres LinkSphereApproximation(const LinkSharedPtr &link,
+                                           double radius,
+                                           size_t spheres_per_segment = 2) {
+  LinkSpheres spheres{{gtsam::Point3::Zero(), radius}};
+  for (auto &&joint : link->joints()) {
+    // Joint origin in the link CoM frame.
+    const gtsam::Pose3 lMj = joint->child() == link ? joint->jMc().inverse()
+                                                    : joint->jMp().inverse();
+    for (size_t s = 1; s <= spheres_per_segment; s++) {
+      spheres.push_back(
+          {lMj.translation() * double(s) / spheres_per_segment, radius});
+    }
+  }
+  return spheres;
+}
+
+/**
+ * ObstacleSDFFactor is a unary factor on a link CoM pose, with one hinge loss
+ * per sphere of the link: the error of a sphere is epsilon + radius - d when
+ * the distance d from its center to the nearest obstacle is less than
+ * epsilon + radius, and zero otherwise. Distances are looked up in a
+ * precomputed signed distance field, shared between factors.
+ */
+class ObstacleSDFFactor : public gtsam::NoiseModelFactorN<gtsam::Pose3> {
+ private:
+  using This = ObstacleSDFFactor;
+  using Base = gtsam::NoiseModelFactorN<gtsam::Pose3>;
+
+  SignedDistanceFieldSharedPtr sdf_;
+  LinkSpheres spheres_;
+  double epsilon_;
+
+ public:
+  /**
+   * Constructor.
+   * @param pose_key key of the link CoM pose.
+   * @param cost_model noise model, of dimension spheres.size().
+   * @param sdf signed distance field of the obstacles.
+   * @param spheres sphere approximation of the link.
+   * @param epsilon obstacle clearance.
+   */
+  ObstacleSDFFactor(gtsam::Key pose_key,
+                    const gtsam::noiseModel::Base::shared_ptr &cost_model,
+                    const SignedDistanceFieldSharedPtr &sdf,
+                    const LinkSpheres &spheres, double epsilon)
+      : Base(cost_model, pose_key),
+        sdf_(sdf),
+        spheres_(spheres),
+        epsilon_(epsilon) {}
+
+  virtual ~ObstacleSDFFactor() {}
+
+  /**
+   * Evaluate the hinge losses of the spheres.
+   * @param wTl link CoM pose.
+   * @param H_pose optional Jacobian w.r.t. the pose.
+   */
+  gtsam::Vector evaluateError(
+      const gtsam::Pose3 &wTl,
+      gtsam::OptionalMatrixType H_pose = nullptr) const override {
+    gtsam::Vector error = gtsam::Vector::Zero(spheres_.size());
+    if (H_pose) *H_pose = gtsam::Matrix::Zero(spheres_.size(), 6);
+    for (size_t s = 0; s < spheres_.size(); s++) {
+      gtsam::Matrix36 H_point;
+      gtsam::Matrix13 H_distance;
+      const gtsam::Point3 center =
+          wTl.transformFrom(spheres_[s].center, H_pose ? &H_point : nullptr);
+      const double d =
+          sdf_->distance(center, H_pose ? &H_distance : nullptr);
+      const double clearance = epsilon_ + spheres_[s].radius;
+      if (d >= clearance) continue;
+      error(s) = clearance - d;
+      if (H_pose) H_pose->row(s) = -H_distance * H_point;
+    }
+    return error;
+  }
+
+  /// Return the signed distance field.
+  const SignedDistanceFieldSharedPtr &sdf() const { return sdf_; }
+
+  /// Return the spheres.
+  const LinkSpheres &spheres() const { return spheres_; }
+
+  /// Return the obstacle clearance.
+  double epsilon() const { return epsilon_; }
+
+  //// @return a deep copy of this factor
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    return std::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
+  /// print contents
+  void print(const std::string &s = "",
+             const gtsam::KeyFormatter &keyFormatter =
+                 gtsam::DefaultKeyFormatter) const override {
+    std::cout << s << "obstacle SDF factor, " << spheres_.size()
+              << " spheres, epsilon " << epsilon_ << std::endl;
+    Base::print("", keyFormatter);
+  }
+
+ private:
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &boost::serialization::make_nvp(
+        "NoiseModelFactorN", boost::serialization::base_object<Base>(*this));
+    ar &BOOST_SERIALIZATION_NVP(sdf_);
+    ar &BOOST_SERIALIZATION_NVP(spheres_);
+    ar &BOOST_SERIALIZATION_NVP(epsilon_);
+  }
+#endif
+};
+
+}  // namespace gtdynamics
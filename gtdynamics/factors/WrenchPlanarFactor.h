@@ -30,11 +30,10 @@
 namespace gtdynamics {
 
 /**
- * Constraint that enforces the wrench to be planar.
+ * Constraint that enforces a wrench expression to be planar.
  */
 inline gtsam::Vector3_ WrenchPlanarConstraint(gtsam::Vector3 planar_axis,
-                                              const JointConstSharedPtr &joint,
-                                              size_t k = 0) {
+                                              const gtsam::Vector6_ &wrench) {
   gtsam::Matrix36 H_wrench;
   if (planar_axis[0] == 1) {  // x axis
     H_wrench << 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0;
@@ -44,8 +43,6 @@ inline gtsam::Vector3_ WrenchPlanarConstraint(gtsam::Vector3 planar_axis,
     H_wrench << 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1;
   }
 
-  auto wrench_key = WrenchKey(joint->child()->id(), joint->id(), k);
-  gtsam::Vector6_ wrench(wrench_key);
   // TODO(yetong): maybe can be done easily with a functor, and/or
   // linearexpression (re-written with functor), and maybe this same pattern
   // could be used to clean up scalar multiply in Expression.h
@@ -55,6 +52,16 @@ inline gtsam::Vector3_ WrenchPlanarConstraint(gtsam::Vector3 planar_axis,
   return error;
 }
 
+/**
+ * Constraint that enforces the wrench to be planar.
+ */
+inline gtsam::Vector3_ WrenchPlanarConstraint(gtsam::Vector3 planar_axis,
+                                              const JointConstSharedPtr &joint,
+                                              size_t k = 0) {
+  auto wrench_key = WrenchKey(joint->child()->id(), joint->id(), k);
+  return WrenchPlanarConstraint(planar_axis, gtsam::Vector6_(wrench_key));
+}
+
 /**
  * WrenchPlanarFactor is a one-way nonlinear factor which enforces the
  * wrench to be planar
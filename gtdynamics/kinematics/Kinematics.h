@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <gtdynamics/factors/ObstacleSDFFactor.h>
 #include <gtdynamics/optimizer/Optimizer.h>
 #include <gtdynamics/universal_robot/Robot.h>
 #include <gtdynamics/utils/Interval.h>
@@ -71,6 +72,10 @@ struct KinematicsParameters : public OptimizationParameters {
   const gtsam::SharedNoiseModel p_cost_model,  // pose factor
       g_cost_model,                            // goal point
       prior_q_cost_model;                      // joint angle prior factor
+  double obstacle_epsilon = kObstacleEpsilon;  // obstacle clearance
+  double obstacle_sigma = kObstacleSigma;      // obstacle cost model sigma
+  SignedDistanceFieldSharedPtr obstacle_sdf;   // obstacles, none if null
+  RobotSpheres obstacle_spheres;  // link spheres kept clear of obstacles
 
   // TODO(yetong): replace noise model with tolerance.
   KinematicsParameters()
@@ -141,6 +146,20 @@ class Kinematics : public Optimizer {
   gtsam::NonlinearFactorGraph jointAngleObjectives(const CONTEXT& context,
                                                    const Robot& robot) const;
 
+  /**
+   * @fn Factors that keep the link spheres away from obstacles.
+   * @param context Slice or Interval instance.
+   * @param robot Robot specification from URDF/SDF.
+   * @param sdf signed distance field of the obstacles.
+   * @param spheres sphere approximations of the links to check.
+   * @returns graph with obstacle avoidance factors on link poses.
+   */
+  template <class CONTEXT>
+  gtsam::NonlinearFactorGraph obstacleObjectives(
+      const CONTEXT& context, const Robot& robot,
+      const SignedDistanceFieldSharedPtr& sdf,
+      const RobotSpheres& spheres) const;
+
   /**
    * @fn Initialize kinematics.
    *
@@ -157,7 +176,8 @@ class Kinematics : public Optimizer {
 
   /**
    * @fn Inverse kinematics given a set of contact goals.
-   * @fn This fuction does inverse kinematics seperately on each slice.
+   * @fn This fuction does inverse kinematics seperately on each slice, keeping
+   * the link spheres clear of the obstacles of the parameters, if any.
    * @param context Slice or Interval instance.
    * @param robot Robot specification from URDF/SDF.
    * @param contact_goals goals for contact points
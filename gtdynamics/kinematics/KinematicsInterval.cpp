@@ -74,6 +74,18 @@ NonlinearFactorGraph Kinematics::jointAngleObjectives<Interval>(
   return graph;
 }
 
+template <>
+NonlinearFactorGraph Kinematics::obstacleObjectives<Interval>(
+    const Interval& interval, const Robot& robot,
+    const SignedDistanceFieldSharedPtr& sdf,
+    const RobotSpheres& spheres) const {
+  NonlinearFactorGraph graph;
+  for (size_t k = interval.k_start; k <= interval.k_end; k++) {
+    graph.add(obstacleObjectives(Slice(k), robot, sdf, spheres));
+  }
+  return graph;
+}
+
 template <>
 Values Kinematics::initialValues<Interval>(const Interval& interval,
                                            const Robot& robot,
@@ -112,6 +112,22 @@ NonlinearFactorGraph Kinematics::jointAngleObjectives<Slice>(
   return graph;
 }
 
+template <>
+NonlinearFactorGraph Kinematics::obstacleObjectives<Slice>(
+    const Slice& slice, const Robot& robot,
+    const SignedDistanceFieldSharedPtr& sdf,
+    const RobotSpheres& spheres) const {
+  NonlinearFactorGraph graph;
+  for (auto&& [name, link_spheres] : spheres) {
+    auto cost_model = gtsam::noiseModel::Isotropic::Sigma(
+        link_spheres.size(), p_.obstacle_sigma);
+    graph.emplace_shared<ObstacleSDFFactor>(
+        PoseKey(robot.link(name)->id(), slice.k), cost_model, sdf,
+        link_spheres, p_.obstacle_epsilon);
+  }
+  return graph;
+}
+
 template <>
 Values Kinematics::initialValues<Slice>(const Slice& slice, const Robot& robot,
                                         double gaussian_noise) const {
@@ -153,6 +169,12 @@ Values Kinematics::inverse<Slice>(const Slice& slice, const Robot& robot,
   // Traget joint angles.
   graph.add(jointAngleObjectives(slice, robot));
 
+  // Obstacle avoidance.
+  if (p_.obstacle_sdf) {
+    graph.add(obstacleObjectives(slice, robot, p_.obstacle_sdf,
+                                 p_.obstacle_spheres));
+  }
+
   // TODO(frank): allo pose prior as well.
   // graph.addPrior<gtsam::Pose3>(PoseKey(0, slice.k),
   // gtsam::Pose3(), nullptr);
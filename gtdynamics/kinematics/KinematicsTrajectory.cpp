@@ -74,6 +74,18 @@ NonlinearFactorGraph Kinematics::jointAngleObjectives<Trajectory>(
   return graph;
 }
 
+template <>
+NonlinearFactorGraph Kinematics::obstacleObjectives<Trajectory>(
+    const Trajectory& trajectory, const Robot& robot,
+    const SignedDistanceFieldSharedPtr& sdf,
+    const RobotSpheres& spheres) const {
+  NonlinearFactorGraph graph;
+  for (auto&& phase : trajectory.phases()) {
+    graph.add(obstacleObjectives<Interval>(phase, robot, sdf, spheres));
+  }
+  return graph;
+}
+
 template <>
 Values Kinematics::initialValues<Trajectory>(const Trajectory& trajectory,
                                              const Robot& robot,
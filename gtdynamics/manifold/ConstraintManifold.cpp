@@ -22,6 +22,7 @@ namespace gtsam {
 Values ConstraintManifold::constructValues(
     const ConnectedComponent::shared_ptr cc, const gtsam::Values &values,
     const Retractor::shared_ptr &retractor, bool retract_init) {
+  gtdynamics::TraceScope trace("retractConstraints");
   Values cm_values;
   for (const gtsam::Key &key : cc->keys_) {
     cm_values.insert(key, values.at(key));
@@ -50,6 +51,7 @@ ConstraintManifold ConstraintManifold::retract(const gtsam::Vector &xi,
                                                ChartJacobian H2) const {
   // Compute delta for each variable and perform update.
   makeSureBasisConstructed();
+  gtdynamics::TraceScope trace("manifoldRetract");
   // std::cout << "xi: " << xi.transpose() << "\n";
   VectorValues delta = basis_->computeTangentVector(xi);
   Values new_values = retractor_->retract(values_, delta);
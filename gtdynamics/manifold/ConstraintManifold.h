@@ -16,6 +16,7 @@
 #include <gtdynamics/manifold/ConnectedComponent.h>
 #include <gtdynamics/manifold/Retractor.h>
 #include <gtdynamics/manifold/TspaceBasis.h>
+#include <gtdynamics/utils/Tracer.h>
 
 #include <cstddef>
 
@@ -154,6 +155,7 @@ class ConstraintManifold {
   /// Make sure the tangent space basis is constructed.
   void makeSureBasisConstructed() const {
     if (!basis_->isConstructed()) {
+      gtdynamics::TraceScope trace("constructTspaceBasis");
       basis_->construct(cc_, values_);
     }
   }
@@ -27,6 +27,19 @@ Values ManifoldOptimizerType1::optimize(
     const gtdynamics::EqualityConstraints& constraints,
     const Values& init_values,
     gtdynamics::ConstrainedOptResult* intermediate_result) const {
+  if ((p_.time_budget || p_.cancellation_token) &&
+      !p_.cc_params->retract_params->time_budget) {
+    // Start the budget here, and share it with the retractions of all the
+    // constraint manifolds, including the initial ones.
+    ManifoldOptimizerParameters params = p_;
+    params.cc_params =
+        std::make_shared<ConstraintManifold::Params>(*p_.cc_params);
+    params.cc_params->retract_params =
+        std::make_shared<RetractParams>(*p_.cc_params->retract_params);
+    params.cc_params->retract_params->time_budget = p_.timeBudget();
+    return ManifoldOptimizerType1(params, nopt_params_)
+        .optimize(costs, constraints, init_values, intermediate_result);
+  }
   auto mopt_problem = initializeMoptProblem(costs, constraints, init_values);
   return optimize(mopt_problem, intermediate_result);
 }
@@ -35,13 +48,61 @@ Values ManifoldOptimizerType1::optimize(
 Values ManifoldOptimizerType1::optimize(
     const ManifoldOptProblem& mopt_problem,
     gtdynamics::ConstrainedOptResult* intermediate_result) const {
+  const gtdynamics::TimeBudget budget =
+      p_.cc_params->retract_params->time_budget.value_or(
+          gtdynamics::TimeBudget());
+  const NonlinearOptimizerParams& nopt_params = std::visit(
+      [](const auto& params) -> const NonlinearOptimizerParams& {
+        return params;
+      },
+      nopt_params_);
   auto nonlinear_optimizer = constructNonlinearOptimizer(mopt_problem);
-  auto nopt_values = nonlinear_optimizer->optimize();
+
+  // Iterates are on the constraint manifolds, up to the retraction tolerance,
+  // and their cost is the error of the manifold optimization problem.
+  std::function<void()> report_progress;
+  if (p_.progress_callback) {
+    report_progress = [&]() {
+      const Values& nopt_values = nonlinear_optimizer->values();
+      Values constrained_values;
+      for (const Key& key : mopt_problem.fixed_manifolds_.keys()) {
+        constrained_values.insert(mopt_problem.fixed_manifolds_.at(key)
+                                      .cast<ConstraintManifold>()
+                                      .values());
+      }
+      for (const Key& key : mopt_problem.manifold_keys_) {
+        constrained_values.insert(
+            nopt_values.at(key).cast<ConstraintManifold>().values());
+      }
+      gtdynamics::SolveProgress progress;
+      progress.iteration = nonlinear_optimizer->iterations();
+      progress.cost = nonlinear_optimizer->error();
+      for (const auto& component : mopt_problem.components_) {
+        for (const auto& constraint : component->constraints_) {
+          progress.constraint_violation +=
+              constraint->toleranceScaledViolation(constrained_values)
+                  .squaredNorm();
+        }
+      }
+      progress.constraint_violation = sqrt(progress.constraint_violation);
+      progress.elapsed_time = budget.elapsed();
+      p_.progress_callback(progress);
+    };
+  }
+
+  // An iteration interrupted by the budget or a cancellation may end within its
+  // retractions, and is then discarded for the last complete one.
+  Values nopt_values;
+  const auto reason = gtdynamics::IterateWithinBudget(
+      nonlinear_optimizer.get(), nopt_params, budget, intermediate_result,
+      &nopt_values, report_progress);
   if (intermediate_result) {
     intermediate_result->num_iters.push_back(
         std::dynamic_pointer_cast<LevenbergMarquardtOptimizer>(
             nonlinear_optimizer)
             ->getInnerIterations());
+    intermediate_result->termination_reason = reason;
+    intermediate_result->elapsed_time = budget.elapsed();
   }
   return baseValues(mopt_problem, nopt_values);
 }
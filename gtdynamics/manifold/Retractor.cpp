@@ -64,10 +64,22 @@ void Retractor::checkFeasible(const NonlinearFactorGraph &graph,
   }
 }
 
+/* ************************************************************************* */
+Values Retractor::optimize(LevenbergMarquardtOptimizer &optimizer) const {
+  if (params_->time_budget) {
+    gtdynamics::IterateWithinBudget(&optimizer, optimizer.params(),
+                                    *params_->time_budget);
+    return optimizer.values();
+  }
+  return optimizer.optimize();
+}
+
 /* ************************************************************************* */
 UoptRetractor::UoptRetractor(const ConnectedComponent::shared_ptr &cc,
                              const RetractParams::shared_ptr &params)
-    : Retractor(cc, params), optimizer_(cc->merit_graph_, params->lm_params) {}
+    : Retractor(cc, params), optimizer_(cc->merit_graph_, params->lm_params) {
+  if (params->time_budget) optimizer_.setTimeBudget(*params->time_budget);
+}
 
 /* ************************************************************************* */
 Values UoptRetractor::retractConstraints(const Values &values) {
@@ -98,7 +110,7 @@ ProjRetractor::ProjRetractor(const ConnectedComponent::shared_ptr &cc,
 /* ************************************************************************* */
 Values ProjRetractor::retractConstraints(const Values &values) {
   LevenbergMarquardtOptimizer optimizer(cc_->merit_graph_, values);
-  return optimizer.optimize();
+  return optimize(optimizer);
 }
 
 /* ************************************************************************* */
@@ -115,7 +127,7 @@ Values ProjRetractor::retract(const Values &values, const VectorValues &delta) {
       params_->apply_base_retraction ? values_retract_base : values;
   LevenbergMarquardtOptimizer optimizer_with_priors(graph, init_values,
                                                     params_->lm_params);
-  const Values &result = optimizer_with_priors.optimize();
+  const Values result = optimize(optimizer_with_priors);
   if (params_->use_basis_keys &&
       optimizer_with_priors.error() < params_->feasible_threshold) {
     return result;
@@ -124,7 +136,7 @@ Values ProjRetractor::retract(const Values &values, const VectorValues &delta) {
   // optimize without priors
   LevenbergMarquardtOptimizer optimizer_without_priors(
       cc_->merit_graph_, result, params_->lm_params);
-  const Values &final_result = optimizer_without_priors.optimize();
+  const Values final_result = optimize(optimizer_without_priors);
   checkFeasible(cc_->merit_graph_, final_result);
   return final_result;
 }
@@ -164,6 +176,7 @@ BasisRetractor::BasisRetractor(const ConnectedComponent::shared_ptr &cc,
   }
   // set the graph for optimizer
   optimizer_.setGraph(graph);
+  if (params->time_budget) optimizer_.setTimeBudget(*params->time_budget);
 }
 
 /* ************************************************************************* */
@@ -188,7 +201,7 @@ Values BasisRetractor::retractConstraints(const Values &values) {
         result.insert(key, values.at(key));
       }
       auto optimizer = LevenbergMarquardtOptimizer(cc_->merit_graph_, result);
-      result = optimizer.optimize();
+      result = optimize(optimizer);
       checkFeasible(cc_->merit_graph_, result);
       return result;
     }
@@ -319,6 +332,14 @@ DynamicsRetractor::DynamicsRetractor(
   optimizer_wp_q_.setGraph(graph_q);
   optimizer_wp_v_.setGraph(graph_v);
   optimizer_wp_ad_.setGraph(graph_ad);
+
+  if (params->time_budget) {
+    for (auto optimizer : {&optimizer_wp_q_, &optimizer_wp_v_,
+                           &optimizer_wp_ad_, &optimizer_np_q_,
+                           &optimizer_np_v_, &optimizer_np_ad_}) {
+      optimizer->setTimeBudget(*params->time_budget);
+    }
+  }
 }
 
 /* ************************************************************************* */
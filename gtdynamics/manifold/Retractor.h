@@ -19,6 +19,7 @@
 #include <gtdynamics/manifold/MultiJacobian.h>
 #include <gtdynamics/optimizer/MutableLMOptimizer.h>
 #include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/nonlinear/LevenbergMarquardtParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
@@ -41,6 +42,8 @@ struct RetractParams {
   double sigma = 1.0;
   bool apply_base_retraction = false;
   bool recompute = false;
+  // Deadline shared by all retractions, checked between LM iterations.
+  std::optional<gtdynamics::TimeBudget> time_budget;
 
   // Constructor
   RetractParams() = default;
@@ -129,6 +132,9 @@ class Retractor {
  protected:
   void checkFeasible(const NonlinearFactorGraph &graph,
                      const Values &values) const;
+
+  /// Optimize within the time budget of the parameters, if any.
+  Values optimize(LevenbergMarquardtOptimizer &optimizer) const;
 };
 
 /** Retractor with unconstrained optimization. */
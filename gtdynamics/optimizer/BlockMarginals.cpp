@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  BlockMarginals.cpp
+ * @brief Marginal covariances of selected variables of an estimation graph,
+ * read from the root of a Bayes tree.
+ */
+
+#include <gtdynamics/optimizer/BlockMarginals.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+
+#include <set>
+#include <stdexcept>
+
+namespace gtdynamics {
+
+using gtsam::Key;
+using gtsam::KeyVector;
+using gtsam::Matrix;
+
+/* ************************************************************************* */
+KeyVector EstimationOutputKeys(const Robot &robot, int k,
+                               const PointOnLinks &contact_points) {
+  KeyVector keys;
+  for (auto &&link : robot.links()) keys.push_back(PoseKey(link->id(), k));
+  std::set<int> contact_links;
+  for (auto &&cp : contact_points) {
+    if (contact_links.insert(cp.link->id()).second) {
+      keys.push_back(ContactWrenchKey(cp.link->id(), 0, k));
+    }
+  }
+  return keys;
+}
+
+/* ************************************************************************* */
+BlockMarginals::BlockMarginals(const gtsam::ISAM2 &isam, const KeyVector &keys)
+    : keys_(keys) {
+  recover(isam);
+}
+
+/* ************************************************************************* */
+BlockMarginals::BlockMarginals(const gtsam::NonlinearFactorGraph &graph,
+                               const gtsam::Values &solution,
+                               const KeyVector &keys)
+    : keys_(keys) {
+  const auto linear = graph.linearize(solution);
+  const auto ordering = gtsam::Ordering::ColamdConstrainedLast(*linear, keys);
+  recover(*linear->eliminateMultifrontal(ordering));
+}
+
+/* ************************************************************************* */
+template <class BAYES_TREE>
+void BlockMarginals::recover(const BAYES_TREE &bayes_tree) {
+  size_t dim = 0;
+  for (Key key : keys_) {
+    offsets_[key] = dim;
+    roots_[key] = std::nullopt;
+    const auto &conditional = *bayes_tree[key]->conditional();
+    dims_[key] = conditional.getDim(conditional.find(key));
+    dim += dims_[key];
+  }
+  joint_covariance_ = Matrix::Zero(dim, dim);
+
+  // Covariance of the frontal variables of each root clique holding requested
+  // variables, from the information of its conditional.
+  const auto &roots = bayes_tree.roots();
+  for (size_t r = 0; r < roots.size(); r++) {
+    const auto &conditional = *roots[r]->conditional();
+    std::map<Key, size_t> frontal_offsets;
+    size_t frontal_dim = 0;
+    for (auto it = conditional.beginFrontals(); it != conditional.endFrontals();
+         ++it) {
+      frontal_offsets[*it] = frontal_dim;
+      frontal_dim += conditional.getDim(it);
+    }
+    KeyVector in_root;
+    for (Key key : keys_) {
+      if (frontal_offsets.count(key)) in_root.push_back(key);
+    }
+    if (in_root.empty()) continue;
+
+    const Matrix information = conditional.information();
+    const Matrix covariance =
+        information.llt().solve(Matrix::Identity(frontal_dim, frontal_dim));
+    for (Key key1 : in_root) {
+      roots_[key1] = r;
+      for (Key key2 : in_root) {
+        joint_covariance_.block(offsets_[key1], offsets_[key2], dims_[key1],
+                                dims_[key2]) =
+            covariance.block(frontal_offsets[key1], frontal_offsets[key2],
+                             dims_[key1], dims_[key2]);
+      }
+    }
+  }
+
+  // Requested variables outside the roots, through shortcuts.
+  for (Key key : keys_) {
+    if (roots_[key]) continue;
+    joint_covariance_.block(offsets_[key], offsets_[key], dims_[key],
+                            dims_[key]) =
+        bayes_tree.marginalFactor(key, gtsam::EliminatePreferCholesky)
+            ->information()
+            .inverse();
+  }
+}
+
+/* ************************************************************************* */
+Matrix BlockMarginals::marginalCovariance(Key key) const {
+  return jointCovariance(key, key);
+}
+
+/* ************************************************************************* */
+Matrix BlockMarginals::jointCovariance(Key key1, Key key2) const {
+  const auto root1 = roots_.find(key1), root2 = roots_.find(key2);
+  if (root1 == roots_.end() || root2 == roots_.end()) {
+    throw std::invalid_argument(
+        "BlockMarginals: covariance of a variable that was not requested.");
+  }
+  if (key1 != key2 && (!root1->second || root1->second != root2->second)) {
+    throw std::invalid_argument(
+        "BlockMarginals: cross-covariance of variables not in the same root "
+        "clique.");
+  }
+  return joint_covariance_.block(offsets_.at(key1), offsets_.at(key2),
+                                 dims_.at(key1), dims_.at(key2));
+}
+
+}  // namespace gtdynamics
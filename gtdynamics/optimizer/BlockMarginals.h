@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  BlockMarginals.h
+ * @brief Marginal covariances of selected variables of an estimation graph,
+ * read from the root of a Bayes tree.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/PointOnLink.h>
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <map>
+#include <optional>
+
+namespace gtdynamics {
+
+/**
+ * Keys of the outputs of a state estimator at step k: the poses of all links,
+ * and the wrenches of the links in contact.
+ */
+gtsam::KeyVector EstimationOutputKeys(const Robot &robot, int k,
+                                      const PointOnLinks &contact_points = {});
+
+/**
+ * Marginal and joint covariances of a few variables, e.g., the latest link
+ * poses and contact wrenches of an estimator built from JointMeasurementFactor
+ * and PreintegratedContactFactors.
+ *
+ * Unlike gtsam::Marginals, which eliminates the whole graph again and then
+ * recovers each covariance through shortcuts in the Bayes tree, this reads the
+ * covariances of the requested variables from the root cliques of a Bayes tree
+ * in which they were eliminated last, at the cost of one dense inverse of the
+ * size of the requested variables:
+ *  - an iSAM2 Bayes tree is reused as is; to keep the outputs in its root,
+ *    give them the highest group in ISAM2UpdateParams::constrainedKeys;
+ *  - a batch solution is eliminated once, with the requested keys last.
+ * Requested variables that are not in a root clique fall back to the marginal
+ * of the Bayes tree, and have no cross-covariances.
+ */
+class BlockMarginals {
+ private:
+  gtsam::KeyVector keys_;
+  std::map<gtsam::Key, size_t> offsets_, dims_;  // in joint_covariance_
+  std::map<gtsam::Key, std::optional<size_t>> roots_;  // root clique, if any
+  gtsam::Matrix joint_covariance_;
+
+ public:
+  /**
+   * Reuse the Bayes tree of an iSAM2 estimator.
+   * @param isam estimator, after its last update.
+   * @param keys variables whose covariances are requested.
+   */
+  BlockMarginals(const gtsam::ISAM2 &isam, const gtsam::KeyVector &keys);
+
+  /**
+   * Eliminate the graph, linearized at the solution, once, with the requested
+   * variables last so that they make up the root clique.
+   * @param graph estimation graph.
+   * @param solution its solution.
+   * @param keys variables whose covariances are requested.
+   */
+  BlockMarginals(const gtsam::NonlinearFactorGraph &graph,
+                 const gtsam::Values &solution, const gtsam::KeyVector &keys);
+
+  /// Requested variables.
+  const gtsam::KeyVector &keys() const { return keys_; }
+
+  /// Marginal covariance of a requested variable.
+  gtsam::Matrix marginalCovariance(gtsam::Key key) const;
+
+  /**
+   * Cross-covariance of two requested variables.
+   * @throws std::invalid_argument if they are not in the same root clique.
+   */
+  gtsam::Matrix jointCovariance(gtsam::Key key1, gtsam::Key key2) const;
+
+  /**
+   * Joint covariance of all requested variables, in the order of keys(), with
+   * zero cross-covariances for variables in different root cliques or
+   * outside the roots.
+   */
+  const gtsam::Matrix &jointCovariance() const { return joint_covariance_; }
+
+ private:
+  /// Read the covariances from the root cliques of a Bayes tree.
+  template <class BAYES_TREE>
+  void recover(const BAYES_TREE &bayes_tree);
+};
+
+}  // namespace gtdynamics
@@ -14,16 +14,32 @@
 #pragma once
 
 #include <gtdynamics/optimizer/EqualityConstraint.h>
+#include <gtdynamics/optimizer/SchurCondensing.h>
+#include <gtdynamics/optimizer/TimeBudget.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/nonlinear/LevenbergMarquardtParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
 
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
 namespace gtdynamics {
 
 /// Constrained optimization parameters shared between all solvers.
 struct ConstrainedOptimizationParameters {
   gtsam::LevenbergMarquardtParams lm_parameters;  // LM parameters
+  OrderingType ordering_type = OrderingType::COLAMD;  // elimination ordering
+  bool condense = false;  // condense link variables, see SchurCondensing.h
+  std::optional<TrajectoryPCGParams> pcg_parameters;  // PCG solves if set
+  std::optional<double> time_budget;  // wall-clock seconds, unlimited if unset
+  std::optional<CancellationToken> cancellation_token;  // stops when cancelled
+  ProgressCallback progress_callback;  // called after each (outer) iteration
 
   /// Constructor.
   ConstrainedOptimizationParameters() {}
@@ -32,6 +48,49 @@ struct ConstrainedOptimizationParameters {
   ConstrainedOptimizationParameters(
       const gtsam::LevenbergMarquardtParams& _lm_parameters)
       : lm_parameters(_lm_parameters) {}
+
+  /**
+   * LM parameters, with the elimination ordering of the merit graph if any.
+   * All merit graphs share their keys, so the ordering is computed once.
+   */
+  gtsam::LevenbergMarquardtParams lmParameters(
+      const gtsam::NonlinearFactorGraph& merit_graph) const {
+    gtsam::LevenbergMarquardtParams params = lm_parameters;
+    if (auto ordering = TrajectoryOrdering(merit_graph, ordering_type)) {
+      params.ordering = *ordering;
+    }
+    return params;
+  }
+
+  /**
+   * LM optimizer on a merit graph, with condensed or PCG linear solves if
+   * requested.
+   * @throws std::invalid_argument if both are requested.
+   */
+  std::unique_ptr<gtsam::LevenbergMarquardtOptimizer> lmOptimizer(
+      const gtsam::NonlinearFactorGraph& merit_graph,
+      const gtsam::Values& values,
+      const gtsam::LevenbergMarquardtParams& params) const {
+    if (condense && pcg_parameters) {
+      throw std::invalid_argument(
+          "lmOptimizer: condense and pcg_parameters are exclusive.");
+    }
+    if (condense) {
+      return std::make_unique<CondensedLMOptimizer>(merit_graph, values,
+                                                    params);
+    }
+    if (pcg_parameters) {
+      return std::make_unique<PCGLMOptimizer>(merit_graph, values, params,
+                                              *pcg_parameters);
+    }
+    return std::make_unique<gtsam::LevenbergMarquardtOptimizer>(
+        merit_graph, values, params);
+  }
+
+  /// Start the time budget of an optimization, with the cancellation token.
+  TimeBudget timeBudget() const {
+    return TimeBudget(time_budget, cancellation_token);
+  }
 };
 
 /// Intermediate results for constrained optimization process.
@@ -40,8 +99,91 @@ struct ConstrainedOptResult {
       intermediate_values;        // values after each inner loop
   std::vector<int> num_iters;     // number of LM iterations for each inner loop
   std::vector<double> mu_values;  // penalty parameter for each inner loop
+  TerminationReason termination_reason =
+      TerminationReason::MAX_ITERATIONS;  // why the optimizer stopped
+  double elapsed_time = 0.0;              // wall-clock seconds of the solve
+  std::vector<double> iteration_times;  // elapsed seconds after each iteration
+};
+
+/**
+ * Best iterate of a constrained optimization so far: the feasible one of lowest
+ * cost, or, while none is feasible, the one of lowest constraint violation.
+ * Returned when an optimizer runs out of time.
+ */
+class BestIterate {
+  gtsam::Values values_;
+  bool feasible_ = false;
+  double cost_ = std::numeric_limits<double>::infinity();
+  double violation_ = std::numeric_limits<double>::infinity();
+
+ public:
+  /// Keep values if better than the best iterate so far.
+  void update(const gtsam::NonlinearFactorGraph& graph,
+              const EqualityConstraints& constraints,
+              const gtsam::Values& values) {
+    bool feasible = true;
+    double violation = 0.0;
+    for (const auto& constraint : constraints) {
+      feasible = feasible && constraint->feasible(values);
+      violation += constraint->toleranceScaledViolation(values).squaredNorm();
+    }
+    const double cost = graph.error(values);
+    const bool better = feasible ? (!feasible_ || cost < cost_)
+                                 : (!feasible_ && violation < violation_);
+    if (better) {
+      values_ = values;
+      feasible_ = feasible;
+      cost_ = cost;
+      violation_ = violation;
+    }
+  }
+
+  /// Values of the best iterate.
+  const gtsam::Values& values() const { return values_; }
+
+  /// Whether the best iterate is feasible.
+  bool feasible() const { return feasible_; }
 };
 
+/**
+ * Whether an outer iteration of a constrained optimizer converged: its inner
+ * LM converged, the new iterate is feasible, and the cost changed by at most
+ * the absolute or relative error tolerance of the LM parameters.
+ */
+inline bool OuterIterationConverged(
+    const gtsam::LevenbergMarquardtParams& params,
+    TerminationReason inner_reason, const gtsam::NonlinearFactorGraph& graph,
+    const EqualityConstraints& constraints,
+    const gtsam::Values& previous_values, const gtsam::Values& values) {
+  if (inner_reason != TerminationReason::CONVERGED) return false;
+  for (const auto& constraint : constraints) {
+    if (!constraint->feasible(values)) return false;
+  }
+  const double previous_cost = graph.error(previous_values);
+  const double change = std::abs(graph.error(values) - previous_cost);
+  return change <= params.absoluteErrorTol ||
+         change <= params.relativeErrorTol * previous_cost;
+}
+
+/// Report the progress of a constrained optimization to a callback, if any.
+inline void ReportProgress(const ProgressCallback& callback, size_t iteration,
+                           const gtsam::NonlinearFactorGraph& graph,
+                           const EqualityConstraints& constraints,
+                           const gtsam::Values& values,
+                           const TimeBudget& budget) {
+  if (!callback) return;
+  SolveProgress progress;
+  progress.iteration = iteration;
+  progress.cost = graph.error(values);
+  for (const auto& constraint : constraints) {
+    progress.constraint_violation +=
+        constraint->toleranceScaledViolation(values).squaredNorm();
+  }
+  progress.constraint_violation = sqrt(progress.constraint_violation);
+  progress.elapsed_time = budget.elapsed();
+  callback(progress);
+}
+
 /// Base class for constrained optimizer.
 class ConstrainedOptimizer {
  public:
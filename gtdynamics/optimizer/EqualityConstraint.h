@@ -185,6 +185,12 @@ class FactorZeroErrorConstraint : public EqualityConstraint {
 
   /** Return the dimension of the constraint. */
   size_t dim() const override { return factor_->dim(); }
+
+  /// Return the factor whose error is constrained to be 0.
+  const gtsam::NoiseModelFactor::shared_ptr& factor() const { return factor_; }
+
+  /// Return the tolerance in each dimension.
+  const gtsam::Vector& tolerance() const { return tolerance_; }
 };
 
 /// Container of EqualityConstraint.
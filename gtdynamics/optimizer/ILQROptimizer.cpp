@@ -0,0 +1,360 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ILQROptimizer.cpp
+ * @brief Iterative LQR trajectory optimizer on the robot forward dynamics.
+ */
+
+#include <gtdynamics/optimizer/ILQROptimizer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/linear/GaussianBayesNet.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace gtdynamics {
+
+using gtsam::GaussianFactor;
+using gtsam::Key;
+using gtsam::Matrix;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Values;
+using gtsam::Vector;
+
+/// Whitened Jacobian and rhs of a linear factor, with the given columns.
+static std::pair<Matrix, Vector> DenseJacobian(
+    const GaussianFactor::shared_ptr &factor,
+    const std::map<Key, size_t> &columns, size_t num_columns) {
+  auto jacobian = std::dynamic_pointer_cast<gtsam::JacobianFactor>(factor);
+  if (!jacobian) {
+    auto hessian = std::dynamic_pointer_cast<gtsam::HessianFactor>(factor);
+    if (!hessian) {
+      throw std::invalid_argument(
+          "ILQROptimizer: unsupported linear factor type.");
+    }
+    jacobian = std::make_shared<gtsam::JacobianFactor>(*hessian);
+  }
+  const gtsam::JacobianFactor whitened = jacobian->whiten();
+  Matrix A = Matrix::Zero(whitened.rows(), num_columns);
+  for (auto it = whitened.begin(); it != whitened.end(); ++it) {
+    A.middleCols(columns.at(*it), whitened.getDim(it)) = whitened.getA(it);
+  }
+  return {A, whitened.getb()};
+}
+
+/// Initial state and torques of every step, missing torques being zero.
+static void InitialTrajectory(const std::vector<JointSharedPtr> &joints,
+                              size_t num_steps, const Values &values,
+                              Vector *q0, Vector *v0,
+                              std::vector<Vector> *tau) {
+  const size_t n = joints.size();
+  q0->resize(n);
+  v0->resize(n);
+  tau->assign(num_steps + 1, Vector::Zero(n));
+  for (size_t i = 0; i < n; i++) {
+    const int j = joints[i]->id();
+    (*q0)(i) = JointAngle(values, j, 0);
+    (*v0)(i) = JointVel(values, j, 0);
+    for (size_t k = 0; k <= num_steps; k++) {
+      if (values.exists(TorqueKey(j, k))) (*tau)[k](i) = Torque(values, j, k);
+    }
+  }
+}
+
+/* ************************************************************************* */
+ILQROptimizer::ILQROptimizer(const Robot &robot,
+                             const DynamicsGraph &graph_builder,
+                             size_t num_steps, double dt,
+                             const ILQRParameters &parameters)
+    : robot_(robot),
+      graph_builder_(graph_builder),
+      num_steps_(num_steps),
+      dt_(dt),
+      p_(parameters) {
+  const auto links = robot_.links();
+  if (std::none_of(links.begin(), links.end(),
+                   [](const LinkSharedPtr &link) { return link->isFixed(); })) {
+    throw std::invalid_argument(
+        "ILQROptimizer: the robot needs a fixed link, as its state is only "
+        "made of joint angles and velocities.");
+  }
+}
+
+/* ************************************************************************* */
+ILQROptimizer::Rollout ILQROptimizer::simulate(const Vector &q0,
+                                               const Vector &v0,
+                                               const Policy &policy) const {
+  const auto joints = robot_.joints();
+  const size_t n = joints.size();
+  Rollout rollout;
+  Vector q = q0, v = v0;
+  for (size_t k = 0; k <= num_steps_; k++) {
+    const Vector tau = policy(k, q, v);
+    Values known_values;
+    for (size_t i = 0; i < n; i++) {
+      const int j = joints[i]->id();
+      InsertJointAngle(&known_values, j, k, q(i));
+      InsertJointVel(&known_values, j, k, v(i));
+      InsertTorque(&known_values, j, k, tau(i));
+    }
+    const Values step = graph_builder_.linearSolveFD(
+        robot_, k, robot_.forwardKinematics(known_values, k));
+    rollout.values.insert(step);
+    rollout.q.push_back(q);
+    rollout.v.push_back(v);
+    rollout.tau.push_back(tau);
+
+    // Explicit Euler, as CollocationScheme::Euler.
+    Vector a(n);
+    for (size_t i = 0; i < n; i++) a(i) = JointAccel(step, joints[i]->id(), k);
+    q += dt_ * v;
+    v += dt_ * a;
+  }
+  return rollout;
+}
+
+/* ************************************************************************* */
+Values ILQROptimizer::rollout(const Values &values) const {
+  Vector q0, v0;
+  std::vector<Vector> tau;
+  InitialTrajectory(robot_.joints(), num_steps_, values, &q0, &v0, &tau);
+  auto torques = [&](size_t k, const Vector &, const Vector &) {
+    return tau[k];
+  };
+  return simulate(q0, v0, torques).values;
+}
+
+/* ************************************************************************* */
+Matrix ILQROptimizer::accelJacobian(const Values &values, size_t k) const {
+  const auto joints = robot_.joints();
+  const size_t n = joints.size();
+
+  // Columns [a; q; v; tau], and the accelerations eliminated last.
+  std::map<Key, size_t> columns;
+  gtsam::KeyVector accels;
+  for (size_t i = 0; i < n; i++) {
+    const int j = joints[i]->id();
+    columns[JointAccelKey(j, k)] = i;
+    columns[JointAngleKey(j, k)] = n + i;
+    columns[JointVelKey(j, k)] = 2 * n + i;
+    columns[TorqueKey(j, k)] = 3 * n + i;
+    accels.push_back(JointAccelKey(j, k));
+  }
+  const auto linear =
+      graph_builder_.dynamicsFactorGraph(robot_, k).linearize(values);
+  gtsam::Ordering ordering;
+  for (auto &&key : linear->keys()) {
+    if (!columns.count(key)) ordering.push_back(key);
+  }
+  for (auto &&key : accels) ordering.push_back(key);
+  const auto bayes_net = linear->eliminatePartialSequential(ordering).first;
+
+  // The last conditionals give R a + S [q; v; tau] = d.
+  Matrix M(0, 4 * n);
+  for (size_t c = bayes_net->size() - n; c < bayes_net->size(); c++) {
+    const Matrix A = DenseJacobian(bayes_net->at(c), columns, 4 * n).first;
+    M.conservativeResize(M.rows() + A.rows(), Eigen::NoChange);
+    M.bottomRows(A.rows()) = A;
+  }
+  return -M.leftCols(n).partialPivLu().solve(M.rightCols(3 * n));
+}
+
+/* ************************************************************************* */
+Values ILQROptimizer::optimize(
+    const NonlinearFactorGraph &graph, const EqualityConstraints &constraints,
+    const Values &initial_values,
+    ConstrainedOptResult *intermediate_result) const {
+  const auto joints = robot_.joints();
+  const size_t n = joints.size(), nx = 2 * n, nz = 4 * n;
+  const size_t N = num_steps_;
+
+  // Columns [q; v; a; tau] of the variables of each step.
+  std::map<Key, size_t> step_of;
+  std::vector<std::map<Key, size_t>> columns(N + 1);
+  for (size_t k = 0; k <= N; k++) {
+    for (size_t i = 0; i < n; i++) {
+      const int j = joints[i]->id();
+      columns[k][JointAngleKey(j, k)] = i;
+      columns[k][JointVelKey(j, k)] = n + i;
+      columns[k][JointAccelKey(j, k)] = 2 * n + i;
+      columns[k][TorqueKey(j, k)] = 3 * n + i;
+    }
+    for (auto &&[key, column] : columns[k]) step_of[key] = k;
+  }
+
+  // Split the cost by time step.
+  NonlinearFactorGraph cost = graph;
+  for (auto &&constraint : constraints) cost.add(constraint->createFactor(1.0));
+  std::vector<NonlinearFactorGraph> step_costs(N + 1);
+  for (auto &&factor : cost) {
+    if (!factor || factor->keys().empty()) continue;
+    const auto first = step_of.find(factor->front());
+    for (auto &&key : factor->keys()) {
+      const auto it = step_of.find(key);
+      if (it == step_of.end() || it->second != first->second) {
+        throw std::invalid_argument(
+            "ILQROptimizer: cost factors may only involve the joint angles, "
+            "velocities, accelerations and torques of a single time step.");
+      }
+    }
+    step_costs[first->second].add(factor);
+  }
+
+  // Controls are the torques of the actuated joints, tau = tau0 + S du.
+  std::vector<size_t> actuated;
+  for (size_t i = 0; i < n; i++) {
+    if (!p_.unactuated_joints.count(joints[i]->id())) actuated.push_back(i);
+  }
+  const size_t m = actuated.size();
+  Matrix S = Matrix::Zero(n, m);
+  for (size_t c = 0; c < m; c++) S(actuated[c], c) = 1.0;
+
+  Vector q0, v0;
+  std::vector<Vector> tau0;
+  InitialTrajectory(joints, N, initial_values, &q0, &v0, &tau0);
+  auto initial_torques = [&](size_t k, const Vector &, const Vector &) {
+    return tau0[k];
+  };
+  const TimeBudget budget(p_.time_budget, p_.cancellation_token);
+  Rollout current = simulate(q0, v0, initial_torques);
+  double error = cost.error(current.values);
+  double lambda = p_.lambda_initial;
+  TerminationReason reason = TerminationReason::MAX_ITERATIONS;
+
+  std::vector<Matrix> T(N + 1), L(N + 1), K(N + 1);
+  std::vector<Vector> l(N + 1), kff(N + 1);
+  for (size_t iteration = 0; iteration < p_.max_iterations; iteration++) {
+    // Every rollout is dynamically feasible and lowers the cost, so stopping
+    // early simply returns the current one.
+    if (auto stop = budget.stop()) {
+      reason = *stop;
+      break;
+    }
+
+    // Expand the cost in [dx; du], through dz = T [dx; du] with z the
+    // variables [q; v; a; tau] of a step.
+    for (size_t k = 0; k <= N; k++) {
+      const Matrix A = accelJacobian(current.values, k);
+      T[k] = Matrix::Zero(nz, nx + m);
+      T[k].topLeftCorner(nx, nx).setIdentity();
+      T[k].block(nx, 0, n, nx) = A.leftCols(nx);
+      T[k].block(nx, nx, n, m) = A.rightCols(n) * S;
+      T[k].block(3 * n, nx, n, m) = S;
+      Matrix H = Matrix::Zero(nz, nz);
+      Vector g = Vector::Zero(nz);
+      for (auto &&factor : step_costs[k]) {
+        const auto [J, b] =
+            DenseJacobian(factor->linearize(current.values), columns[k], nz);
+        H += J.transpose() * J;
+        g -= J.transpose() * b;
+      }
+      L[k] = T[k].transpose() * H * T[k];
+      l[k] = T[k].transpose() * g;
+    }
+
+    bool accepted = false;
+    double new_error = error;
+    while (!accepted && lambda <= p_.lambda_upper_bound) {
+      // Backward Riccati recursion, with a zero value beyond the last step.
+      Matrix Vxx = Matrix::Zero(nx, nx);
+      Vector Vx = Vector::Zero(nx);
+      bool positive_definite = true;
+      for (size_t k = N + 1; k-- > 0;) {
+        Vector Q = l[k];
+        Matrix QQ = L[k];
+        if (k < N) {
+          // Explicit Euler: q' = q + dt v, v' = v + dt a.
+          Matrix F = Matrix::Zero(nx, nx + m);
+          F.topLeftCorner(nx, nx).setIdentity();
+          F.block(0, n, n, n).diagonal().setConstant(dt_);
+          F.bottomRows(n) += dt_ * T[k].middleRows(nx, n);
+          Q += F.transpose() * Vx;
+          QQ += F.transpose() * Vxx * F;
+        }
+        const Vector Q_x = Q.head(nx), Q_u = Q.tail(m);
+        const Matrix Q_xx = QQ.topLeftCorner(nx, nx);
+        const Matrix Q_ux = QQ.bottomLeftCorner(m, nx);
+        const Matrix Q_uu = QQ.bottomRightCorner(m, m);
+        const Eigen::LLT<Matrix> llt(Q_uu + lambda * Matrix::Identity(m, m));
+        if (llt.info() != Eigen::Success) {
+          positive_definite = false;
+          break;
+        }
+        K[k] = -llt.solve(Q_ux);
+        kff[k] = -llt.solve(Q_u);
+        Vx = Q_x + K[k].transpose() * (Q_uu * kff[k] + Q_u) +
+             Q_ux.transpose() * kff[k];
+        Vxx = Q_xx + K[k].transpose() * (Q_uu * K[k] + Q_ux) +
+              Q_ux.transpose() * K[k];
+        Vxx = (0.5 * (Vxx + Vxx.transpose())).eval();
+      }
+
+      // Forward rollout of the new policy, with a backtracking line search.
+      size_t num_steps_tried = 0;
+      if (positive_definite) {
+        double alpha = 1.0;
+        for (; num_steps_tried <= p_.max_line_search && !accepted;
+             num_steps_tried++, alpha *= 0.5) {
+          auto policy = [&](size_t k, const Vector &q, const Vector &v) {
+            Vector dx(nx);
+            dx << q - current.q[k], v - current.v[k];
+            return Vector(current.tau[k] +
+                          S * (alpha * kff[k] + K[k] * dx));
+          };
+          Rollout candidate = simulate(q0, v0, policy);
+          new_error = cost.error(candidate.values);
+          if (new_error < error) {
+            current = std::move(candidate);
+            accepted = true;
+          }
+        }
+      }
+
+      if (accepted) {
+        lambda = std::max(lambda / p_.lambda_factor, p_.lambda_initial);
+        if (intermediate_result) {
+          intermediate_result->intermediate_values.push_back(current.values);
+          intermediate_result->num_iters.push_back(num_steps_tried);
+          intermediate_result->mu_values.push_back(lambda);
+          intermediate_result->iteration_times.push_back(budget.elapsed());
+        }
+      } else {
+        lambda *= p_.lambda_factor;
+      }
+    }
+    if (!accepted) {
+      reason = TerminationReason::CONVERGED;
+      break;
+    }
+
+    const double decrease = error - new_error;
+    error = new_error;
+    ReportProgress(p_.progress_callback, iteration + 1, graph, constraints,
+                   current.values, budget);
+    if (decrease < p_.absolute_error_tol ||
+        decrease < p_.relative_error_tol * (error + decrease)) {
+      reason = TerminationReason::CONVERGED;
+      break;
+    }
+  }
+
+  if (intermediate_result) {
+    intermediate_result->termination_reason = reason;
+    intermediate_result->elapsed_time = budget.elapsed();
+  }
+  return current.values;
+}
+
+}  // namespace gtdynamics
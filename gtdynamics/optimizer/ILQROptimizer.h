@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ILQROptimizer.h
+ * @brief Iterative LQR trajectory optimizer on the robot forward dynamics.
+ */
+
+#pragma once
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/optimizer/ConstrainedOptimizer.h>
+#include <gtdynamics/universal_robot/Robot.h>
+
+#include <functional>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Parameters of the iLQR optimizer.
+struct ILQRParameters {
+  size_t max_iterations = 100;       // maximum number of backward passes
+  double relative_error_tol = 1e-6;  // of the cost decrease
+  double absolute_error_tol = 1e-9;  // of the cost decrease
+  double lambda_initial = 1e-6;      // initial and minimum regularization
+  double lambda_factor = 10.0;       // increase/decrease of lambda
+  double lambda_upper_bound = 1e10;  // give up above this regularization
+  size_t max_line_search = 10;       // number of halvings of the step size
+  std::set<int> unactuated_joints;   // their torques keep initial values
+  std::optional<double> time_budget;  // wall-clock seconds, unlimited if unset
+  std::optional<CancellationToken> cancellation_token;  // stops when cancelled
+  ProgressCallback progress_callback;  // called after each iteration
+};
+
+/**
+ * ILQROptimizer optimizes joint-space trajectories of a fixed-base robot by
+ * iterative LQR, i.e., DDP with Gauss-Newton cost Hessians and first-order
+ * dynamics. The dynamics are not factors: the state [q; v] at step k + 1
+ * follows from step k by forward dynamics and explicit Euler integration, as
+ * with CollocationScheme::Euler in DynamicsGraph::trajectoryFG, and the
+ * torques of every step are the controls. Each iteration is a backward
+ * Riccati recursion and a forward rollout, both linear in the horizon.
+ *
+ * The forward dynamics are those of DynamicsGraph::linearSolveFD, and their
+ * Jacobians w.r.t. q, v and torques are obtained by eliminating the linearized
+ * dynamics factors of each step, with the joint accelerations last.
+ *
+ * The cost is the graph given to optimize, whose factors may only involve the
+ * joint angles, velocities, accelerations and torques of a single step.
+ * Equality constraints are added to it as soft factors.
+ */
+class ILQROptimizer : public ConstrainedOptimizer {
+ protected:
+  Robot robot_;
+  mutable DynamicsGraph graph_builder_;
+  size_t num_steps_;
+  double dt_;
+  ILQRParameters p_;
+
+ public:
+  /**
+   * Constructor.
+   * @param robot a robot with a fixed link.
+   * @param graph_builder dynamics graph builder, for gravity and planar axis.
+   * @param num_steps number of time steps, with states 0..num_steps.
+   * @param dt duration of a time step.
+   * @param parameters iLQR parameters.
+   * @throws std::invalid_argument if no link of the robot is fixed.
+   */
+  ILQROptimizer(const Robot& robot, const DynamicsGraph& graph_builder,
+                size_t num_steps, double dt,
+                const ILQRParameters& parameters = ILQRParameters());
+
+  /**
+   * Simulate from the joint angles and velocities at step 0 of `values`,
+   * with the torques of `values` at every step, missing torques being zero.
+   * @return values of all dynamics variables at steps 0..num_steps.
+   */
+  gtsam::Values rollout(const gtsam::Values& values) const;
+
+  /**
+   * Optimize the torques from the initial state in initial_values.
+   * @param graph cost factors on single-step joint variables.
+   * @param constraints equality constraints, added to the cost.
+   * @param initial_values initial state at step 0, and initial torques.
+   * @param intermediate_result (optional) values after each iteration, with
+   * the line search steps as num_iters and the regularization as mu_values,
+   * and the termination reason and timings.
+   * @return the rollout of the optimized torques.
+   * @throws std::invalid_argument if a cost factor involves other variables.
+   */
+  gtsam::Values optimize(
+      const gtsam::NonlinearFactorGraph& graph,
+      const EqualityConstraints& constraints,
+      const gtsam::Values& initial_values,
+      ConstrainedOptResult* intermediate_result = nullptr) const override;
+
+ private:
+  /// Trajectory as states and controls of every step.
+  struct Rollout {
+    gtsam::Values values;
+    std::vector<gtsam::Vector> q, v, tau;
+  };
+
+  /// Torques as a function of the time step and the state [q; v].
+  using Policy = std::function<gtsam::Vector(size_t, const gtsam::Vector&,
+                                             const gtsam::Vector&)>;
+
+  /// Simulate from [q0; v0] under a policy.
+  Rollout simulate(const gtsam::Vector& q0, const gtsam::Vector& v0,
+                   const Policy& policy) const;
+
+  /// Jacobian of the joint accelerations w.r.t. [q; v; tau] at step k.
+  gtsam::Matrix accelJacobian(const gtsam::Values& values, size_t k) const;
+};
+
+}  // namespace gtdynamics
@@ -20,6 +20,7 @@
  */
 
 #include <gtdynamics/optimizer/MutableLMOptimizer.h>
+#include <gtdynamics/utils/Tracer.h>
 #include <gtsam/base/Vector.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/inference/Ordering.h>
@@ -125,6 +126,7 @@ inline void MutableLMOptimizer::writeLogFile(double currentError) {
 /* ************************************************************************* */
 bool MutableLMOptimizer::tryLambda(const GaussianFactorGraph& linear,
                                    const VectorValues& sqrtHessianDiagonal) {
+  gtdynamics::TraceScope trace("LM_tryLambda");
   auto currentState = static_cast<const State*>(state_.get());
   bool verbose = (params_.verbosityLM >= LevenbergMarquardtParams::TRYLAMBDA);
 
@@ -269,6 +271,7 @@ GaussianFactorGraph::shared_ptr MutableLMOptimizer::iterate() {
   auto currentState = static_cast<const State*>(state_.get());
 
   gttic(LM_iterate);
+  gtdynamics::TraceScope trace("LM_iterate");
 
   // Linearize graph
   if (params_.verbosityLM >= LevenbergMarquardtParams::DAMPED)
@@ -322,6 +325,30 @@ MutableLMOptimizer::MutableLMOptimizer(const NonlinearFactorGraph& graph,
                      Values(), 0., params.lambdaInitial, params.lambdaFactor))),
       params_(LevenbergMarquardtParams::EnsureHasOrdering(params, graph)) {}
 
+/* ************************************************************************* */
+const Values& MutableLMOptimizer::optimize() {
+  if (time_budget_.limited()) {
+    termination_reason_ =
+        gtdynamics::IterateWithinBudget(this, params_, time_budget_);
+  } else {
+    defaultOptimize();
+    termination_reason_ = iterations() >= params_.maxIterations
+                              ? gtdynamics::TerminationReason::MAX_ITERATIONS
+                              : gtdynamics::TerminationReason::CONVERGED;
+  }
+  return values();
+}
+
+/* ************************************************************************* */
+VectorValues MutableLMOptimizer::solve(
+    const GaussianFactorGraph& gfg,
+    const NonlinearOptimizerParams& params) const {
+  if (pcg_params_) {
+    return gtdynamics::TrajectoryPCGSolver::Solve(gfg, *pcg_params_);
+  }
+  return NonlinearOptimizer::solve(gfg, params);
+}
+
 /* ************************************************************************* */
 void MutableLMOptimizer::setGraph(const NonlinearFactorGraph& graph) {
   graph_ = graph;
@@ -335,6 +362,17 @@ void MutableLMOptimizer::setGraph(const NonlinearFactorGraph& graph,
   params_ = LevenbergMarquardtParams::ReplaceOrdering(params_, ordering);
 }
 
+/* ************************************************************************* */
+void MutableLMOptimizer::setGraph(const NonlinearFactorGraph& graph,
+                                  gtdynamics::OrderingType ordering_type) {
+  if (auto ordering = gtdynamics::TrajectoryOrdering(graph, ordering_type)) {
+    setGraph(graph, *ordering);
+  } else {
+    params_.ordering.reset();
+    setGraph(graph);
+  }
+}
+
 /* ************************************************************************* */
 void MutableLMOptimizer::setValues(const Values& values) {
   state_ = std::unique_ptr<State>(new State((values), graph_.error(values),
@@ -22,11 +22,15 @@
 
 #pragma once
 
+#include <gtdynamics/optimizer/TimeBudget.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/nonlinear/LevenbergMarquardtParams.h>
 #include <gtsam/nonlinear/NonlinearOptimizer.h>
 
 #include <chrono>
+#include <optional>
 
 class NonlinearOptimizerMoreOptimizationTest;
 
@@ -38,6 +42,11 @@ namespace gtsam {
 class GTSAM_EXPORT MutableLMOptimizer : public NonlinearOptimizer {
  protected:
   LevenbergMarquardtParams params_;  ///< LM parameters
+  std::optional<gtdynamics::TrajectoryPCGParams>
+      pcg_params_;  ///< matrix-free linear solves if set
+  gtdynamics::TimeBudget time_budget_;  ///< unlimited unless set
+  gtdynamics::TerminationReason termination_reason_ =
+      gtdynamics::TerminationReason::MAX_ITERATIONS;  ///< of the last optimize
 
   // startTime_ is a chrono time point
   std::chrono::time_point<std::chrono::high_resolution_clock>
@@ -110,10 +119,32 @@ class GTSAM_EXPORT MutableLMOptimizer : public NonlinearOptimizer {
 
   void setGraph(const NonlinearFactorGraph& graph, const Ordering& ordering);
 
+  /// Set the graph, with an elimination ordering of the given type.
+  void setGraph(const NonlinearFactorGraph& graph,
+                gtdynamics::OrderingType ordering_type);
+
   void setValues(Values&& values);
 
   void setValues(const Values& values);
 
+  /// Solve the linear systems by TrajectoryPCGSolver instead of elimination.
+  void setPCGParams(const gtdynamics::TrajectoryPCGParams& pcg_params) {
+    pcg_params_ = pcg_params;
+  }
+
+  /// Stop optimize() between iterations once the budget has expired.
+  void setTimeBudget(const gtdynamics::TimeBudget& time_budget) {
+    time_budget_ = time_budget;
+  }
+
+  /// Why the last call to optimize() stopped.
+  gtdynamics::TerminationReason terminationReason() const {
+    return termination_reason_;
+  }
+
+  /// Optimize until convergence, maximum iterations, or the time budget.
+  const Values& optimize() override;
+
   /// @name Advanced interface
   /// @{
 
@@ -128,6 +159,10 @@ class GTSAM_EXPORT MutableLMOptimizer : public NonlinearOptimizer {
 
   void writeLogFile(double currentError);
 
+  /** linear solve, by PCG if PCG parameters are set */
+  VectorValues solve(const GaussianFactorGraph& gfg,
+                     const NonlinearOptimizerParams& params) const override;
+
   /** linearize, can be overwritten */
   virtual GaussianFactorGraph::shared_ptr linearize() const;
 
@@ -161,4 +161,51 @@ Values OptimizeAugmentedLagrangian(const EqConsOptProblem& problem,
   return result;
 }
 
+/* ************************************************************************* */
+Values OptimizeWithParameters(const EqConsOptProblem& problem,
+                              std::ostream& latex_os,
+                              const OptimizationParameters& params,
+                              std::string exp_name,
+                              double constraint_unit_scale) {
+  // Count iterations, and still report them to the caller.
+  OptimizationParameters counted_params = params;
+  size_t num_iters = 0;
+  counted_params.progress_callback = [&](const SolveProgress& progress) {
+    num_iters++;
+    if (params.progress_callback) params.progress_callback(progress);
+  };
+  Optimizer optimizer(counted_params);
+
+  auto optimization_start = std::chrono::system_clock::now();
+  auto result = optimizer.optimize(problem.costs(), problem.constraints(),
+                                   problem.initValues());
+  auto optimization_end = std::chrono::system_clock::now();
+  auto optimization_time_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(optimization_end -
+                                                            optimization_start);
+  double optimization_time = optimization_time_ms.count() * 1e-3;
+
+  if (exp_name.empty()) {
+    switch (params.method) {
+      case OptimizationParameters::Method::SOFT_CONSTRAINTS:
+        exp_name = "Soft Constraint";
+        break;
+      case OptimizationParameters::Method::PENALTY:
+        exp_name = "Penalty Method";
+        break;
+      case OptimizationParameters::Method::AUGMENTED_LAGRANGIAN:
+        exp_name = "Augmented Lagrangian";
+        break;
+    }
+  }
+  PrintLatex(
+      latex_os, exp_name,
+      problem.costsDimension() + problem.constraintsDimension(),
+      problem.valuesDimension(), optimization_time, num_iters,
+      problem.evaluateConstraintViolationL2Norm(result) * constraint_unit_scale,
+      problem.evaluateCost(result));
+
+  return result;
+}
+
 }  // namespace gtdynamics
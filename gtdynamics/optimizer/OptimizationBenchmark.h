@@ -16,6 +16,7 @@
 #include <gtdynamics/manifold/ManifoldOptimizer.h>
 #include <gtdynamics/manifold/ManifoldOptimizerType1.h>
 #include <gtdynamics/optimizer/AugmentedLagrangianOptimizer.h>
+#include <gtdynamics/optimizer/Optimizer.h>
 #include <gtdynamics/optimizer/PenaltyMethodOptimizer.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
@@ -64,6 +65,18 @@ Values OptimizeAugmentedLagrangian(
     AugmentedLagrangianParameters params = AugmentedLagrangianParameters(),
     double constraint_unit_scale = 1.0);
 
+/**
+ * Run the optimizer that Optimizer dispatches to for the given parameters,
+ * e.g., those of a ProblemCapture, with all of them in effect. Iterations are
+ * those reported to the progress callback, and exp_name defaults to the name
+ * of the method.
+ */
+Values OptimizeWithParameters(const EqConsOptProblem &problem,
+                              std::ostream &latex_os,
+                              const OptimizationParameters &params,
+                              std::string exp_name = "",
+                              double constraint_unit_scale = 1.0);
+
 /** Functor version of JointLimitFactor, for creating expressions. Compute error
  * for joint limit error, to reproduce joint limit factor in expressions. */
 class JointLimitFunctor {
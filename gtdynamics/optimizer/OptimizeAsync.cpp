@@ -0,0 +1,30 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  OptimizeAsync.cpp
+ * @brief Run constrained optimizers asynchronously, with cancellation.
+ */
+
+#include <gtdynamics/optimizer/OptimizeAsync.h>
+
+namespace gtdynamics {
+
+/* ************************************************************************* */
+std::future<gtsam::Values> OptimizeAsync(
+    const std::shared_ptr<const ConstrainedOptimizer>& optimizer,
+    const gtsam::NonlinearFactorGraph& graph,
+    const EqualityConstraints& constraints,
+    const gtsam::Values& initial_values,
+    const std::shared_ptr<ConstrainedOptResult>& intermediate_result) {
+  return std::async(std::launch::async, [=]() {
+    return optimizer->optimize(graph, constraints, initial_values,
+                               intermediate_result.get());
+  });
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,62 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  OptimizeAsync.h
+ * @brief Run constrained optimizers asynchronously, with cancellation.
+ */
+
+#pragma once
+
+#include <gtdynamics/optimizer/ConstrainedOptimizer.h>
+
+#include <future>
+#include <memory>
+
+namespace gtdynamics {
+
+/**
+ * Run a constrained optimizer on its own thread. The problem is copied, so the
+ * arguments may go out of scope before the future is ready.
+ *
+ * To stop a stale solve, give the optimizer parameters a cancellation_token,
+ * and cancel it: the optimizer stops within its current iteration, and the
+ * future then holds its best iterate so far. Progress callbacks of the
+ * parameters are called on the optimizing thread.
+ *
+ * As the future comes from std::async, its destructor blocks until the
+ * optimizer returns, even if get() is never called. Cancel the token before
+ * discarding the future of a stale solve, or the discard waits for the whole
+ * solve.
+ *
+ * Example:
+ *   CancellationToken token;
+ *   PenaltyMethodParameters params;
+ *   params.cancellation_token = token;
+ *   params.progress_callback = [](const SolveProgress& progress) {...};
+ *   auto optimizer = std::make_shared<PenaltyMethodOptimizer>(params);
+ *   auto values = OptimizeAsync(optimizer, graph, constraints, init_values);
+ *   ...
+ *   token.cancel();  // e.g., when the goal changes
+ *   gtsam::Values result = values.get();
+ *
+ * @param optimizer optimizer, not to be used by other threads meanwhile.
+ * @param graph cost factors.
+ * @param constraints equality constraints.
+ * @param initial_values initial values of all variables.
+ * @param intermediate_result (optional) intermediate results, written by the
+ * optimizing thread, and to be read once the future is ready.
+ * @return future of the optimized values, or of the optimizer's exception.
+ */
+std::future<gtsam::Values> OptimizeAsync(
+    const std::shared_ptr<const ConstrainedOptimizer>& optimizer,
+    const gtsam::NonlinearFactorGraph& graph,
+    const EqualityConstraints& constraints,
+    const gtsam::Values& initial_values,
+    const std::shared_ptr<ConstrainedOptResult>& intermediate_result = nullptr);
+
+}  // namespace gtdynamics
@@ -12,41 +12,97 @@
  */
 
 #include <gtdynamics/optimizer/AugmentedLagrangianOptimizer.h>
+#include <gtdynamics/optimizer/ConstrainedOptimizer.h>
 #include <gtdynamics/optimizer/Optimizer.h>
 #include <gtdynamics/optimizer/PenaltyMethodOptimizer.h>
+#include <gtdynamics/optimizer/SchurCondensing.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
 namespace gtdynamics {
 
 using gtsam::NonlinearFactorGraph;
 using gtsam::Values;
 
+/// Graph with the constraints added as soft factors.
+static NonlinearFactorGraph MeritGraph(const NonlinearFactorGraph& graph,
+                                       const EqualityConstraints& constraints) {
+  auto merit_graph = graph;
+  for (const auto& constraint : constraints) {
+    merit_graph.add(constraint->createFactor(1.0));
+  }
+  return merit_graph;
+}
+
+gtsam::LevenbergMarquardtParams Optimizer::lmParameters(
+    const NonlinearFactorGraph& graph) const {
+  gtsam::LevenbergMarquardtParams lm_parameters = p_.lm_parameters;
+  if (auto ordering = TrajectoryOrdering(graph, p_.ordering_type)) {
+    lm_parameters.ordering = *ordering;
+  }
+  return lm_parameters;
+}
+
 Values Optimizer::optimize(const NonlinearFactorGraph& graph,
                            const Values& initial_values) const {
-  gtsam::LevenbergMarquardtOptimizer optimizer(graph, initial_values,
-                                               p_.lm_parameters);
-  const Values result = optimizer.optimize();
-  return result;
+  if (p_.condense && p_.pcg_parameters) {
+    throw std::invalid_argument(
+        "Optimizer: condense and pcg_parameters are exclusive.");
+  }
+  const TimeBudget budget(p_.time_budget, p_.cancellation_token);
+  const auto lm_parameters = lmParameters(graph);
+  std::unique_ptr<gtsam::LevenbergMarquardtOptimizer> optimizer;
+  if (p_.condense) {
+    optimizer = std::make_unique<CondensedLMOptimizer>(graph, initial_values,
+                                                       lm_parameters);
+  } else if (p_.pcg_parameters) {
+    optimizer = std::make_unique<PCGLMOptimizer>(
+        graph, initial_values, lm_parameters, *p_.pcg_parameters);
+  } else {
+    optimizer = std::make_unique<gtsam::LevenbergMarquardtOptimizer>(
+        graph, initial_values, lm_parameters);
+  }
+  std::function<void()> report_progress;
+  if (p_.progress_callback) {
+    report_progress = [&]() {
+      ReportProgress(p_.progress_callback, optimizer->iterations(), graph, {},
+                     optimizer->values(), budget);
+    };
+  }
+  IterateWithinBudget(optimizer.get(), lm_parameters, budget, nullptr, nullptr,
+                      report_progress);
+  return optimizer->values();
 }
 
 Values Optimizer::optimize(const gtsam::NonlinearFactorGraph& graph,
                            const EqualityConstraints& constraints,
                            const gtsam::Values& initial_values) const {
   if (p_.method == OptimizationParameters::Method::SOFT_CONSTRAINTS) {
-    auto merit_graph = graph;
-    for (const auto& constraint : constraints) {
-      merit_graph.add(constraint->createFactor(1.0));
-    }
-    return optimize(merit_graph, initial_values);
+    return optimize(MeritGraph(graph, constraints), initial_values);
 
   } else if (p_.method == OptimizationParameters::Method::PENALTY) {
-    PenaltyMethodParameters params = p_.lm_parameters;
+    PenaltyMethodParameters params(p_.lm_parameters);
+    params.ordering_type = p_.ordering_type;
+    params.condense = p_.condense;
+    params.pcg_parameters = p_.pcg_parameters;
+    params.time_budget = p_.time_budget;
+    params.cancellation_token = p_.cancellation_token;
+    params.progress_callback = p_.progress_callback;
     PenaltyMethodOptimizer optimizer(params);
     return optimizer.optimize(graph, constraints, initial_values);
 
   } else if (p_.method ==
              OptimizationParameters::Method::AUGMENTED_LAGRANGIAN) {
-    AugmentedLagrangianParameters params = p_.lm_parameters;
+    AugmentedLagrangianParameters params(p_.lm_parameters);
+    params.ordering_type = p_.ordering_type;
+    params.condense = p_.condense;
+    params.pcg_parameters = p_.pcg_parameters;
+    params.time_budget = p_.time_budget;
+    params.cancellation_token = p_.cancellation_token;
+    params.progress_callback = p_.progress_callback;
     AugmentedLagrangianOptimizer optimizer(params);
     return optimizer.optimize(graph, constraints, initial_values);
 
@@ -14,9 +14,14 @@
 #pragma once
 
 #include <gtdynamics/optimizer/EqualityConstraint.h>
+#include <gtdynamics/optimizer/TimeBudget.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
 #include <gtdynamics/universal_robot/Robot.h>
 #include <gtsam/nonlinear/LevenbergMarquardtParams.h>
 
+#include <optional>
+
 // Forward declarations.
 namespace gtsam {
 class NonlinearFactorGraph;
@@ -31,6 +36,12 @@ struct OptimizationParameters {
 
   Method method = Method::SOFT_CONSTRAINTS;       // optimization method
   gtsam::LevenbergMarquardtParams lm_parameters;  // LM parameters
+  OrderingType ordering_type = OrderingType::COLAMD;  // elimination ordering
+  bool condense = false;  // condense link variables, see SchurCondensing.h
+  std::optional<TrajectoryPCGParams> pcg_parameters;  // PCG solves if set
+  std::optional<double> time_budget;  // wall-clock seconds, unlimited if unset
+  std::optional<CancellationToken> cancellation_token;  // stops when cancelled
+  ProgressCallback progress_callback;  // called after each (outer) iteration
   OptimizationParameters() {
     lm_parameters.setlambdaInitial(1e7);
     lm_parameters.setAbsoluteErrorTol(1e-3);
@@ -42,6 +53,10 @@ class Optimizer {
  protected:
   const OptimizationParameters p_;
 
+  /// LM parameters, with the elimination ordering of the graph if any.
+  gtsam::LevenbergMarquardtParams lmParameters(
+      const gtsam::NonlinearFactorGraph& graph) const;
+
  public:
   /**
    * @fn Constructor.
@@ -12,6 +12,7 @@
  */
 
 #include <gtdynamics/optimizer/PenaltyMethodOptimizer.h>
+#include <gtdynamics/utils/Tracer.h>
 
 namespace gtdynamics {
 
@@ -21,10 +22,20 @@ gtsam::Values PenaltyMethodOptimizer::optimize(
     ConstrainedOptResult* intermediate_result) const {
   gtsam::Values values = initial_values;
   double mu = p_.initial_mu;
+  gtsam::LevenbergMarquardtParams lm_parameters;
+  const TimeBudget budget = p_.timeBudget();
+  BestIterate best;
+  best.update(graph, constraints, values);
+  TerminationReason reason = TerminationReason::MAX_ITERATIONS;
 
   // Solve the constrained optimization problem by solving a sequence of
   // unconstrained optimization problems.
   for (int i = 0; i < p_.num_iterations; i++) {
+    if (auto stop = budget.stop()) {
+      reason = *stop;
+      break;
+    }
+    TraceScope trace("PenaltyMethod_outer");
     gtsam::NonlinearFactorGraph merit_graph = graph;
 
     // Create factors corresponding to penalty terms of constraints.
@@ -33,9 +44,13 @@ gtsam::Values PenaltyMethodOptimizer::optimize(
     }
 
     // Run optimization.
-    gtsam::LevenbergMarquardtOptimizer optimizer(merit_graph, values,
-                                                 p_.lm_parameters);
-    auto result = optimizer.optimize();
+    if (i == 0) lm_parameters = p_.lmParameters(merit_graph);
+    auto optimizer = p_.lmOptimizer(merit_graph, values, lm_parameters);
+    const TerminationReason inner_reason =
+        IterateWithinBudget(optimizer.get(), lm_parameters, budget);
+    const gtsam::Values result = optimizer->values();
+    const bool converged = OuterIterationConverged(
+        lm_parameters, inner_reason, graph, constraints, values, result);
 
     // Save results and update parameters.
     values = result;
@@ -44,11 +59,34 @@ gtsam::Values PenaltyMethodOptimizer::optimize(
     /// Store intermediate results.
     if (intermediate_result != nullptr) {
       intermediate_result->intermediate_values.push_back(values);
-      intermediate_result->num_iters.push_back(optimizer.getInnerIterations());
+      intermediate_result->num_iters.push_back(optimizer->getInnerIterations());
       intermediate_result->mu_values.push_back(mu);
+      intermediate_result->iteration_times.push_back(budget.elapsed());
+    }
+    best.update(graph, constraints, values);
+    ReportProgress(p_.progress_callback, i + 1, graph, constraints, values,
+                   budget);
+    if (inner_reason == TerminationReason::TIME_BUDGET ||
+        inner_reason == TerminationReason::CANCELLED) {
+      reason = inner_reason;
+      break;
+    }
+    if (converged) {
+      reason = TerminationReason::CONVERGED;
+      break;
     }
   }
-  return values;
+
+  if (intermediate_result != nullptr) {
+    intermediate_result->termination_reason = reason;
+    intermediate_result->elapsed_time = budget.elapsed();
+  }
+  // Out of time or cancelled, the last iterate may be worse than an earlier
+  // one.
+  return reason == TerminationReason::MAX_ITERATIONS ||
+                 reason == TerminationReason::CONVERGED
+             ? values
+             : best.values();
 }
 
 }  // namespace gtdynamics
@@ -0,0 +1,82 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ProblemCapture.cpp
+ * @brief Capture of a complete optimization problem for offline replay.
+ */
+
+#include <gtdynamics/optimizer/ProblemCapture.h>
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+#include <gtsam/base/serialization.h>
+#endif
+
+#include <stdexcept>
+
+namespace gtdynamics {
+
+/* ************************************************************************* */
+ProblemCapture::ProblemCapture(const Robot &robot,
+                               const gtsam::NonlinearFactorGraph &costs,
+                               const EqualityConstraints &constraints,
+                               const gtsam::Values &initial_values,
+                               const OptimizationParameters &parameters)
+    : robot(robot),
+      costs(costs),
+      initial_values(initial_values),
+      parameters(parameters) {
+  for (const auto &constraint : constraints) {
+    auto factor_constraint =
+        std::dynamic_pointer_cast<FactorZeroErrorConstraint>(constraint);
+    if (!factor_constraint) {
+      throw std::runtime_error(
+          "ProblemCapture: only FactorZeroErrorConstraint can be captured.");
+    }
+    constraint_factors.push_back(factor_constraint->factor());
+    constraint_tolerances.push_back(factor_constraint->tolerance());
+  }
+}
+
+/* ************************************************************************* */
+EqualityConstraints ProblemCapture::constraints() const {
+  EqualityConstraints constraints;
+  for (size_t i = 0; i < constraint_factors.size(); i++) {
+    auto factor = std::dynamic_pointer_cast<gtsam::NoiseModelFactor>(
+        constraint_factors.at(i));
+    constraints.emplace_shared<FactorZeroErrorConstraint>(
+        factor, constraint_tolerances.at(i));
+  }
+  return constraints;
+}
+
+/* ************************************************************************* */
+gtsam::Values ProblemCapture::solve(
+    const OptimizationParameters &params) const {
+  Optimizer optimizer(params);
+  return optimizer.optimize(costs, constraints(), initial_values);
+}
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+/* ************************************************************************* */
+void ProblemCapture::save(const std::string &file_path) const {
+  if (!gtsam::serializeToBinaryFile(*this, file_path, "problem")) {
+    throw std::runtime_error("ProblemCapture: cannot write " + file_path);
+  }
+}
+
+/* ************************************************************************* */
+ProblemCapture ProblemCapture::Load(const std::string &file_path) {
+  ProblemCapture problem;
+  if (!gtsam::deserializeFromBinaryFile(file_path, problem, "problem")) {
+    throw std::runtime_error("ProblemCapture: cannot read " + file_path);
+  }
+  return problem;
+}
+#endif
+
+}  // namespace gtdynamics
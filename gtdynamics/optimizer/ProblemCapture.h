@@ -0,0 +1,193 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  ProblemCapture.h
+ * @brief Capture of a complete optimization problem for offline replay.
+ */
+
+#pragma once
+
+#include <gtdynamics/optimizer/ConstrainedOptimizer.h>
+#include <gtdynamics/optimizer/EqualityConstraint.h>
+#include <gtdynamics/optimizer/Optimizer.h>
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtsam/linear/NoiseModel.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+#include <gtsam/inference/Ordering.h>
+
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
+#endif
+
+namespace gtdynamics {
+
+/**
+ * A complete optimization problem: robot, cost graph, equality constraints,
+ * initial values and optimizer parameters, which can be written to a single
+ * binary file and re-run offline, e.g. with the gtdynamics_replay tool.
+ *
+ * The capture holds all optimizer parameters that influence the solve, so that
+ * a replay runs the same solver; the cancellation token and progress callback
+ * only make sense in the capturing process and are not saved.
+ *
+ * Only FactorZeroErrorConstraint constraints can be captured, as expression
+ * based constraints hold expression trees that cannot be serialized. As usual
+ * with boost serialization, every derived factor, value and joint type in the
+ * problem has to be registered with BOOST_CLASS_EXPORT in the program that
+ * saves or loads the capture.
+ */
+struct ProblemCapture {
+  Robot robot;
+  gtsam::NonlinearFactorGraph costs;
+  gtsam::NonlinearFactorGraph constraint_factors;  // one per constraint
+  std::vector<gtsam::Vector> constraint_tolerances;
+  gtsam::Values initial_values;
+  OptimizationParameters parameters;
+
+  /// Default constructor, only for deserialization.
+  ProblemCapture() {}
+
+  /**
+   * Capture a problem.
+   * @param robot the robot the problem was built for.
+   * @param costs cost factors.
+   * @param constraints equality constraints, must be FactorZeroErrorConstraint.
+   * @param initial_values initial values for all variables.
+   * @param parameters optimizer parameters used for the solve.
+   */
+  ProblemCapture(const Robot &robot, const gtsam::NonlinearFactorGraph &costs,
+                 const EqualityConstraints &constraints,
+                 const gtsam::Values &initial_values,
+                 const OptimizationParameters &parameters =
+                     OptimizationParameters());
+
+  /// Re-create the equality constraints.
+  EqualityConstraints constraints() const;
+
+  /// Return as an equality-constrained problem, e.g. for benchmarking.
+  EqConsOptProblem problem() const {
+    return EqConsOptProblem(costs, constraints(), initial_values);
+  }
+
+  /// Solve the captured problem with the given parameters.
+  gtsam::Values solve(const OptimizationParameters &params) const;
+
+  /// Solve the captured problem with the captured parameters.
+  gtsam::Values solve() const { return solve(parameters); }
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Write the problem to a binary file.
+  void save(const std::string &file_path) const;
+
+  /// Read a problem written by save().
+  static ProblemCapture Load(const std::string &file_path);
+
+  /** Serialization function */
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {
+    ar &BOOST_SERIALIZATION_NVP(robot);
+    ar &BOOST_SERIALIZATION_NVP(costs);
+    ar &BOOST_SERIALIZATION_NVP(constraint_factors);
+    ar &BOOST_SERIALIZATION_NVP(constraint_tolerances);
+    ar &BOOST_SERIALIZATION_NVP(initial_values);
+
+    // LevenbergMarquardtParams is not serializable, store the fields that
+    // influence the solve.
+    gtsam::LevenbergMarquardtParams &lm = parameters.lm_parameters;
+    ar &boost::serialization::make_nvp("method", parameters.method);
+    ar &boost::serialization::make_nvp("maxIterations", lm.maxIterations);
+    ar &boost::serialization::make_nvp("relativeErrorTol",
+                                       lm.relativeErrorTol);
+    ar &boost::serialization::make_nvp("absoluteErrorTol",
+                                       lm.absoluteErrorTol);
+    ar &boost::serialization::make_nvp("errorTol", lm.errorTol);
+    ar &boost::serialization::make_nvp("lambdaInitial", lm.lambdaInitial);
+    ar &boost::serialization::make_nvp("lambdaFactor", lm.lambdaFactor);
+    ar &boost::serialization::make_nvp("lambdaUpperBound",
+                                       lm.lambdaUpperBound);
+    ar &boost::serialization::make_nvp("lambdaLowerBound",
+                                       lm.lambdaLowerBound);
+    ar &boost::serialization::make_nvp("minModelFidelity",
+                                       lm.minModelFidelity);
+    ar &boost::serialization::make_nvp("diagonalDamping", lm.diagonalDamping);
+
+    // Version 1: linear solver and elimination ordering.
+    if (version >= 1) {
+      ar &boost::serialization::make_nvp("linearSolverType",
+                                         lm.linearSolverType);
+      ar &boost::serialization::make_nvp("orderingType", lm.orderingType);
+      ar &boost::serialization::make_nvp("useFixedLambdaFactor",
+                                         lm.useFixedLambdaFactor);
+      ar &boost::serialization::make_nvp("minDiagonal", lm.minDiagonal);
+      ar &boost::serialization::make_nvp("maxDiagonal", lm.maxDiagonal);
+      bool has_ordering = static_cast<bool>(lm.ordering);
+      gtsam::Ordering ordering =
+          has_ordering ? *lm.ordering : gtsam::Ordering();
+      ar &boost::serialization::make_nvp("hasOrdering", has_ordering);
+      ar &boost::serialization::make_nvp("ordering", ordering);
+      if (has_ordering) lm.ordering = ordering;
+    }
+
+    // Version 2: trajectory elimination ordering, see TrajectoryOrdering.
+    if (version >= 2) {
+      int ordering_type = static_cast<int>(parameters.ordering_type);
+      ar &boost::serialization::make_nvp("trajectoryOrderingType",
+                                         ordering_type);
+      parameters.ordering_type = static_cast<OrderingType>(ordering_type);
+    }
+
+    // Version 3: condensed linear solves, see SchurCondensing.
+    if (version >= 3) {
+      ar &boost::serialization::make_nvp("condense", parameters.condense);
+    }
+
+    // Version 4: PCG linear solves, see TrajectoryPCGSolver.
+    if (version >= 4) {
+      bool has_pcg = static_cast<bool>(parameters.pcg_parameters);
+      TrajectoryPCGParams pcg = parameters.pcg_parameters.value_or(
+          TrajectoryPCGParams());
+      int preconditioner = static_cast<int>(pcg.preconditioner);
+      ar &boost::serialization::make_nvp("hasPCG", has_pcg);
+      ar &boost::serialization::make_nvp("preconditioner", preconditioner);
+      ar &boost::serialization::make_nvp("pcgMaxIterations",
+                                         pcg.max_iterations);
+      ar &boost::serialization::make_nvp("pcgRelativeTolerance",
+                                         pcg.relative_tolerance);
+      pcg.preconditioner =
+          static_cast<TrajectoryPCGParams::Preconditioner>(preconditioner);
+      parameters.pcg_parameters =
+          has_pcg ? std::optional<TrajectoryPCGParams>(pcg) : std::nullopt;
+    }
+
+    // Version 5: wall-clock budget, see TimeBudget.
+    if (version >= 5) {
+      bool has_time_budget = static_cast<bool>(parameters.time_budget);
+      double time_budget = parameters.time_budget.value_or(0.0);
+      ar &boost::serialization::make_nvp("hasTimeBudget", has_time_budget);
+      ar &boost::serialization::make_nvp("timeBudget", time_budget);
+      parameters.time_budget =
+          has_time_budget ? std::optional<double>(time_budget) : std::nullopt;
+    }
+  }
+#endif
+};
+
+}  // namespace gtdynamics
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+// Bump when serialize() saves more fields, e.g. new optimizer parameters.
+BOOST_CLASS_VERSION(gtdynamics::ProblemCapture, 5)
+#endif
@@ -0,0 +1,157 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SchurCondensing.cpp
+ * @brief Condense the per-step dynamics variables of a linearized trajectory
+ * by Schur complement, before the global solve.
+ */
+
+#include <gtdynamics/optimizer/SchurCondensing.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/Parallel.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace gtdynamics {
+
+using gtsam::GaussianBayesNet;
+using gtsam::GaussianFactorGraph;
+using gtsam::KeySet;
+using gtsam::Ordering;
+using gtsam::VectorValues;
+
+/* ************************************************************************* */
+CondensedGraph Condense(const GaussianFactorGraph &graph,
+                        const std::set<std::string> &labels,
+                        size_t num_threads) {
+  // Keep the variables that a factor couples across time steps.
+  KeySet coupled;
+  for (auto &&factor : graph) {
+    if (!factor) continue;
+    std::set<uint64_t> steps;
+    for (auto &&key : factor->keys()) {
+      const DynamicsSymbol symbol(key);
+      if (labels.count(symbol.label())) steps.insert(symbol.time());
+    }
+    if (steps.size() < 2) continue;
+    for (auto &&key : factor->keys()) {
+      if (labels.count(DynamicsSymbol(key).label())) coupled.insert(key);
+    }
+  }
+  auto is_condensed = [&](gtsam::Key key) {
+    return labels.count(DynamicsSymbol(key).label()) && !coupled.exists(key);
+  };
+
+  // Group the factors on condensed variables by time step.
+  std::map<uint64_t, size_t> step_groups;
+  std::vector<GaussianFactorGraph> groups;
+  std::vector<KeySet> group_keys;
+  CondensedGraph condensed;
+  for (auto &&factor : graph) {
+    if (!factor) continue;
+    std::optional<uint64_t> step;
+    for (auto &&key : factor->keys()) {
+      if (is_condensed(key)) step = DynamicsSymbol(key).time();
+    }
+    if (!step) {
+      condensed.reduced.push_back(factor);
+      continue;
+    }
+    auto it = step_groups.emplace(*step, groups.size()).first;
+    if (it->second == groups.size()) {
+      groups.emplace_back();
+      group_keys.emplace_back();
+    }
+    groups[it->second].push_back(factor);
+    for (auto &&key : factor->keys()) {
+      if (is_condensed(key)) group_keys[it->second].insert(key);
+    }
+  }
+
+  // Schur complement of each step, in parallel.
+  std::vector<GaussianFactorGraph::shared_ptr> remaining(groups.size());
+  condensed.conditionals.resize(groups.size());
+  ParallelFor(
+      groups.size(),
+      [&](size_t i) {
+        const Ordering ordering(group_keys[i].begin(), group_keys[i].end());
+        std::tie(condensed.conditionals[i], remaining[i]) =
+            groups[i].eliminatePartialSequential(ordering);
+      },
+      num_threads);
+  for (auto &&factors : remaining) condensed.reduced.push_back(*factors);
+  return condensed;
+}
+
+/* ************************************************************************* */
+VectorValues BackSubstitute(const CondensedGraph &condensed,
+                            const VectorValues &reduced_solution,
+                            size_t num_threads) {
+  std::vector<VectorValues> step_solutions(condensed.conditionals.size());
+  ParallelFor(
+      condensed.conditionals.size(),
+      [&](size_t i) {
+        const GaussianBayesNet &bayes_net = *condensed.conditionals[i];
+        // Conditionals are solved in reverse elimination order, each given
+        // the reduced variables and the condensed ones solved before it.
+        VectorValues &x = step_solutions[i];
+        for (size_t j = bayes_net.size(); j-- > 0;) {
+          const auto &conditional = bayes_net.at(j);
+          for (auto it = conditional->beginParents();
+               it != conditional->endParents(); ++it) {
+            if (!x.exists(*it)) x.insert(*it, reduced_solution.at(*it));
+          }
+          x.insert(conditional->solve(x));
+        }
+      },
+      num_threads);
+
+  VectorValues solution = reduced_solution;
+  for (size_t i = 0; i < step_solutions.size(); i++) {
+    for (auto &&conditional : *condensed.conditionals[i]) {
+      for (auto it = conditional->beginFrontals();
+           it != conditional->endFrontals(); ++it) {
+        solution.insert(*it, step_solutions[i].at(*it));
+      }
+    }
+  }
+  return solution;
+}
+
+/* ************************************************************************* */
+VectorValues SolveCondensed(const GaussianFactorGraph &graph,
+                            const Ordering &ordering,
+                            const std::set<std::string> &labels,
+                            size_t num_threads) {
+  const CondensedGraph condensed = Condense(graph, labels, num_threads);
+  VectorValues reduced_solution;
+  if (ordering.empty()) {
+    reduced_solution = condensed.reduced.optimize();
+  } else {
+    const KeySet reduced_keys = condensed.reduced.keys();
+    Ordering reduced_ordering;
+    for (auto &&key : ordering) {
+      if (reduced_keys.exists(key)) reduced_ordering.push_back(key);
+    }
+    reduced_solution = condensed.reduced.optimize(reduced_ordering);
+  }
+  return BackSubstitute(condensed, reduced_solution, num_threads);
+}
+
+/* ************************************************************************* */
+VectorValues CondensedLMOptimizer::solve(
+    const GaussianFactorGraph &gfg,
+    const gtsam::NonlinearOptimizerParams &params) const {
+  return SolveCondensed(gfg, params.ordering ? *params.ordering : Ordering(),
+                        labels_, num_threads_);
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SchurCondensing.h
+ * @brief Condense the per-step dynamics variables of a linearized trajectory
+ * by Schur complement, before the global solve.
+ */
+
+#pragma once
+
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/linear/GaussianBayesNet.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Default labels of the variables local to a time step: link poses, twists,
+/// twist accelerations and wrenches, which only the kinematics and dynamics
+/// factors of their step constrain, unless the links are collocated. Joint
+/// accelerations remain, as the collocation factors couple them across steps.
+const std::set<std::string> kCondensedLabels = {"p", "V", "A", "F"};
+
+/// A linear system with the local variables of each step eliminated.
+struct CondensedGraph {
+  /// Factors on the remaining variables, e.g., joint angles, velocities,
+  /// accelerations and torques, and the variables coupled across steps.
+  gtsam::GaussianFactorGraph reduced;
+
+  /// Conditionals of the local variables of each step on the remaining ones.
+  std::vector<gtsam::GaussianBayesNet::shared_ptr> conditionals;
+};
+
+/**
+ * @fn Eliminate the variables of each time step whose label is in `labels`,
+ * e.g., link poses, twists, twist accelerations and wrenches, which only
+ * appear in factors of their own step. Each step is a Schur complement of its
+ * own factors, so the steps are condensed in parallel. Variables that a
+ * factor couples with those of another step, e.g., the poses and twists of a
+ * floating base in pose and twist collocation factors, are not local to their
+ * step and remain in the reduced graph.
+ * @param graph linearized trajectory graph, with keys encoded as
+ * DynamicsSymbol.
+ * @param labels labels of the variables to condense.
+ * @param num_threads maximum number of threads, 0 for hardware concurrency.
+ */
+CondensedGraph Condense(const gtsam::GaussianFactorGraph &graph,
+                        const std::set<std::string> &labels = kCondensedLabels,
+                        size_t num_threads = 0);
+
+/**
+ * @fn Recover the condensed variables from a solution of the reduced graph.
+ * @param condensed the condensed graph.
+ * @param reduced_solution solution of condensed.reduced.
+ * @param num_threads maximum number of threads, 0 for hardware concurrency.
+ * @return the solution of all variables.
+ */
+gtsam::VectorValues BackSubstitute(const CondensedGraph &condensed,
+                                   const gtsam::VectorValues &reduced_solution,
+                                   size_t num_threads = 0);
+
+/**
+ * @fn Solve a linearized trajectory graph by condensing, solving the reduced
+ * graph, and back-substituting.
+ * @param graph linearized trajectory graph.
+ * @param ordering elimination ordering of the graph, restricted to the
+ * reduced variables, or empty for COLAMD on the reduced graph.
+ * @param labels labels of the variables to condense.
+ * @param num_threads maximum number of threads, 0 for hardware concurrency.
+ */
+gtsam::VectorValues SolveCondensed(
+    const gtsam::GaussianFactorGraph &graph,
+    const gtsam::Ordering &ordering = gtsam::Ordering(),
+    const std::set<std::string> &labels = kCondensedLabels,
+    size_t num_threads = 0);
+
+/**
+ * Levenberg-Marquardt optimizer whose linear solves condense the per-step
+ * dynamics variables first, see SolveCondensed.
+ */
+class CondensedLMOptimizer : public gtsam::LevenbergMarquardtOptimizer {
+ private:
+  std::set<std::string> labels_;
+  size_t num_threads_;
+
+ public:
+  /**
+   * Constructor.
+   * @param graph nonlinear trajectory graph.
+   * @param initial_values initial values.
+   * @param params LM parameters.
+   * @param labels labels of the variables to condense.
+   * @param num_threads maximum number of threads, 0 for hardware concurrency.
+   */
+  CondensedLMOptimizer(const gtsam::NonlinearFactorGraph &graph,
+                       const gtsam::Values &initial_values,
+                       const gtsam::LevenbergMarquardtParams &params =
+                           gtsam::LevenbergMarquardtParams(),
+                       const std::set<std::string> &labels = kCondensedLabels,
+                       size_t num_threads = 0)
+      : gtsam::LevenbergMarquardtOptimizer(graph, initial_values, params),
+        labels_(labels),
+        num_threads_(num_threads) {}
+
+  /// Linear solve by condensing.
+  gtsam::VectorValues solve(
+      const gtsam::GaussianFactorGraph &gfg,
+      const gtsam::NonlinearOptimizerParams &params) const override;
+};
+
+}  // namespace gtdynamics
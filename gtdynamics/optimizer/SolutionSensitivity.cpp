@@ -0,0 +1,173 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SolutionSensitivity.cpp
+ * @brief Derivatives of the solution of a factor graph w.r.t. problem
+ * parameters, by the implicit function theorem.
+ */
+
+#include <gtdynamics/optimizer/SolutionSensitivity.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gtdynamics {
+
+using gtsam::GaussianBayesNet;
+using gtsam::GaussianFactorGraph;
+using gtsam::JacobianFactor;
+using gtsam::Key;
+using gtsam::Matrix;
+using gtsam::NonlinearFactor;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Values;
+using gtsam::Vector;
+using gtsam::VectorValues;
+
+/// Linear factor as a JacobianFactor.
+static JacobianFactor::shared_ptr AsJacobian(
+    const gtsam::GaussianFactor::shared_ptr &linear) {
+  if (auto jacobian = std::dynamic_pointer_cast<JacobianFactor>(linear)) {
+    return jacobian;
+  }
+  if (auto hessian = std::dynamic_pointer_cast<gtsam::HessianFactor>(linear)) {
+    return std::make_shared<JacobianFactor>(*hessian);
+  }
+  throw std::invalid_argument(
+      "SolutionSensitivity: unsupported linear factor type.");
+}
+
+/// Whitened error of a factor, consistent with its linearization.
+static Vector WhitenedError(const NonlinearFactor::shared_ptr &factor,
+                            const Values &values) {
+  if (auto noise_factor =
+          std::dynamic_pointer_cast<gtsam::NoiseModelFactor>(factor)) {
+    return noise_factor->whitenedError(values);
+  }
+  return -AsJacobian(factor->linearize(values))->getb();
+}
+
+/* ************************************************************************* */
+std::vector<Matrix> SolutionSensitivity::ErrorJacobians(
+    const GraphFunction &graph_function, const Vector &theta,
+    const Values &solution, double step) {
+  const size_t num_parameters = theta.size();
+  const NonlinearFactorGraph graph = graph_function(theta);
+  std::vector<Matrix> error_jacobians(graph.size());
+  for (size_t i = 0; i < num_parameters; i++) {
+    Vector theta_plus = theta, theta_minus = theta;
+    theta_plus(i) += step;
+    theta_minus(i) -= step;
+    const NonlinearFactorGraph graph_plus = graph_function(theta_plus);
+    const NonlinearFactorGraph graph_minus = graph_function(theta_minus);
+    if (graph_plus.size() != graph.size() ||
+        graph_minus.size() != graph.size()) {
+      throw std::invalid_argument(
+          "SolutionSensitivity: the graph function has to build the same "
+          "factors for all parameters.");
+    }
+    for (size_t f = 0; f < graph.size(); f++) {
+      if (!graph[f]) continue;
+      const Vector column = (WhitenedError(graph_plus[f], solution) -
+                             WhitenedError(graph_minus[f], solution)) /
+                            (2 * step);
+      if (column.isZero(0.0)) continue;
+      if (error_jacobians[f].size() == 0) {
+        error_jacobians[f] = Matrix::Zero(column.size(), num_parameters);
+      }
+      error_jacobians[f].col(i) = column;
+    }
+  }
+  return error_jacobians;
+}
+
+/* ************************************************************************* */
+SolutionSensitivity::SolutionSensitivity(
+    const GaussianFactorGraph &linear, const GaussianBayesNet &bayes_net,
+    const std::vector<Matrix> &error_jacobians, const Vector &theta,
+    const Values &solution)
+    : solution_(solution), theta_(theta) {
+  computeJacobians(linear, bayes_net, error_jacobians);
+}
+
+/* ************************************************************************* */
+SolutionSensitivity::SolutionSensitivity(const GraphFunction &graph_function,
+                                         const Vector &theta,
+                                         const Values &solution, double step)
+    : solution_(solution), theta_(theta) {
+  const std::vector<Matrix> error_jacobians =
+      ErrorJacobians(graph_function, theta, solution, step);
+  const GaussianFactorGraph linear =
+      *graph_function(theta).linearize(solution);
+  computeJacobians(linear, *linear.eliminateSequential(), error_jacobians);
+}
+
+/* ************************************************************************* */
+void SolutionSensitivity::computeJacobians(
+    const GaussianFactorGraph &linear, const GaussianBayesNet &bayes_net,
+    const std::vector<Matrix> &error_jacobians) {
+  if (error_jacobians.size() != linear.size()) {
+    throw std::invalid_argument(
+        "SolutionSensitivity: one error Jacobian per factor is required.");
+  }
+  const size_t num_parameters = theta_.size();
+  std::vector<std::pair<JacobianFactor::shared_ptr, Matrix>> dependent;
+  for (size_t f = 0; f < linear.size(); f++) {
+    if (!linear[f] || error_jacobians[f].size() == 0) continue;
+    dependent.emplace_back(AsJacobian(linear[f]), error_jacobians[f]);
+  }
+
+  VectorValues zero;
+  for (auto &&conditional : bayes_net) {
+    for (auto it = conditional->beginFrontals();
+         it != conditional->endFrontals(); ++it) {
+      zero.insert(*it, Vector::Zero(conditional->getDim(it)));
+    }
+  }
+  for (Key key : solution_.keys()) {
+    jacobians_[key] = Matrix::Zero(solution_.at(key).dim(), num_parameters);
+  }
+
+  // Each column solves R' R dx = -J' de/dtheta_i by two triangular solves.
+  for (size_t i = 0; i < num_parameters; i++) {
+    VectorValues gradient = zero;
+    for (auto &&[jacobian, error_jacobian] : dependent) {
+      for (auto it = jacobian->begin(); it != jacobian->end(); ++it) {
+        gradient.at(*it) +=
+            jacobian->getA(it).transpose() * error_jacobian.col(i);
+      }
+    }
+    const VectorValues x =
+        bayes_net.backSubstitute(bayes_net.backSubstituteTranspose(gradient));
+    for (auto &&[key, value] : x) jacobians_.at(key).col(i) = -value;
+  }
+}
+
+/* ************************************************************************* */
+VectorValues SolutionSensitivity::delta(const Vector &dtheta) const {
+  if (static_cast<size_t>(dtheta.size()) != numParameters()) {
+    throw std::invalid_argument(
+        "SolutionSensitivity: wrong number of parameters.");
+  }
+  VectorValues delta;
+  for (auto &&[key, jacobian] : jacobians_) {
+    delta.insert(key, jacobian * dtheta);
+  }
+  return delta;
+}
+
+/* ************************************************************************* */
+Values SolutionSensitivity::update(const Vector &theta) const {
+  return solution_.retract(delta(theta - theta_));
+}
+
+}  // namespace gtdynamics
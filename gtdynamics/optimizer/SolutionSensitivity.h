@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SolutionSensitivity.h
+ * @brief Derivatives of the solution of a factor graph w.r.t. problem
+ * parameters, by the implicit function theorem.
+ */
+
+#pragma once
+
+#include <gtsam/linear/GaussianBayesNet.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * Sensitivity of the minimizer x* of a factor graph to parameters theta of the
+ * factors, e.g., prior means, PointGoalFactor targets, or the time step of a
+ * trajectory. At x*, the gradient of the cost, J' e(x*, theta), vanishes, and
+ * to first order with Gauss-Newton Hessians, this stays so for
+ *   dx/dtheta = -(J' J)^{-1} J' de/dtheta.
+ *
+ * With R' R = J' J the factorization of the converged graph, e.g., the Bayes
+ * net of the final linear solve, every column of dx/dtheta takes two
+ * triangular solves, so that small parameter changes become first-order
+ * updates instead of new solves. The whitened error Jacobians de/dtheta are
+ * not part of the linearization: GTSAM factors are only differentiable in
+ * their variables, so ErrorJacobians obtains them by central differences of
+ * the errors of a graph function.
+ *
+ * The linearized graph has to be well-determined at x*. Constraints have to be
+ * part of the graph as soft factors, e.g., as the merit factors of a penalty
+ * method, since constrained noise models are not whitened.
+ */
+class SolutionSensitivity {
+ public:
+  /// Factor graph as a function of the parameters.
+  using GraphFunction =
+      std::function<gtsam::NonlinearFactorGraph(const gtsam::Vector &)>;
+
+ private:
+  gtsam::Values solution_;
+  gtsam::Vector theta_;
+  std::map<gtsam::Key, gtsam::Matrix> jacobians_;
+
+ public:
+  /**
+   * Constructor from the final linearization and factorization of a converged
+   * graph, without relinearizing.
+   * @param linear graph linearized at the solution.
+   * @param bayes_net elimination of linear, e.g., linear.eliminateSequential().
+   * @param error_jacobians whitened error Jacobians de/dtheta of the factors of
+   * linear, in the same order, empty for factors independent of theta.
+   * @param theta parameters the solution was obtained for.
+   * @param solution minimizer of the graph.
+   */
+  SolutionSensitivity(const gtsam::GaussianFactorGraph &linear,
+                      const gtsam::GaussianBayesNet &bayes_net,
+                      const std::vector<gtsam::Matrix> &error_jacobians,
+                      const gtsam::Vector &theta,
+                      const gtsam::Values &solution);
+
+  /**
+   * Constructor, which linearizes and factorizes the graph at the solution.
+   * @param graph_function factor graph as a function of the parameters.
+   * @param theta parameters the solution was obtained for.
+   * @param solution minimizer of graph_function(theta).
+   * @param step step size of the central differences in theta.
+   */
+  SolutionSensitivity(const GraphFunction &graph_function,
+                      const gtsam::Vector &theta,
+                      const gtsam::Values &solution, double step = 1e-6);
+
+  /**
+   * Whitened error Jacobians de/dtheta of the factors of graph_function(theta)
+   * at the solution, by central differences.
+   * @throws std::invalid_argument if the graph function does not build the
+   * same factors, in the same order, for every theta.
+   * @return one matrix per factor, empty for factors independent of theta.
+   */
+  static std::vector<gtsam::Matrix> ErrorJacobians(
+      const GraphFunction &graph_function, const gtsam::Vector &theta,
+      const gtsam::Values &solution, double step = 1e-6);
+
+  /// Number of parameters.
+  size_t numParameters() const { return theta_.size(); }
+
+  /// Derivative of the tangent vector of a variable w.r.t. the parameters.
+  const gtsam::Matrix &jacobian(gtsam::Key key) const {
+    return jacobians_.at(key);
+  }
+
+  /// Derivatives of all variables, as dim(key) x numParameters() matrices.
+  const std::map<gtsam::Key, gtsam::Matrix> &jacobians() const {
+    return jacobians_;
+  }
+
+  /// First-order change of the solution, in the tangent space, for dtheta.
+  gtsam::VectorValues delta(const gtsam::Vector &dtheta) const;
+
+  /// First-order solution for new parameters.
+  gtsam::Values update(const gtsam::Vector &theta) const;
+
+ private:
+  /// Solve for dx/dtheta with the factorization of the linearized graph.
+  void computeJacobians(const gtsam::GaussianFactorGraph &linear,
+                        const gtsam::GaussianBayesNet &bayes_net,
+                        const std::vector<gtsam::Matrix> &error_jacobians);
+};
+
+}  // namespace gtdynamics
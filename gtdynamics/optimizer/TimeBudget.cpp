@@ -0,0 +1,58 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TimeBudget.cpp
+ * @brief Wall-clock budgets, cancellation and progress reports for anytime
+ * optimization.
+ */
+
+#include <gtdynamics/optimizer/ConstrainedOptimizer.h>
+#include <gtdynamics/optimizer/TimeBudget.h>
+
+namespace gtdynamics {
+
+/* ************************************************************************* */
+TerminationReason IterateWithinBudget(
+    gtsam::NonlinearOptimizer *optimizer,
+    const gtsam::NonlinearOptimizerParams &params, const TimeBudget &budget,
+    ConstrainedOptResult *intermediate_result, gtsam::Values *last_complete,
+    const std::function<void()> &on_iteration) {
+  if (!budget.limited() && !on_iteration) {
+    optimizer->optimize();
+    if (last_complete) *last_complete = optimizer->values();
+    return optimizer->iterations() >= params.maxIterations
+               ? TerminationReason::MAX_ITERATIONS
+               : TerminationReason::CONVERGED;
+  }
+
+  if (last_complete) *last_complete = optimizer->values();
+  double new_error = optimizer->error();
+  if (new_error <= params.errorTol) return TerminationReason::CONVERGED;
+  while (true) {
+    if (auto stop = budget.stop()) return *stop;
+    const double current_error = new_error;
+    optimizer->iterate();
+    new_error = optimizer->error();
+    if (intermediate_result) {
+      intermediate_result->iteration_times.push_back(budget.elapsed());
+    }
+    if (auto stop = budget.stop()) return *stop;
+    if (last_complete) *last_complete = optimizer->values();
+    if (on_iteration) on_iteration();
+    if (gtsam::checkConvergence(params.relativeErrorTol,
+                                params.absoluteErrorTol, params.errorTol,
+                                current_error, new_error)) {
+      return TerminationReason::CONVERGED;
+    }
+    if (optimizer->iterations() >= params.maxIterations) {
+      return TerminationReason::MAX_ITERATIONS;
+    }
+  }
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TimeBudget.h
+ * @brief Wall-clock budgets, cancellation and progress reports for anytime
+ * optimization.
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearOptimizer.h>
+#include <gtsam/nonlinear/NonlinearOptimizerParams.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace gtdynamics {
+
+struct ConstrainedOptResult;
+
+/// Why an optimizer stopped.
+enum class TerminationReason {
+  CONVERGED,       // error tolerances reached
+  MAX_ITERATIONS,  // iteration count reached
+  TIME_BUDGET,     // wall-clock budget exhausted
+  CANCELLED        // cancellation token cancelled
+};
+
+/**
+ * Token to cancel an optimization from another thread. Copies share the same
+ * state, so the caller keeps one copy and hands the other to the optimizer.
+ */
+class CancellationToken {
+  std::shared_ptr<std::atomic<bool>> cancelled_ =
+      std::make_shared<std::atomic<bool>>(false);
+
+ public:
+  /// Request the optimization to stop, after its current iteration.
+  void cancel() const { cancelled_->store(true); }
+
+  /// Whether cancellation has been requested.
+  bool cancelled() const { return cancelled_->load(); }
+};
+
+/// Progress of an optimization, reported after each of its iterations.
+struct SolveProgress {
+  size_t iteration = 0;               // number of iterations so far
+  double cost = 0.0;                  // cost of the current iterate
+  double constraint_violation = 0.0;  // L2 norm of tolerance-scaled violation
+  double elapsed_time = 0.0;          // wall-clock seconds since the start
+};
+
+/// Called by the optimizers after each iteration, on the optimizing thread.
+using ProgressCallback = std::function<void(const SolveProgress &)>;
+
+/**
+ * Wall-clock budget of an optimization, which starts on construction, and
+ * optional cancellation token. Copies share the same deadline and token, so
+ * that nested solves, e.g., retractions inside a manifold optimizer, stop with
+ * the outer one.
+ */
+class TimeBudget {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  Clock::time_point start_;
+  std::optional<double> seconds_;
+  std::optional<CancellationToken> token_;
+
+ public:
+  /// Start a budget of the given number of seconds, unlimited if not given.
+  explicit TimeBudget(const std::optional<double> &seconds = {},
+                      const std::optional<CancellationToken> &token = {})
+      : start_(Clock::now()), seconds_(seconds), token_(token) {}
+
+  /// Whether the budget may stop an optimization early at all.
+  bool limited() const { return seconds_ || token_; }
+
+  /// Seconds elapsed since the start.
+  double elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - start_).count();
+  }
+
+  /// Whether the budget has been used up.
+  bool expired() const { return seconds_ && elapsed() >= *seconds_; }
+
+  /// Whether the optimization has been cancelled.
+  bool cancelled() const { return token_ && token_->cancelled(); }
+
+  /// Why the optimization has to stop now, if it has to.
+  std::optional<TerminationReason> stop() const {
+    if (cancelled()) return TerminationReason::CANCELLED;
+    if (expired()) return TerminationReason::TIME_BUDGET;
+    return {};
+  }
+};
+
+/**
+ * Iterate a gtsam nonlinear optimizer as its optimize() does, until the error
+ * tolerances or the maximum number of iterations of `params` are reached, but
+ * also stop when the budget has expired or been cancelled, which is checked
+ * between iterations. With an unlimited budget and no on_iteration, this
+ * simply calls optimize().
+ * @param optimizer optimizer, whose values are the result.
+ * @param params parameters the optimizer was constructed with.
+ * @param budget time budget.
+ * @param intermediate_result (optional) appends the elapsed time after each
+ * iteration to its iteration_times.
+ * @param last_complete (optional) values of the last iteration that finished
+ * within the budget, as the iteration that ran over may have been cut short.
+ * @param on_iteration (optional) called after each complete iteration.
+ * @return reason of the termination.
+ */
+TerminationReason IterateWithinBudget(
+    gtsam::NonlinearOptimizer *optimizer,
+    const gtsam::NonlinearOptimizerParams &params, const TimeBudget &budget,
+    ConstrainedOptResult *intermediate_result = nullptr,
+    gtsam::Values *last_complete = nullptr,
+    const std::function<void()> &on_iteration = nullptr);
+
+}  // namespace gtdynamics
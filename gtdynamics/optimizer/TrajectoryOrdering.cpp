@@ -0,0 +1,128 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TrajectoryOrdering.cpp
+ * @brief Elimination orderings that exploit the time structure of trajectory
+ * factor graphs.
+ */
+
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/TimeIndex.h>
+#include <gtsam/config.h>
+
+#include <map>
+#include <optional>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::KeyVector;
+using gtsam::Ordering;
+
+namespace {
+
+/// Rank of each variable type within a time step.
+const std::map<std::string, int> kLabelRanks = {
+    {"C", 0}, {"F", 0}, {"T", 0},  // wrenches and torques
+    {"a", 1}, {"A", 1},            // accelerations
+    {"v", 2}, {"V", 2},            // velocities and twists
+    {"q", 3}, {"p", 3}, {"t", 3},  // joint angles, poses and times
+};
+constexpr int kNumRanks = 4;
+
+/// Append the keys of time step k, in rank order.
+void AppendStep(const TimeIndex &index, size_t k, Ordering *ordering) {
+  for (int rank = 0; rank < kNumRanks; rank++) {
+    for (auto &&[label, label_rank] : kLabelRanks) {
+      if (label_rank != rank) continue;
+      for (auto &&key : index.keys(k, label)) ordering->push_back(key);
+    }
+  }
+  // Any other variable type last.
+  for (auto &&key : index.keys(k)) {
+    if (!kLabelRanks.count(DynamicsSymbol(key).label())) {
+      ordering->push_back(key);
+    }
+  }
+}
+
+/// Append steps first..last by nested dissection.
+void AppendDissection(const TimeIndex &index, size_t first, size_t last,
+                      Ordering *ordering) {
+  if (last < first + 2) {
+    for (size_t k = first; k <= last; k++) AppendStep(index, k, ordering);
+    return;
+  }
+  const size_t middle = (first + last) / 2;
+  AppendDissection(index, first, middle - 1, ordering);
+  AppendDissection(index, middle + 1, last, ordering);
+  AppendStep(index, middle, ordering);
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+Ordering TimeOrdering(const KeyVector &keys) {
+  const TimeIndex index(keys);
+  Ordering ordering;
+  for (size_t k = index.firstStep(); k < index.firstStep() + index.numSteps();
+       k++) {
+    AppendStep(index, k, &ordering);
+  }
+  for (auto &&key : index.untimedKeys()) ordering.push_back(key);
+  return ordering;
+}
+
+/* ************************************************************************* */
+Ordering NestedDissectionTimeOrdering(const KeyVector &keys) {
+  const TimeIndex index(keys);
+  Ordering ordering;
+  if (index.numSteps() > 0) {
+    AppendDissection(index, index.firstStep(), index.lastStep(), &ordering);
+  }
+  for (auto &&key : index.untimedKeys()) ordering.push_back(key);
+  return ordering;
+}
+
+/* ************************************************************************* */
+bool IsTrajectory(const KeyVector &keys) {
+  std::optional<uint64_t> first_step;
+  bool multiple_steps = false;
+  for (auto &&key : keys) {
+    const DynamicsSymbol symbol(key);
+    const std::string label = symbol.label();
+    if (label == "dt") continue;
+    if (!kLabelRanks.count(label)) return false;
+    if (!first_step) first_step = symbol.time();
+    if (symbol.time() != *first_step) multiple_steps = true;
+  }
+  return multiple_steps;
+}
+
+/* ************************************************************************* */
+std::optional<Ordering> TrajectoryOrdering(
+    const gtsam::NonlinearFactorGraph &graph, OrderingType type) {
+  if (type == OrderingType::COLAMD) return {};
+  const KeyVector keys = graph.keyVector();
+  if (type == OrderingType::AUTOMATIC) {
+    if (!IsTrajectory(keys)) return {};
+#ifdef GTSAM_USE_TBB
+    // gtsam eliminates independent subtrees of the Bayes tree in parallel.
+    type = OrderingType::NESTED_DISSECTION;
+#else
+    type = OrderingType::TIME;
+#endif
+  }
+  if (type == OrderingType::NESTED_DISSECTION) {
+    return NestedDissectionTimeOrdering(keys);
+  }
+  return TimeOrdering(keys);
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,66 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TrajectoryOrdering.h
+ * @brief Elimination orderings that exploit the time structure of trajectory
+ * factor graphs.
+ */
+
+#pragma once
+
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+
+#include <optional>
+
+namespace gtdynamics {
+
+/// Elimination ordering used by the optimizers.
+enum class OrderingType {
+  COLAMD,             // gtsam default, structure agnostic
+  TIME,               // time steps in increasing order
+  NESTED_DISSECTION,  // nested dissection over time steps
+  AUTOMATIC           // for trajectory graphs, NESTED_DISSECTION if gtsam
+                      // eliminates in parallel, else TIME; COLAMD otherwise
+};
+
+/**
+ * @fn Order the keys of a trajectory by increasing time step. Within a step,
+ * wrenches and torques come first, then accelerations, then twists and joint
+ * velocities, then poses and joint angles. Keys indexed by phase rather than
+ * time step, e.g., PhaseKey, come last as they couple many steps.
+ * As factors only couple neighboring steps, the fill-in stays banded.
+ * @param keys keys encoded as DynamicsSymbol.
+ */
+gtsam::Ordering TimeOrdering(const gtsam::KeyVector &keys);
+
+/**
+ * @fn Order the keys of a trajectory by nested dissection over time: the
+ * middle step separates the trajectory into two halves, which are ordered
+ * recursively before it. This yields a balanced elimination tree of depth
+ * O(log K) for K steps, whose independent subtrees gtsam eliminates in
+ * parallel when built with TBB. Within a step, keys are ordered as in
+ * TimeOrdering.
+ * @param keys keys encoded as DynamicsSymbol.
+ */
+gtsam::Ordering NestedDissectionTimeOrdering(const gtsam::KeyVector &keys);
+
+/**
+ * @fn Whether all keys are DynamicsSymbols with known labels spanning more
+ * than one time step, so that the time orderings apply.
+ */
+bool IsTrajectory(const gtsam::KeyVector &keys);
+
+/**
+ * @fn Elimination ordering of a factor graph for the given ordering type.
+ * @return the ordering, or none to use COLAMD.
+ */
+std::optional<gtsam::Ordering> TrajectoryOrdering(
+    const gtsam::NonlinearFactorGraph &graph, OrderingType type);
+
+}  // namespace gtdynamics
@@ -0,0 +1,262 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TrajectoryPCGSolver.cpp
+ * @brief Matrix-free preconditioned conjugate gradient solver for linearized
+ * trajectory factor graphs, preconditioned per time step.
+ */
+
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
+#include <gtdynamics/utils/TimeIndex.h>
+#include <gtsam/linear/HessianFactor.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace gtdynamics {
+
+using gtsam::GaussianFactorGraph;
+using gtsam::JacobianFactor;
+using gtsam::Key;
+using gtsam::KeyVector;
+using gtsam::Matrix;
+using gtsam::Vector;
+using gtsam::VectorValues;
+
+/* ************************************************************************* */
+TrajectoryPCGSolver::TrajectoryPCGSolver(const GaussianFactorGraph &graph,
+                                         const TrajectoryPCGParams &params)
+    : params_(params) {
+  // Keep the factors of the graph, whitening only those with a non-unit noise
+  // model, e.g., the damping priors of LM, and collect the variable
+  // dimensions.
+  std::map<Key, size_t> dims;
+  for (auto &&factor : graph) {
+    if (!factor) continue;
+    auto jacobian = std::dynamic_pointer_cast<JacobianFactor>(factor);
+    if (!jacobian) {
+      auto hessian = std::dynamic_pointer_cast<gtsam::HessianFactor>(factor);
+      if (!hessian) {
+        throw std::invalid_argument(
+            "TrajectoryPCGSolver: unsupported linear factor type.");
+      }
+      jacobian = std::make_shared<JacobianFactor>(*hessian);
+    }
+    if (jacobian->get_model() && jacobian->get_model()->isConstrained()) {
+      throw std::invalid_argument(
+          "TrajectoryPCGSolver: constrained noise models are not supported.");
+    }
+    const auto &model = jacobian->get_model();
+    if (model && !model->isUnit()) {
+      jacobian = std::make_shared<JacobianFactor>(jacobian->whiten());
+    }
+    factors_.push_back(jacobian);
+    for (auto it = jacobian->begin(); it != jacobian->end(); ++it) {
+      dims[*it] = jacobian->getDim(it);
+    }
+  }
+
+  // Timed blocks in time order, then one block per untimed variable.
+  KeyVector keys;
+  for (auto &&[key, dim] : dims) keys.push_back(key);
+  const TimeIndex index(keys);
+  auto add_block = [this, &dims](const KeyVector &block_keys) {
+    size_t block_dim = 0;
+    for (auto &&key : block_keys) {
+      slots_[key] = {block_dims_.size(), block_dim, dims.at(key)};
+      block_dim += dims.at(key);
+    }
+    block_offsets_.push_back(dim_);
+    block_dims_.push_back(block_dim);
+    dim_ += block_dim;
+  };
+  for (size_t k = index.firstStep(); k < index.firstStep() + index.numSteps();
+       k++) {
+    if (!index.keys(k).empty()) add_block(index.keys(k));
+  }
+  num_timed_blocks_ = block_dims_.size();
+  for (auto &&key : index.untimedKeys()) add_block({key});
+
+  // Column offsets of the variables of each factor in the flattened vector.
+  factor_offsets_.reserve(factors_.size());
+  for (auto &&factor : factors_) {
+    std::vector<size_t> offsets;
+    offsets.reserve(factor->size());
+    for (auto &&key : factor->keys()) {
+      const Slot &s = slots_.at(key);
+      offsets.push_back(block_offsets_[s.block] + s.offset);
+    }
+    factor_offsets_.push_back(std::move(offsets));
+    max_rows_ = std::max(max_rows_, factor->rows());
+  }
+
+  buildPreconditioner();
+}
+
+/* ************************************************************************* */
+void TrajectoryPCGSolver::buildPreconditioner() {
+  const bool tridiagonal =
+      params_.preconditioner == TrajectoryPCGParams::BLOCK_TRIDIAGONAL;
+  const size_t num_blocks = block_dims_.size();
+  std::vector<Matrix> hessian(num_blocks);
+  for (size_t b = 0; b < num_blocks; b++) {
+    hessian[b] = Matrix::Zero(block_dims_[b], block_dims_[b]);
+  }
+  coupling_.clear();
+  if (tridiagonal && num_timed_blocks_ > 1) {
+    coupling_.resize(num_timed_blocks_ - 1);
+    for (size_t b = 0; b + 1 < num_timed_blocks_; b++) {
+      coupling_[b] = Matrix::Zero(block_dims_[b], block_dims_[b + 1]);
+    }
+  }
+
+  // Accumulate A_i' A_j for every pair of variables of every factor.
+  for (auto &&factor : factors_) {
+    for (auto it_i = factor->begin(); it_i != factor->end(); ++it_i) {
+      const Slot &si = slots_.at(*it_i);
+      const auto A_i = factor->getA(it_i);
+      for (auto it_j = factor->begin(); it_j != factor->end(); ++it_j) {
+        const Slot &sj = slots_.at(*it_j);
+        if (si.block == sj.block) {
+          hessian[si.block].block(si.offset, sj.offset, si.dim, sj.dim) +=
+              A_i.transpose() * factor->getA(it_j);
+        } else if (tridiagonal && sj.block == si.block + 1 &&
+                   sj.block < num_timed_blocks_) {
+          coupling_[si.block].block(si.offset, sj.offset, si.dim, sj.dim) +=
+              A_i.transpose() * factor->getA(it_j);
+        }
+      }
+    }
+  }
+
+  // Block LDL': each timed diagonal block is reduced by the previous one.
+  diagonal_.clear();
+  diagonal_.reserve(num_blocks);
+  for (size_t b = 0; b < num_blocks; b++) {
+    if (tridiagonal && b > 0 && b < num_timed_blocks_) {
+      const Matrix &C = coupling_[b - 1];
+      hessian[b] -= C.transpose() * diagonal_[b - 1].solve(C);
+    }
+    diagonal_.emplace_back(hessian[b]);
+  }
+}
+
+/* ************************************************************************* */
+Vector TrajectoryPCGSolver::precondition(const Vector &r) const {
+  const size_t num_blocks = block_dims_.size();
+  auto segment = [this](Vector &v, size_t b) {
+    return v.segment(block_offsets_[b], block_dims_[b]);
+  };
+  Vector z = r;
+  if (coupling_.empty()) {
+    for (size_t b = 0; b < num_blocks; b++) {
+      segment(z, b) = diagonal_[b].solve(segment(z, b));
+    }
+    return z;
+  }
+
+  // Forward substitution on the timed blocks, w_b = r_b - C' D^-1 w_{b-1}.
+  for (size_t b = 1; b < num_timed_blocks_; b++) {
+    const Vector v = diagonal_[b - 1].solve(segment(z, b - 1));
+    segment(z, b) -= coupling_[b - 1].transpose() * v;
+  }
+  // Back substitution, z_b = D^-1 (w_b - C z_{b+1}).
+  for (size_t b = num_blocks; b-- > 0;) {
+    Vector w = segment(z, b);
+    if (b + 1 < num_timed_blocks_) w -= coupling_[b] * segment(z, b + 1);
+    segment(z, b) = diagonal_[b].solve(w);
+  }
+  return z;
+}
+
+/* ************************************************************************* */
+Vector TrajectoryPCGSolver::multiplyHessian(const Vector &x) const {
+  Vector y = Vector::Zero(dim_);
+  Vector buffer(max_rows_);  // A_f x, for each factor f in turn
+  for (size_t f = 0; f < factors_.size(); f++) {
+    const JacobianFactor &factor = *factors_[f];
+    const std::vector<size_t> &offsets = factor_offsets_[f];
+    auto e = buffer.head(factor.rows());
+    e.setZero();
+    size_t i = 0;
+    for (auto it = factor.begin(); it != factor.end(); ++it, ++i) {
+      e += factor.getA(it) * x.segment(offsets[i], factor.getDim(it));
+    }
+    i = 0;
+    for (auto it = factor.begin(); it != factor.end(); ++it, ++i) {
+      y.segment(offsets[i], factor.getDim(it)) +=
+          factor.getA(it).transpose() * e;
+    }
+  }
+  return y;
+}
+
+/* ************************************************************************* */
+Vector TrajectoryPCGSolver::rhs() const {
+  Vector g = Vector::Zero(dim_);
+  for (size_t f = 0; f < factors_.size(); f++) {
+    const JacobianFactor &factor = *factors_[f];
+    const std::vector<size_t> &offsets = factor_offsets_[f];
+    size_t i = 0;
+    for (auto it = factor.begin(); it != factor.end(); ++it, ++i) {
+      g.segment(offsets[i], factor.getDim(it)) +=
+          factor.getA(it).transpose() * factor.getb();
+    }
+  }
+  return g;
+}
+
+/* ************************************************************************* */
+VectorValues TrajectoryPCGSolver::solve() {
+  const Vector b = rhs();
+  Vector x = Vector::Zero(dim_);
+  const double b_norm = b.norm();
+  iterations_ = 0;
+  residual_ = 0.0;
+  if (b_norm > 0.0) {
+    Vector r = b;
+    Vector z = precondition(r);
+    Vector p = z;
+    double rz = r.dot(z);
+    residual_ = 1.0;
+    while (iterations_ < params_.max_iterations &&
+           residual_ > params_.relative_tolerance) {
+      const Vector Hp = multiplyHessian(p);
+      const double curvature = p.dot(Hp);
+      // A'A is only semi-definite: along a direction of zero curvature, e.g.,
+      // of a rank-deficient system, keep the current iterate.
+      if (!(curvature > 0.0 && rz > 0.0)) break;
+      const double alpha = rz / curvature;
+      x += alpha * p;
+      r -= alpha * Hp;
+      residual_ = r.norm() / b_norm;
+      iterations_++;
+      if (residual_ <= params_.relative_tolerance) break;
+      z = precondition(r);
+      const double rz_next = r.dot(z);
+      p = z + (rz_next / rz) * p;
+      rz = rz_next;
+    }
+  }
+
+  VectorValues solution;
+  for (auto &&[key, s] : slots_) {
+    solution.insert(key, x.segment(block_offsets_[s.block] + s.offset, s.dim));
+  }
+  return solution;
+}
+
+/* ************************************************************************* */
+size_t TrajectoryPCGSolver::preconditionerSize() const {
+  size_t size = 0;
+  for (auto &&d : diagonal_) size += d.matrixLDLT().size();
+  for (auto &&c : coupling_) size += c.size();
+  return size;
+}
+
+}  // namespace gtdynamics
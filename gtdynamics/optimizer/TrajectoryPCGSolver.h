@@ -0,0 +1,159 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TrajectoryPCGSolver.h
+ * @brief Matrix-free preconditioned conjugate gradient solver for linearized
+ * trajectory factor graphs, preconditioned per time step.
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <Eigen/Cholesky>
+#include <map>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Parameters of the trajectory PCG solver.
+struct TrajectoryPCGParams {
+  enum Preconditioner {
+    BLOCK_JACOBI,      // Hessian blocks of each time step
+    BLOCK_TRIDIAGONAL  // and the coupling between consecutive steps
+  };
+
+  Preconditioner preconditioner = BLOCK_TRIDIAGONAL;
+  size_t max_iterations = 1000;      // maximum number of CG iterations
+  double relative_tolerance = 1e-9;  // of the residual norm, relative to A'b
+};
+
+/**
+ * TrajectoryPCGSolver solves the normal equations A'A x = A'b of a linear
+ * factor graph by preconditioned conjugate gradient, without assembling A'A:
+ * Hessian-vector products are computed factor by factor, from the whitened
+ * Jacobians. The factors of the graph are shared, not copied, except those
+ * with a non-unit noise model, which are whitened once; only the
+ * preconditioner and the column offsets of the factors are stored besides.
+ *
+ * Variables are grouped by time step, see TimeIndex. The block Jacobi
+ * preconditioner inverts the Hessian block of each step, and the block
+ * tridiagonal one also keeps the Hessian blocks between consecutive steps,
+ * which are all that dynamics and collocation factors create, and factors it
+ * by block LDL'. Variables not indexed by time step, e.g., phase durations,
+ * each form their own diagonal block.
+ */
+class TrajectoryPCGSolver {
+ private:
+  /// Position of a variable in the flattened vector.
+  struct Slot {
+    size_t block, offset, dim;
+  };
+
+  TrajectoryPCGParams params_;
+  std::vector<gtsam::JacobianFactor::shared_ptr> factors_;  // whitened
+  std::map<gtsam::Key, Slot> slots_;
+  std::vector<std::vector<size_t>> factor_offsets_;  // of the factor keys
+  size_t max_rows_ = 0;                              // of all factors
+  std::vector<size_t> block_offsets_, block_dims_;
+  size_t num_timed_blocks_ = 0;  // timed blocks come first, in time order
+  size_t dim_ = 0;
+
+  // Preconditioner: LDL' of the diagonal blocks, after elimination of the
+  // previous step for BLOCK_TRIDIAGONAL, and blocks coupling step b to b + 1.
+  std::vector<Eigen::LDLT<gtsam::Matrix>> diagonal_;
+  std::vector<gtsam::Matrix> coupling_;
+
+  size_t iterations_ = 0;
+  double residual_ = 0.0;
+
+  /// Build the preconditioner from the Hessian blocks.
+  void buildPreconditioner();
+
+  /// Solve M z = r with the preconditioner M.
+  gtsam::Vector precondition(const gtsam::Vector &r) const;
+
+ public:
+  /**
+   * Constructor, which builds the preconditioner.
+   * @param graph linear factor graph, with keys encoded as DynamicsSymbol.
+   * @param params solver parameters.
+   * @throws std::invalid_argument if a factor has a constrained noise model,
+   * which has no finite whitened Jacobian.
+   */
+  explicit TrajectoryPCGSolver(
+      const gtsam::GaussianFactorGraph &graph,
+      const TrajectoryPCGParams &params = TrajectoryPCGParams());
+
+  /// Hessian-vector product A'A x, in flattened coordinates.
+  gtsam::Vector multiplyHessian(const gtsam::Vector &x) const;
+
+  /// Gradient A'b at zero, in flattened coordinates.
+  gtsam::Vector rhs() const;
+
+  /**
+   * Solve the normal equations. Stops early, at the current iterate, if the
+   * Hessian or the preconditioner is singular along the search direction,
+   * e.g., for a rank-deficient system.
+   */
+  gtsam::VectorValues solve();
+
+  /// Number of CG iterations of the last solve.
+  size_t iterations() const { return iterations_; }
+
+  /// Relative residual norm at the end of the last solve.
+  double residual() const { return residual_; }
+
+  /// Number of scalars stored by the preconditioner.
+  size_t preconditionerSize() const;
+
+  /// Solve a linear factor graph.
+  static gtsam::VectorValues Solve(
+      const gtsam::GaussianFactorGraph &graph,
+      const TrajectoryPCGParams &params = TrajectoryPCGParams()) {
+    return TrajectoryPCGSolver(graph, params).solve();
+  }
+};
+
+/**
+ * Levenberg-Marquardt optimizer whose linear solves use TrajectoryPCGSolver,
+ * for problems too large to factorize.
+ */
+class PCGLMOptimizer : public gtsam::LevenbergMarquardtOptimizer {
+ private:
+  TrajectoryPCGParams pcg_params_;
+
+ public:
+  /**
+   * Constructor.
+   * @param graph nonlinear trajectory graph.
+   * @param initial_values initial values.
+   * @param params LM parameters.
+   * @param pcg_params PCG parameters.
+   */
+  PCGLMOptimizer(const gtsam::NonlinearFactorGraph &graph,
+                 const gtsam::Values &initial_values,
+                 const gtsam::LevenbergMarquardtParams &params =
+                     gtsam::LevenbergMarquardtParams(),
+                 const TrajectoryPCGParams &pcg_params = TrajectoryPCGParams())
+      : gtsam::LevenbergMarquardtOptimizer(graph, initial_values, params),
+        pcg_params_(pcg_params) {}
+
+  /// Linear solve by PCG.
+  gtsam::VectorValues solve(
+      const gtsam::GaussianFactorGraph &gfg,
+      const gtsam::NonlinearOptimizerParams &params) const override {
+    return TrajectoryPCGSolver::Solve(gfg, pcg_params_);
+  }
+};
+
+}  // namespace gtdynamics
@@ -0,0 +1,196 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  BatchLoader.cpp
+ * @brief Parallel loading and validation of libraries of robot model files.
+ */
+
+#include <gtdynamics/universal_robot/BatchLoader.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/Parallel.h>
+
+#include <Eigen/Eigenvalues>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <queue>
+#include <set>
+
+namespace gtdynamics {
+
+using Clock = std::chrono::steady_clock;
+
+/// Milliseconds elapsed since start.
+static double ElapsedMs(const Clock::time_point &start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+/* ************************************************************************* */
+std::vector<std::string> ValidateRobot(const Robot &robot, double tol) {
+  std::vector<std::string> errors;
+  const auto links = robot.links();
+  const auto joints = robot.joints();
+
+  // Unique ids.
+  std::set<uint8_t> link_ids, joint_ids;
+  for (auto &&link : links) {
+    if (!link_ids.insert(link->id()).second) {
+      errors.push_back("link '" + link->name() + "': duplicate id " +
+                       std::to_string(link->id()));
+    }
+  }
+  for (auto &&joint : joints) {
+    if (!joint_ids.insert(joint->id()).second) {
+      errors.push_back("joint '" + joint->name() + "': duplicate id " +
+                       std::to_string(joint->id()));
+    }
+  }
+
+  // Joints connect links of this robot.
+  const std::set<LinkSharedPtr> robot_links(links.begin(), links.end());
+  for (auto &&joint : joints) {
+    for (auto &&link : joint->links()) {
+      if (!link) {
+        errors.push_back("joint '" + joint->name() + "': missing link");
+      } else if (!robot_links.count(link)) {
+        errors.push_back("joint '" + joint->name() + "': link '" +
+                         link->name() + "' is not part of the robot");
+      }
+    }
+  }
+
+  // Connectivity, by breadth-first search over joints.
+  if (!links.empty()) {
+    std::set<std::string> visited{links.front()->name()};
+    std::queue<LinkSharedPtr> frontier;
+    frontier.push(links.front());
+    while (!frontier.empty()) {
+      auto link = frontier.front();
+      frontier.pop();
+      for (auto &&joint : link->joints()) {
+        auto other = joint->otherLink(link);
+        if (other && visited.insert(other->name()).second) {
+          frontier.push(other);
+        }
+      }
+    }
+    for (auto &&link : links) {
+      if (!visited.count(link->name())) {
+        errors.push_back("link '" + link->name() + "': not connected to '" +
+                         links.front()->name() + "'");
+      }
+    }
+  }
+
+  // Mass and inertia.
+  for (auto &&link : links) {
+    const std::string prefix = "link '" + link->name() + "': ";
+    const double mass = link->mass();
+    const gtsam::Matrix3 &inertia = link->inertia();
+    if (!std::isfinite(mass) || mass < 0) {
+      errors.push_back(prefix + "invalid mass " + std::to_string(mass));
+    }
+    if (!inertia.allFinite()) {
+      errors.push_back(prefix + "inertia is not finite");
+      continue;
+    }
+    if (!inertia.isApprox(inertia.transpose(), tol)) {
+      errors.push_back(prefix + "inertia is not symmetric");
+      continue;
+    }
+    const gtsam::Vector3 moments =
+        Eigen::SelfAdjointEigenSolver<gtsam::Matrix3>(inertia).eigenvalues();
+    if (moments.minCoeff() < -tol) {
+      errors.push_back(prefix + "inertia is not positive semi-definite");
+    } else if (moments(0) + moments(1) < moments(2) - tol) {
+      // Eigenvalues are sorted, so only the largest can violate it.
+      errors.push_back(prefix + "inertia violates the triangle inequality");
+    }
+  }
+
+  // Joint limits.
+  for (auto &&joint : joints) {
+    const std::string prefix = "joint '" + joint->name() + "': ";
+    const JointParams &params = joint->parameters();
+    if (params.scalar_limits.value_lower_limit >
+        params.scalar_limits.value_upper_limit) {
+      errors.push_back(prefix + "lower limit exceeds upper limit");
+    }
+    if (params.velocity_limit < 0 || params.acceleration_limit < 0 ||
+        params.torque_limit < 0) {
+      errors.push_back(prefix + "negative velocity, acceleration or torque "
+                                "limit");
+    }
+  }
+  return errors;
+}
+
+/* ************************************************************************* */
+size_t ModelLoadSummary::numFailed() const {
+  size_t num_failed = 0;
+  for (auto &&result : results) {
+    if (!result.ok()) num_failed++;
+  }
+  return num_failed;
+}
+
+/* ************************************************************************* */
+void ModelLoadSummary::print(std::ostream &os) const {
+  os << std::fixed << std::setprecision(2);
+  for (auto &&result : results) {
+    os << (result.ok() ? "[ OK ] " : "[FAIL] ") << result.file_path << "  "
+       << result.parse_time_ms << " ms parse, " << result.validate_time_ms
+       << " ms validate";
+    if (result.robot) {
+      os << ", " << result.robot->numLinks() << " links, "
+         << result.robot->numJoints() << " joints";
+    }
+    os << "\n";
+    for (auto &&error : result.errors) os << "         " << error << "\n";
+  }
+  os << results.size() - numFailed() << "/" << results.size()
+     << " models valid, total " << total_time_ms << " ms\n";
+  os << std::defaultfloat;
+}
+
+/* ************************************************************************* */
+ModelLoadSummary LoadRobotsFromFiles(const std::vector<std::string> &file_paths,
+                                     size_t num_threads) {
+  ModelLoadSummary summary;
+  summary.results.resize(file_paths.size());
+  const auto start = Clock::now();
+
+  // Each work item only writes its own result slot.
+  ParallelFor(
+      file_paths.size(),
+      [&](size_t i) {
+        ModelLoadResult &result = summary.results[i];
+        result.file_path = file_paths[i];
+        auto parse_start = Clock::now();
+        try {
+          result.robot = CreateRobotFromFile(file_paths[i]);
+        } catch (const std::exception &e) {
+          result.errors.push_back(std::string("parse error: ") + e.what());
+        }
+        result.parse_time_ms = ElapsedMs(parse_start);
+
+        if (result.robot) {
+          auto validate_start = Clock::now();
+          result.errors = ValidateRobot(*result.robot);
+          result.validate_time_ms = ElapsedMs(validate_start);
+        }
+      },
+      num_threads);
+
+  summary.total_time_ms = ElapsedMs(start);
+  return summary;
+}
+
+}  // namespace gtdynamics
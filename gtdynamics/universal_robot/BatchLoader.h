@@ -0,0 +1,68 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  BatchLoader.h
+ * @brief Parallel loading and validation of libraries of robot model files.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * @fn Check a robot for structural and physical consistency: links and joints
+ * form one connected structure, ids are unique, masses and inertias are
+ * physically valid (finite, positive semi-definite, satisfying the triangle
+ * inequality), and joint limits are well-ordered.
+ * @param robot the robot to check.
+ * @param tol numerical tolerance on inertia checks.
+ * @return human readable description of each problem found, empty if valid.
+ */
+std::vector<std::string> ValidateRobot(const Robot &robot, double tol = 1e-9);
+
+/// Outcome of loading a single model file.
+struct ModelLoadResult {
+  std::string file_path;
+  std::optional<Robot> robot;       // set if the file was parsed
+  std::vector<std::string> errors;  // parse error or validation problems
+  double parse_time_ms = 0;
+  double validate_time_ms = 0;
+
+  /// Return true if the file was parsed and the robot is valid.
+  bool ok() const { return robot.has_value() && errors.empty(); }
+};
+
+/// Outcome of loading a batch of model files, in the order they were given.
+struct ModelLoadSummary {
+  std::vector<ModelLoadResult> results;
+  double total_time_ms = 0;  // wall time of the whole batch
+
+  /// Return the number of files that failed to parse or validate.
+  size_t numFailed() const;
+
+  /// Print a per-file table of timing and errors.
+  void print(std::ostream &os) const;
+};
+
+/**
+ * @fn Parse and validate many model files in parallel. Errors are collected
+ * per file rather than thrown.
+ * @param file_paths paths to urdf or sdf model files.
+ * @param num_threads maximum number of threads, 0 for hardware concurrency.
+ */
+ModelLoadSummary LoadRobotsFromFiles(const std::vector<std::string> &file_paths,
+                                     size_t num_threads = 0);
+
+}  // namespace gtdynamics
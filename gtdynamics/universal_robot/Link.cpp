@@ -17,6 +17,7 @@
 #include <gtdynamics/dynamics/Dynamics.h>
 #include <gtdynamics/statics/Statics.h>
 #include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/utils/SharedParameters.h>
 #include <gtsam/slam/expressions.h>
 
 #include <iostream>
@@ -27,26 +28,36 @@ namespace gtdynamics {
 gtsam::Vector6_ Link::wrenchConstraint(
     const std::vector<gtsam::Key>& wrench_keys, uint64_t t,
     const std::optional<gtsam::Vector3>& gravity) const {
+  return wrenchConstraint(wrench_keys, gtsam::Pose3_(PoseKey(id(), t)),
+                          gtsam::Vector6_(TwistKey(id(), t)),
+                          gtsam::Vector6_(TwistAccelKey(id(), t)), gravity);
+}
+
+/* ************************************************************************* */
+gtsam::Vector6_ Link::wrenchConstraint(
+    const std::vector<gtsam::Key>& wrench_keys, const gtsam::Pose3_& pose,
+    const gtsam::Vector6_& twist, const gtsam::Vector6_& twistAccel,
+    const std::optional<gtsam::Vector3>& gravity) const {
   // Collect wrenches to implement L&P Equation 8.48 (F = ma)
   std::vector<gtsam::Vector6_> wrenches;
 
+  // The inertia is shared by the wrench factors of all identical links, at
+  // all time steps.
+  const gtsam::Matrix6 inertia = inertiaMatrix();
+  const SharedParameter<gtsam::Matrix6> shared_inertia =
+      SharedParameters::Share(inertia);
+
   // Coriolis forces.
-  gtsam::Vector6_ twist(TwistKey(id(), t));
-  // TODO(yetong): make Coriolis a functor and get rid of placeholders.
   gtsam::Vector6_ wrench_coriolis(
-      std::bind(Coriolis, inertiaMatrix(), std::placeholders::_1,
-                std::placeholders::_2),
+      [shared_inertia](const gtsam::Vector6 &twist,
+                       gtsam::OptionalJacobian<6, 6> H_twist) {
+        return Coriolis(*shared_inertia, twist, H_twist);
+      },
       twist);
   wrenches.push_back(wrench_coriolis);
 
   // Change in generalized momentum.
-  const gtsam::Matrix6 neg_inertia = -inertiaMatrix();
-  gtsam::Vector6_ twistAccel(TwistAccelKey(id(), t));
-  gtsam::Vector6_ wrench_momentum(
-      std::bind(MatVecMult<6, 6>, neg_inertia, std::placeholders::_1,
-                std::placeholders::_2),
-      twistAccel);
-  wrenches.push_back(wrench_momentum);
+  wrenches.push_back(SharedLinearExpression<6, 6>(-inertia, twistAccel));
 
   // External wrenches.
   for (const auto& key : wrench_keys) {
@@ -55,7 +66,6 @@ gtsam::Vector6_ Link::wrenchConstraint(
 
   // Gravity wrench.
   if (gravity) {
-    gtsam::Pose3_ pose(PoseKey(id(), t));
     gtsam::Vector6_ wrench_gravity(
         std::bind(GravityWrench, *gravity, mass_, std::placeholders::_1,
                   std::placeholders::_2),
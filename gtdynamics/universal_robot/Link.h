@@ -185,6 +185,20 @@ class Link : public std::enable_shared_from_this<Link> {
       const std::vector<gtsam::Key> &wrench_keys, uint64_t t = 0,
       const std::optional<gtsam::Vector3> &gravity = {}) const;
 
+  /**
+   * @brief Create expression that constraint the wrench balance on the link,
+   * given expressions for its motion rather than its variables.
+   * @param wrench_keys Keys for external wrenches acting on the link.
+   * @param pose Expression of the link pose.
+   * @param twist Expression of the link twist.
+   * @param twistAccel Expression of the link twist acceleration.
+   * @param gravity Gravitional constant.
+   */
+  gtsam::Vector6_ wrenchConstraint(
+      const std::vector<gtsam::Key> &wrench_keys, const gtsam::Pose3_ &pose,
+      const gtsam::Vector6_ &twist, const gtsam::Vector6_ &twistAccel,
+      const std::optional<gtsam::Vector3> &gravity = {}) const;
+
  private:
   /// fix the link to fixed_pose. If fixed_pose is not specified, use bTcom.
   void fix(const std::optional<gtsam::Pose3> fixed_pose = {}) {
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <memory>
 #include <queue>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 
@@ -107,6 +108,57 @@ int Robot::numLinks() const { return name_to_link_.size(); }
 
 int Robot::numJoints() const { return name_to_joint_.size(); }
 
+LinkSharedPtr Robot::treeRoot() const {
+  std::set<uint8_t> children;
+  for (auto &&joint : joints()) {
+    if (!children.insert(joint->child()->id()).second) {
+      throw std::invalid_argument(
+          "treeRoot: link " + joint->child()->name() +
+          " is the child of several joints, the robot is not a tree.");
+    }
+  }
+  LinkSharedPtr root;
+  for (auto &&link : links()) {
+    if (children.count(link->id())) continue;
+    if (root) {
+      throw std::invalid_argument("treeRoot: links " + root->name() + " and " +
+                                  link->name() +
+                                  " are both roots, the robot is not "
+                                  "connected.");
+    }
+    root = link;
+  }
+  if (!root) {
+    throw std::invalid_argument(
+        "treeRoot: every link is the child of a joint, the robot has no root "
+        "and is not a tree.");
+  }
+
+  // With a single parent per link, a link that the root does not reach is on
+  // a closed chain apart from it.
+  std::set<uint8_t> reached{root->id()};
+  std::queue<LinkSharedPtr> queue;
+  queue.push(root);
+  while (!queue.empty()) {
+    const LinkSharedPtr link = queue.front();
+    queue.pop();
+    for (auto &&joint : link->joints()) {
+      if (joint->parent() != link) continue;
+      if (reached.insert(joint->child()->id()).second) {
+        queue.push(joint->child());
+      }
+    }
+  }
+  for (auto &&link : links()) {
+    if (!reached.count(link->id())) {
+      throw std::invalid_argument("treeRoot: link " + link->name() +
+                                  " cannot be reached from the root " +
+                                  root->name() + ", the robot is not a tree.");
+    }
+  }
+  return root;
+}
+
 void Robot::print(const std::string &s) const {
   using std::cout;
   using std::endl;
@@ -265,4 +317,136 @@ gtsam::Values Robot::forwardKinematics(
   return values;
 }
 
+// Joint angle or velocity, zero if missing.
+static double JointValue(const gtsam::Values &values, gtsam::Key key) {
+  return values.exists(key) ? values.atDouble(key) : 0.0;
+}
+
+void Robot::rootPoses(const gtsam::Values &known_values, size_t t,
+                      const std::optional<std::string> &prior_link_name,
+                      JacobianWorkspace *workspace) const {
+  JacobianWorkspace &ws = *workspace;
+  const auto root_link = findRootLink(known_values, prior_link_name);
+
+  // BFS spanning tree from the root link, only rebuilt for another robot or
+  // root. The links vector is the BFS queue.
+  if (ws.robot != this || ws.root_id != root_link->id()) {
+    const size_t num_links = numLinks();
+    size_t max_id = 0;
+    for (auto &&[name, link] : name_to_link_) {
+      max_id = std::max<size_t>(max_id, link->id());
+    }
+    ws.links.clear();
+    ws.joints.clear();
+    ws.parents.clear();
+    ws.links.reserve(num_links);
+    ws.joints.reserve(num_links);
+    ws.parents.reserve(num_links);
+    ws.index.assign(max_id + 1, -1);
+    ws.links.push_back(root_link);
+    ws.joints.push_back(nullptr);
+    ws.parents.push_back(0);
+    ws.index[root_link->id()] = 0;
+    for (size_t i = 0; i < ws.links.size(); i++) {
+      for (auto &&joint : ws.links[i]->joints()) {
+        const auto link2 = joint->otherLink(ws.links[i]);
+        if (ws.index[link2->id()] >= 0) continue;
+        ws.index[link2->id()] = ws.links.size();
+        ws.links.push_back(link2);
+        ws.joints.push_back(joint);
+        ws.parents.push_back(i);
+      }
+    }
+    ws.robot = this;
+    ws.root_id = root_link->id();
+  }
+
+  ws.rTl.resize(ws.links.size());
+  ws.rTl[0] = Pose3();
+  for (size_t i = 1; i < ws.links.size(); i++) {
+    const auto &joint = ws.joints[i];
+    const double q = JointValue(known_values, JointAngleKey(joint->id(), t));
+    ws.rTl[i] = joint->poseOf(ws.links[i], ws.rTl[ws.parents[i]], q);
+  }
+}
+
+void Robot::linkJacobian(const std::string &link_name,
+                         const gtsam::Values &known_values, size_t t,
+                         const JacobianWorkspace &ws, gtsam::Matrix *J,
+                         gtsam::Matrix *J_dot) const {
+  const int num_joints = numJoints();
+  const auto end_link = link(link_name);
+  const size_t id = end_link->id();
+  if (id >= ws.index.size() || ws.index[id] < 0) {
+    throw std::runtime_error("jacobians: link " + link_name +
+                             " is not connected to the root link");
+  }
+  J->setZero(6, num_joints);
+  if (J_dot) J_dot->setZero(6, num_joints);
+
+  // Walk from the link back to the root. The column of joint j is its screw
+  // axis, transported to the end link frame. Its time derivative is ad(J_j)
+  // times the twist of the end link relative to the link after j, which
+  // accumulates the joints visited so far.
+  const size_t end = ws.index[id];
+  const Pose3 eTr = ws.rTl[end].inverse();
+  Vector6 V_relative = Vector6::Zero();
+  for (size_t i = end; i != 0; i = ws.parents[i]) {
+    const auto &joint = ws.joints[i];
+    const int j = joint->id();
+    if (j >= num_joints) {
+      throw std::runtime_error("jacobians: joint ids must be less than " +
+                               std::to_string(num_joints));
+    }
+    const Vector6 J_j =
+        (eTr * ws.rTl[i]).Adjoint(joint->screwAxis(ws.links[i]));
+    J->col(j) = J_j;
+    if (J_dot) {
+      J_dot->col(j) = Pose3::adjointMap(J_j) * V_relative;
+      V_relative += J_j * JointValue(known_values, JointVelKey(j, t));
+    }
+  }
+}
+
+void Robot::jacobians(const std::vector<std::string> &link_names,
+                      const gtsam::Values &known_values,
+                      std::vector<gtsam::Matrix> *J,
+                      std::vector<gtsam::Matrix> *J_dot, size_t t,
+                      const std::optional<std::string> &prior_link_name,
+                      JacobianWorkspace *workspace) const {
+  JacobianWorkspace local;
+  JacobianWorkspace *ws = workspace ? workspace : &local;
+  rootPoses(known_values, t, prior_link_name, ws);
+  J->resize(link_names.size());
+  if (J_dot) J_dot->resize(link_names.size());
+  for (size_t e = 0; e < link_names.size(); e++) {
+    linkJacobian(link_names[e], known_values, t, *ws, &(*J)[e],
+                 J_dot ? &(*J_dot)[e] : nullptr);
+  }
+}
+
+gtsam::Matrix Robot::jacobian(
+    const std::string &link_name, const gtsam::Values &known_values, size_t t,
+    const std::optional<std::string> &prior_link_name,
+    JacobianWorkspace *workspace) const {
+  JacobianWorkspace local;
+  JacobianWorkspace *ws = workspace ? workspace : &local;
+  rootPoses(known_values, t, prior_link_name, ws);
+  gtsam::Matrix J;
+  linkJacobian(link_name, known_values, t, *ws, &J, nullptr);
+  return J;
+}
+
+gtsam::Matrix Robot::jacobianDot(
+    const std::string &link_name, const gtsam::Values &known_values, size_t t,
+    const std::optional<std::string> &prior_link_name,
+    JacobianWorkspace *workspace) const {
+  JacobianWorkspace local;
+  JacobianWorkspace *ws = workspace ? workspace : &local;
+  rootPoses(known_values, t, prior_link_name, ws);
+  gtsam::Matrix J, J_dot;
+  linkJacobian(link_name, known_values, t, *ws, &J, &J_dot);
+  return J_dot;
+}
+
 }  // namespace gtdynamics.
@@ -42,6 +42,23 @@ using LinkTwists = std::map<std::string, gtsam::Vector6>;
 // type for storing forward kinematics results
 using FKResults = std::pair<LinkPoses, LinkTwists>;
 
+class Robot;
+
+/**
+ * Scratch space of Robot::jacobians, to reuse across calls, e.g., in a control
+ * loop, so that they do not allocate. It caches the BFS spanning tree of the
+ * robot from the root link, so use one workspace per robot.
+ */
+struct JacobianWorkspace {
+  const Robot *robot = nullptr;  ///< robot of the cached spanning tree
+  int root_id = -1;              ///< root link of the cached spanning tree
+  std::vector<LinkSharedPtr> links;    ///< links in BFS order, root first
+  std::vector<JointSharedPtr> joints;  ///< joint towards the root, per link
+  std::vector<size_t> parents;  ///< BFS index of the link towards the root
+  std::vector<int> index;       ///< BFS index of each link id, -1 if none
+  std::vector<gtsam::Pose3> rTl;  ///< pose of each link in the root frame
+};
+
 /**
  * Robot is used to create a representation of a robot's
  * inertial/dynamic properties from a URDF/SDF file. The resulting object
@@ -109,6 +126,14 @@ class Robot {
   /// Return number of joints.
   int numJoints() const;
 
+  /**
+   * Root of the kinematic tree: the only link that is not the child of any
+   * joint, and from which every link can be reached from parent to child.
+   * @throws std::invalid_argument if the robot is not a tree, e.g., if it has
+   * a closed chain or is not connected.
+   */
+  LinkSharedPtr treeRoot() const;
+
   /// Print links and joints of the robot, for debug purposes
   void print(const std::string &s = "") const;
 
@@ -158,12 +183,72 @@ class Robot {
       const gtsam::Values &known_values, size_t t = 0,
       const std::optional<std::string> &prior_link_name = {}) const;
 
+  /**
+   * Geometric Jacobian of a link: maps joint velocities to the twist of the
+   * link's CoM frame relative to the root link, expressed in the CoM frame,
+   * i.e., the same convention as the twists of forwardKinematics. Column j
+   * corresponds to the joint with id j. Closed chains are cut along a BFS
+   * spanning tree from the root link.
+   *
+   * @param[in] link_name name of the link
+   * @param[in] known_values Values with joint angles, missing ones are zero
+   * @param[in] t integer time index
+   * @param[in] prior_link_name name of the root link, a fixed link if not given
+   * @param[in,out] workspace optional scratch space, see JacobianWorkspace
+   * @return 6 x numJoints() Jacobian
+   */
+  gtsam::Matrix jacobian(
+      const std::string &link_name, const gtsam::Values &known_values,
+      size_t t = 0, const std::optional<std::string> &prior_link_name = {},
+      JacobianWorkspace *workspace = nullptr) const;
+
+  /**
+   * Time derivative of the Jacobian of a link, see jacobian(). Joint
+   * velocities are read from `known_values`, missing ones are zero.
+   */
+  gtsam::Matrix jacobianDot(
+      const std::string &link_name, const gtsam::Values &known_values,
+      size_t t = 0, const std::optional<std::string> &prior_link_name = {},
+      JacobianWorkspace *workspace = nullptr) const;
+
+  /**
+   * Jacobians, and optionally their time derivatives, of several links,
+   * computed in a single pass over the kinematic tree. Output matrices are
+   * only reallocated if they do not have the right size, so they can be
+   * reused across control cycles, along with a workspace.
+   *
+   * @param[in] link_names names of the links
+   * @param[in] known_values Values with joint angles and velocities
+   * @param[out] J Jacobians, one per link
+   * @param[out] J_dot optional time derivatives of the Jacobians
+   * @param[in] t integer time index
+   * @param[in] prior_link_name name of the root link, a fixed link if not given
+   * @param[in,out] workspace optional scratch space, see JacobianWorkspace
+   */
+  void jacobians(const std::vector<std::string> &link_names,
+                 const gtsam::Values &known_values,
+                 std::vector<gtsam::Matrix> *J,
+                 std::vector<gtsam::Matrix> *J_dot = nullptr, size_t t = 0,
+                 const std::optional<std::string> &prior_link_name = {},
+                 JacobianWorkspace *workspace = nullptr) const;
+
  private:
   /// Find root link for forward kinematics
   LinkSharedPtr findRootLink(
       const gtsam::Values &values,
       const std::optional<std::string> &prior_link_name) const;
 
+  /// Poses of all links in the root frame, in the BFS order of the workspace.
+  void rootPoses(const gtsam::Values &known_values, size_t t,
+                 const std::optional<std::string> &prior_link_name,
+                 JacobianWorkspace *workspace) const;
+
+  /// Jacobian of a link, and optionally its time derivative, from rootPoses.
+  void linkJacobian(const std::string &link_name,
+                    const gtsam::Values &known_values, size_t t,
+                    const JacobianWorkspace &workspace, gtsam::Matrix *J,
+                    gtsam::Matrix *J_dot) const;
+
   /// @name Advanced Interface
   /// @{
 
@@ -0,0 +1,173 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  RobotGenerator.cpp
+ * @brief Programmatic generation of robots of configurable size.
+ */
+
+#include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/universal_robot/RevoluteJoint.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::Point3;
+using gtsam::Pose3;
+using gtsam::Rot3;
+using gtsam::Vector3;
+
+namespace {
+
+/// Incrementally builds the link and joint maps of a generated robot.
+class RobotBuilder {
+  const RobotGeneratorParams &params_;
+  LinkMap links_;
+  JointMap joints_;
+
+ public:
+  explicit RobotBuilder(const RobotGeneratorParams &params)
+      : params_(params) {}
+
+  /// Add a cylindrical link starting at bTs and extending along its x-axis.
+  LinkSharedPtr addLink(const std::string &name, const Pose3 &bTs) {
+    const double L = params_.link_length, r = params_.link_radius;
+    const double mass = params_.density * M_PI * r * r * L;
+    const double I_axial = 0.5 * mass * r * r;
+    const double I_transverse = mass * (3 * r * r + L * L) / 12;
+    const gtsam::Matrix3 inertia =
+        Vector3(I_axial, I_transverse, I_transverse).asDiagonal();
+    const Pose3 bMcom = bTs * Pose3(Rot3(), Point3(L / 2, 0, 0));
+    return addLink(name, mass, inertia, bMcom, bTs);
+  }
+
+  /// Add a link with the given inertial properties.
+  LinkSharedPtr addLink(const std::string &name, double mass,
+                        const gtsam::Matrix3 &inertia, const Pose3 &bMcom,
+                        const Pose3 &bMlink) {
+    const uint8_t id = NextId(links_.size());
+    auto link =
+        std::make_shared<Link>(id, name, mass, inertia, bMcom, bMlink);
+    links_.emplace(name, link);
+    return link;
+  }
+
+  /// Add a revolute joint at bTj, with axis expressed in the joint frame.
+  void addJoint(const std::string &name, const Pose3 &bTj,
+                const LinkSharedPtr &parent, const LinkSharedPtr &child,
+                const Vector3 &axis) {
+    JointParams joint_params;
+    joint_params.scalar_limits.value_lower_limit = -params_.joint_limit;
+    joint_params.scalar_limits.value_upper_limit = params_.joint_limit;
+    joint_params.velocity_limit = params_.velocity_limit;
+    joint_params.torque_limit = params_.torque_limit;
+
+    const uint8_t id = NextId(joints_.size());
+    auto joint = std::make_shared<RevoluteJoint>(id, name, bTj, parent, child,
+                                                 axis, joint_params);
+    parent->addJoint(joint);
+    child->addJoint(joint);
+    joints_.emplace(name, joint);
+  }
+
+  Robot robot() const { return Robot(links_, joints_); }
+
+  /// Link and joint ids are 8 bits wide in DynamicsSymbol keys.
+  static uint8_t NextId(size_t count) {
+    if (count >= std::numeric_limits<uint8_t>::max()) {
+      throw std::invalid_argument(
+          "RobotGenerator: at most 255 links and joints are supported.");
+    }
+    return static_cast<uint8_t>(count);
+  }
+};
+
+/// Recursively add the two children of `parent`, whose start frame is bTs.
+void AddSubtree(RobotBuilder *builder, const RobotGeneratorParams &params,
+                const LinkSharedPtr &parent, const Pose3 &bTs,
+                size_t levels_left, size_t *count) {
+  if (levels_left == 0) return;
+  const Pose3 bTend = bTs * Pose3(Rot3(), Point3(params.link_length, 0, 0));
+  for (double yaw : {M_PI_4, -M_PI_4}) {
+    const size_t i = (*count)++;
+    const Pose3 bTc = bTend * Pose3(Rot3::Yaw(yaw), Point3());
+    auto child = builder->addLink("link" + std::to_string(i), bTc);
+    builder->addJoint("joint" + std::to_string(i), bTc, parent, child,
+                      Vector3(0, 0, 1));
+    AddSubtree(builder, params, child, bTc, levels_left - 1, count);
+  }
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+Robot CreateSerialChain(size_t num_links, const RobotGeneratorParams &params) {
+  if (num_links == 0) {
+    throw std::invalid_argument("CreateSerialChain: need at least one link.");
+  }
+  RobotBuilder builder(params);
+  LinkSharedPtr parent = builder.addLink("link0", Pose3());
+  for (size_t i = 1; i < num_links; i++) {
+    const Pose3 bTs(Rot3(), Point3(i * params.link_length, 0, 0));
+    auto child = builder.addLink("link" + std::to_string(i), bTs);
+    const Vector3 axis = (i % 2) ? Vector3(0, 0, 1) : Vector3(0, 1, 0);
+    builder.addJoint("joint" + std::to_string(i), bTs, parent, child, axis);
+    parent = child;
+  }
+  return builder.robot();
+}
+
+/* ************************************************************************* */
+Robot CreateBinaryTree(size_t depth, const RobotGeneratorParams &params) {
+  RobotBuilder builder(params);
+  auto root = builder.addLink("link0", Pose3());
+  size_t count = 1;
+  AddSubtree(&builder, params, root, Pose3(), depth, &count);
+  return builder.robot();
+}
+
+/* ************************************************************************* */
+Robot CreateLeggedRobot(size_t num_legs, size_t links_per_leg,
+                        const RobotGeneratorParams &params) {
+  if (links_per_leg == 0) {
+    throw std::invalid_argument("CreateLeggedRobot: need at least one link.");
+  }
+  RobotBuilder builder(params);
+
+  // Torso is a solid cylinder about the z-axis.
+  const double m = params.body_mass, R = params.body_radius,
+               h = params.body_height;
+  const double I_xx = m * (3 * R * R + h * h) / 12;
+  const gtsam::Matrix3 body_inertia =
+      Vector3(I_xx, I_xx, 0.5 * m * R * R).asDiagonal();
+  auto body = builder.addLink("body", m, body_inertia, Pose3(), Pose3());
+
+  const Pose3 down(Rot3::Pitch(M_PI_2), Point3());  // maps x-axis to -z
+  for (size_t l = 0; l < num_legs; l++) {
+    const std::string leg = "leg" + std::to_string(l);
+    const Rot3 heading = Rot3::Yaw(2 * M_PI * l / num_legs);
+    Pose3 bTs = Pose3(heading, Point3()) * Pose3(Rot3(), Point3(R, 0, 0));
+    LinkSharedPtr parent = body;
+    for (size_t k = 0; k < links_per_leg; k++) {
+      const std::string suffix = "_link" + std::to_string(k);
+      if (k == 1) bTs = bTs * down;
+      auto child = builder.addLink(leg + suffix, bTs);
+      const Vector3 axis = (k == 0) ? Vector3(0, 0, 1) : Vector3(0, 1, 0);
+      builder.addJoint(leg + "_joint" + std::to_string(k), bTs, parent, child,
+                       axis);
+      parent = child;
+      bTs = bTs * Pose3(Rot3(), Point3(params.link_length, 0, 0));
+    }
+  }
+  return builder.robot();
+}
+
+}  // namespace gtdynamics
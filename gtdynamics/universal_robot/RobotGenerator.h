@@ -0,0 +1,79 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  RobotGenerator.h
+ * @brief Programmatic generation of robots of configurable size, e.g. for
+ * scaling benchmarks.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+
+#include <cmath>
+#include <cstddef>
+
+namespace gtdynamics {
+
+/**
+ * Physical parameters shared by all generated links and joints. Links are
+ * solid cylinders of uniform density along their local x-axis, so their
+ * inertias are physically consistent.
+ */
+struct RobotGeneratorParams {
+  double link_length = 0.3;       // length of each link [m]
+  double link_radius = 0.03;      // radius of each link [m]
+  double density = 1000.0;        // link density [kg/m^3]
+  double joint_limit = M_PI_2;    // symmetric joint angle limit [rad]
+  double velocity_limit = 10.0;   // joint velocity limit [rad/s]
+  double torque_limit = 100.0;    // joint torque limit [Nm]
+  double body_radius = 0.25;      // walker torso radius [m]
+  double body_height = 0.1;       // walker torso height [m]
+  double body_mass = 10.0;        // walker torso mass [kg]
+
+  RobotGeneratorParams() {}
+};
+
+/**
+ * @fn Create a serial chain of revolute joints.
+ * Links "link0".."link<n-1>" are laid out along the x-axis, and joint
+ * "joint<i>" connects link i-1 and link i, with axes alternating between z
+ * and y so that the chain is non-planar. No link is fixed.
+ * @param[in] num_links number of links, at most 255.
+ * @param[in] params physical parameters.
+ */
+Robot CreateSerialChain(size_t num_links,
+                        const RobotGeneratorParams &params =
+                            RobotGeneratorParams());
+
+/**
+ * @fn Create a binary tree of revolute joints.
+ * The root link "link0" has two children, each branching by +/-45 degrees in
+ * the plane of the parent, recursively, for a total of 2^(depth+1)-1 links.
+ * All joints rotate about their local z-axis. No link is fixed.
+ * @param[in] depth number of branching levels, at most 6.
+ * @param[in] params physical parameters.
+ */
+Robot CreateBinaryTree(size_t depth, const RobotGeneratorParams &params =
+                                         RobotGeneratorParams());
+
+/**
+ * @fn Create a walker with a cylindrical torso "body" and legs spaced
+ * evenly around it. Leg l has links "leg<l>_link<k>": the first one points
+ * radially outward behind a hip yaw joint, the others point down behind pitch
+ * joints. The foot is at (link_length, 0, 0) in the frame of the last link of
+ * each leg. No link is fixed.
+ * @param[in] num_legs number of legs.
+ * @param[in] links_per_leg number of links per leg, at least 1.
+ * @param[in] params physical parameters.
+ */
+Robot CreateLeggedRobot(size_t num_legs, size_t links_per_leg = 3,
+                        const RobotGeneratorParams &params =
+                            RobotGeneratorParams());
+
+}  // namespace gtdynamics
@@ -0,0 +1,290 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  GaitLibrary.cpp
+ * @brief Gait libraries: trajectory optimizations over a grid of walk cycle
+ * variants, solved in parallel with warm starts, saved to an indexed file.
+ */
+
+#include <gtdynamics/utils/GaitLibrary.h>
+#include <gtdynamics/utils/Parallel.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace gtdynamics {
+
+using gtsam::Key;
+using gtsam::Matrix;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Values;
+using gtsam::noiseModel::Isotropic;
+
+/* ************************************************************************* */
+std::vector<GaitVariant> GaitGrid::variants() const {
+  std::vector<GaitVariant> variants;
+  for (size_t c = 0; c < contact_sequences.size(); c++) {
+    for (auto &&lengths : phase_lengths) {
+      for (auto &&step : steps) variants.push_back({step, lengths, c});
+    }
+  }
+  return variants;
+}
+
+/* ************************************************************************* */
+WalkCycle GaitGrid::walkCycle(const GaitVariant &variant) const {
+  return WalkCycle(contact_sequences.at(variant.contact_sequence),
+                   variant.phase_lengths);
+}
+
+/* ************************************************************************* */
+GaitProblemFunction WalkingGaitProblem(const Robot &robot,
+                                       const DynamicsGraph &graph_builder,
+                                       double mu, double dt,
+                                       double ground_height,
+                                       double sigma_objectives) {
+  return [=](const Trajectory &trajectory, const GaitVariant &variant) {
+    auto model_1 = Isotropic::Sigma(1, sigma_objectives),
+         model_3 = Isotropic::Sigma(3, sigma_objectives),
+         model_6 = Isotropic::Sigma(6, sigma_objectives);
+    NonlinearFactorGraph graph = trajectory.multiPhaseFactorGraph(
+        robot, graph_builder, CollocationScheme::Euler, mu);
+    graph.add(trajectory.contactPointObjectives(robot, model_3, variant.step,
+                                                ground_height));
+    trajectory.addBoundaryConditions(&graph, robot, model_6, model_6, model_6,
+                                     model_1, model_1);
+    trajectory.addIntegrationTimeFactors(&graph, dt, sigma_objectives);
+    trajectory.addMinimumTorqueFactors(&graph, robot,
+                                       gtsam::noiseModel::Unit::Create(1));
+    Initializer initializer;
+    return GaitProblem(
+        graph, trajectory.multiPhaseInitialValues(robot, initializer, 0.0, dt));
+  };
+}
+
+/// Solve one entry, from the solution of another one if given.
+static void Solve(const GaitProblemFunction &problem,
+                  const gtsam::LevenbergMarquardtParams &lm_params,
+                  const GaitLibraryEntry *warm_start, GaitLibraryEntry *entry) {
+  auto [graph, init] = problem(entry->trajectory, entry->variant);
+  if (warm_start) {
+    for (Key key : warm_start->solution.keys()) {
+      if (init.exists(key)) init.update(key, warm_start->solution.at(key));
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  gtsam::LevenbergMarquardtOptimizer optimizer(graph, init, lm_params);
+  entry->solution = optimizer.optimize();
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  entry->stats.iterations = optimizer.iterations();
+  entry->stats.initial_error = graph.error(init);
+  entry->stats.final_error = graph.error(entry->solution);
+  entry->stats.solve_ms = elapsed.count();
+}
+
+/* ************************************************************************* */
+GaitLibrary::GaitLibrary(const GaitGrid &grid,
+                         const GaitProblemFunction &problem,
+                         const GaitLibraryParams &params) {
+  const std::vector<GaitVariant> variants = grid.variants();
+  const size_t n = variants.size();
+  entries_.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    entries_[i].variant = variants[i];
+    entries_[i].trajectory =
+        Trajectory(grid.walkCycle(variants[i]), params.repeat);
+  }
+
+  // Variants with the same phase lengths and contact sequence have the same
+  // variables, and can warm-start each other.
+  auto same_group = [&](size_t i, size_t j) {
+    return variants[i].contact_sequence == variants[j].contact_sequence &&
+           variants[i].phase_lengths == variants[j].phase_lengths;
+  };
+  auto distance = [&](size_t i, size_t j) {
+    return (variants[i].step - variants[j].step).norm();
+  };
+
+  // Seeds: the variant of each group closest to the center of its steps.
+  std::vector<size_t> wave;
+  std::vector<bool> seeded(n, false);
+  for (size_t i = 0; i < n; i++) {
+    if (seeded[i]) continue;
+    std::vector<size_t> group;
+    gtsam::Point3 center(0, 0, 0);
+    for (size_t j = i; j < n; j++) {
+      if (!same_group(i, j)) continue;
+      group.push_back(j);
+      center += variants[j].step;
+      seeded[j] = true;
+    }
+    center /= static_cast<double>(group.size());
+    size_t seed = group.front();
+    for (size_t j : group) {
+      if ((variants[j].step - center).norm() <
+          (variants[seed].step - center).norm()) {
+        seed = j;
+      }
+    }
+    wave.push_back(seed);
+  }
+
+  std::vector<bool> solved(n, false);
+  std::vector<std::optional<size_t>> nearest(n);
+  while (!wave.empty()) {
+    ParallelFor(
+        wave.size(),
+        [&](size_t w) {
+          const size_t i = wave[w];
+          if (nearest[i]) entries_[i].stats.warm_start = *nearest[i];
+          Solve(problem, params.lm_params,
+                nearest[i] ? &entries_[*nearest[i]] : nullptr, &entries_[i]);
+        },
+        params.num_threads);
+    for (size_t i : wave) solved[i] = true;
+
+    // Next wave: the unsolved variants closest to a solved one.
+    std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+    double min_distance = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++) {
+      if (solved[i]) continue;
+      for (size_t j = 0; j < n; j++) {
+        if (solved[j] && same_group(i, j) && distance(i, j) < distances[i]) {
+          distances[i] = distance(i, j);
+          nearest[i] = j;
+        }
+      }
+      min_distance = std::min(min_distance, distances[i]);
+    }
+    wave.clear();
+    for (size_t i = 0; i < n; i++) {
+      if (!solved[i] && distances[i] <= min_distance * (1 + 1e-9)) {
+        wave.push_back(i);
+      }
+    }
+  }
+}
+
+/* ************************************************************************* */
+void GaitLibrary::write(const Robot &robot,
+                        const std::string &file_path) const {
+  const static Eigen::IOFormat CSVFormat(Eigen::FullPrecision,
+                                         Eigen::DontAlignCols, ",", "\n");
+  std::string joint_names;
+  for (auto &&joint : robot.joints()) joint_names += joint->name() + ",";
+
+  // Data section first, to know the offsets of the entries.
+  std::ostringstream data;
+  std::vector<std::pair<size_t, size_t>> offsets;  // bytes, rows
+  for (auto &&entry : entries_) {
+    const size_t offset = data.tellp();
+    size_t num_rows = 0;
+    const Trajectory &trajectory = entry.trajectory;
+    for (size_t p = 0; p < trajectory.numPhases(); p++) {
+      const bool has_dt = entry.solution.exists(PhaseKey(p));
+      const Matrix rows = trajectory.phase(p).jointMatrix(
+          robot, entry.solution, trajectory.getStartTimeStep(p),
+          has_dt ? entry.solution.atDouble(PhaseKey(p)) : 0.0);
+      data << rows.format(CSVFormat) << "\n";
+      num_rows += rows.rows();
+    }
+    offsets.emplace_back(offset, num_rows);
+  }
+
+  std::ofstream file(file_path);
+  file << "# gtdynamics gait library\n";
+  file << "entries " << entries_.size() << "\n";
+  // angles, vels, accels, torques, time.
+  file << "columns " << joint_names << joint_names << joint_names
+       << joint_names << "t\n";
+  file << "# index,step_x,step_y,step_z,phase_lengths,contact_sequence,"
+          "offset,num_rows,iterations,initial_error,final_error,solve_ms,"
+          "warm_start\n";
+  for (size_t i = 0; i < entries_.size(); i++) {
+    const auto &variant = entries_[i].variant;
+    const auto &stats = entries_[i].stats;
+    std::string lengths;
+    for (size_t l = 0; l < variant.phase_lengths.size(); l++) {
+      lengths += (l ? ";" : "") + std::to_string(variant.phase_lengths[l]);
+    }
+    file << i << "," << variant.step.x() << "," << variant.step.y() << ","
+         << variant.step.z() << "," << lengths << ","
+         << variant.contact_sequence << "," << offsets[i].first << ","
+         << offsets[i].second << "," << stats.iterations << ","
+         << stats.initial_error << "," << stats.final_error << ","
+         << stats.solve_ms << "," << stats.warm_start << "\n";
+  }
+  file << "data\n" << data.str();
+}
+
+/// Split a line of comma-separated values.
+static std::vector<std::string> SplitCSV(const std::string &line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) fields.push_back(field);
+  return fields;
+}
+
+/* ************************************************************************* */
+Matrix GaitLibrary::ReadEntry(const std::string &file_path, size_t index) {
+  std::ifstream file(file_path);
+  if (!file) {
+    throw std::runtime_error("GaitLibrary: cannot open " + file_path);
+  }
+  std::string line, word;
+  size_t num_entries = 0;
+  std::getline(file, line);  // title
+  file >> word >> num_entries;
+  if (word != "entries") {
+    throw std::runtime_error("GaitLibrary: " + file_path +
+                             " is not a gait library.");
+  }
+  if (index >= num_entries) {
+    throw std::invalid_argument("GaitLibrary: no entry " +
+                                std::to_string(index) + " in " + file_path);
+  }
+  std::getline(file, line);  // rest of the entries line
+  std::getline(file, line);
+  const size_t num_columns = SplitCSV(line).size();
+  std::getline(file, line);  // index header
+
+  size_t offset = 0, num_rows = 0;
+  for (size_t i = 0; i < num_entries; i++) {
+    std::getline(file, line);
+    if (i != index) continue;
+    const auto fields = SplitCSV(line);
+    offset = std::stoul(fields.at(6));
+    num_rows = std::stoul(fields.at(7));
+  }
+  std::getline(file, line);  // data
+  file.seekg(file.tellg() + std::streamoff(offset));
+
+  Matrix rows(num_rows, num_columns);
+  for (size_t r = 0; r < num_rows; r++) {
+    std::getline(file, line);
+    const auto fields = SplitCSV(line);
+    if (fields.size() != num_columns) {
+      throw std::runtime_error("GaitLibrary: corrupt entry " +
+                               std::to_string(index) + " in " + file_path);
+    }
+    for (size_t c = 0; c < num_columns; c++) rows(r, c) = std::stod(fields[c]);
+  }
+  return rows;
+}
+
+}  // namespace gtdynamics
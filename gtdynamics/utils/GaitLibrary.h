@@ -0,0 +1,155 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  GaitLibrary.h
+ * @brief Gait libraries: trajectory optimizations over a grid of walk cycle
+ * variants, solved in parallel with warm starts, saved to an indexed file.
+ */
+
+#pragma once
+
+#include <gtdynamics/utils/Trajectory.h>
+#include <gtsam/nonlinear/LevenbergMarquardtParams.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gtdynamics {
+
+/// One walk cycle variant of a gait library.
+struct GaitVariant {
+  gtsam::Point3 step;                 ///< Displacement of a foot per step.
+  std::vector<size_t> phase_lengths;  ///< Number of time steps per phase.
+  size_t contact_sequence = 0;  ///< Index in GaitGrid::contact_sequences.
+};
+
+/**
+ * Grid of walk cycle variants, the cartesian product of step displacements,
+ * phase lengths and contact sequences.
+ */
+struct GaitGrid {
+  std::vector<gtsam::Point3> steps;
+  std::vector<std::vector<size_t>> phase_lengths;
+  std::vector<FootContactVector> contact_sequences;
+
+  /// All variants, with steps varying fastest, then phase lengths.
+  std::vector<GaitVariant> variants() const;
+
+  /// Walk cycle of a variant.
+  WalkCycle walkCycle(const GaitVariant &variant) const;
+};
+
+/// Solve statistics of a gait library entry.
+struct GaitSolveStats {
+  size_t iterations = 0;     ///< Levenberg-Marquardt iterations.
+  double initial_error = 0;  ///< Error at the initial values.
+  double final_error = 0;    ///< Error at the solution.
+  double solve_ms = 0;       ///< Wall time of the solve.
+  int warm_start = -1;  ///< Entry the solve started from, -1 if cold.
+};
+
+/// Solved entry of a gait library.
+struct GaitLibraryEntry {
+  GaitVariant variant;
+  Trajectory trajectory;
+  gtsam::Values solution;
+  GaitSolveStats stats;
+};
+
+/**
+ * Trajectory optimization problem of a variant: factor graph, and initial
+ * values for a cold start.
+ */
+using GaitProblem = std::pair<gtsam::NonlinearFactorGraph, gtsam::Values>;
+using GaitProblemFunction =
+    std::function<GaitProblem(const Trajectory &, const GaitVariant &)>;
+
+/**
+ * @fn Walking problem as in the quadruped examples: multi-phase dynamics,
+ * contact point goals that move the feet by the step of the variant, boundary
+ * conditions, a fixed integration time step, and minimum torques.
+ * @param robot the robot.
+ * @param graph_builder builder of the dynamics factors.
+ * @param mu coefficient of static friction.
+ * @param dt integration time step.
+ * @param ground_height height of the ground in the robot rest configuration.
+ * @param sigma_objectives standard deviation of the objectives.
+ */
+GaitProblemFunction WalkingGaitProblem(const Robot &robot,
+                                       const DynamicsGraph &graph_builder,
+                                       double mu, double dt,
+                                       double ground_height = 0.0,
+                                       double sigma_objectives = 1e-3);
+
+/// Parameters of gait library generation.
+struct GaitLibraryParams {
+  size_t repeat = 1;       ///< Walk cycles per trajectory.
+  size_t num_threads = 0;  ///< 0 for hardware concurrency, 1 for serial.
+  gtsam::LevenbergMarquardtParams lm_params;
+};
+
+/**
+ * GaitLibrary solves the trajectory optimization of every variant of a grid.
+ *
+ * Variants with the same phase lengths and contact sequence have the same
+ * variables, and are warm-started from the solution of their nearest solved
+ * neighbour, by step displacement. Solves proceed in waves: first one
+ * cold-started seed per group of such variants, near the center of the
+ * group, then, repeatedly, all unsolved variants closest to a solved one.
+ * Variants within a wave are solved in parallel.
+ */
+class GaitLibrary {
+ private:
+  std::vector<GaitLibraryEntry> entries_;
+
+ public:
+  /// Default constructor.
+  GaitLibrary() {}
+
+  /**
+   * Solve all variants of a grid.
+   * @param grid walk cycle variants.
+   * @param problem trajectory optimization problem of a variant.
+   * @param params repetitions, threads and optimizer parameters.
+   */
+  GaitLibrary(const GaitGrid &grid, const GaitProblemFunction &problem,
+              const GaitLibraryParams &params = GaitLibraryParams());
+
+  /// Entries, in the order of GaitGrid::variants().
+  const std::vector<GaitLibraryEntry> &entries() const { return entries_; }
+
+  /// Number of entries.
+  size_t size() const { return entries_.size(); }
+
+  /**
+   * Write the library as text: a header with the number of entries and the
+   * column names, one index line per entry with its variant, the byte offset
+   * and number of its rows in the data section, and its solve statistics,
+   * then the data section with the joint angles, velocities, accelerations,
+   * torques and time step of every time step, as in Trajectory::writeToFile.
+   * The time step is 0 for problems without phase duration variables.
+   * @param robot the robot.
+   * @param file_path path of the library file.
+   */
+  void write(const Robot &robot, const std::string &file_path) const;
+
+  /**
+   * @fn Read the rows of one entry of a library file, seeking through the
+   * index rather than parsing the whole file.
+   * @param file_path path of the library file.
+   * @param index entry index.
+   * @return rows of the entry, one per time step.
+   */
+  static gtsam::Matrix ReadEntry(const std::string &file_path, size_t index);
+};
+
+}  // namespace gtdynamics
@@ -0,0 +1,201 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  Heightmap.cpp
+ * @brief Terrain height on a regular 2D grid, for contacts on rough terrain.
+ */
+
+#include <gtdynamics/utils/Heightmap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::Matrix2;
+using gtsam::Point2;
+using gtsam::Point3;
+using gtsam::Vector2;
+using gtsam::Vector3;
+
+/* ************************************************************************* */
+Heightmap::Heightmap(const Point2 &origin, double cell_size, size_t nx,
+                     size_t ny, const std::vector<double> &data,
+                     Interpolation interpolation)
+    : origin_(origin),
+      cell_size_(cell_size),
+      nx_(nx),
+      ny_(ny),
+      data_(data),
+      interpolation_(interpolation) {
+  if (nx < 2 || ny < 2) {
+    throw std::invalid_argument(
+        "Heightmap: need at least 2 vertices along each axis.");
+  }
+  if (cell_size <= 0) {
+    throw std::invalid_argument("Heightmap: cell size must be positive.");
+  }
+  if (data.size() != nx * ny) {
+    throw std::invalid_argument("Heightmap: expected " +
+                                std::to_string(nx * ny) + " values, got " +
+                                std::to_string(data.size()));
+  }
+}
+
+/* ************************************************************************* */
+Heightmap Heightmap::FromFunction(
+    const Point2 &origin, double cell_size, size_t nx, size_t ny,
+    const std::function<double(double, double)> &height,
+    Interpolation interpolation) {
+  std::vector<double> data;
+  data.reserve(nx * ny);
+  for (size_t j = 0; j < ny; j++) {
+    for (size_t i = 0; i < nx; i++) {
+      data.push_back(
+          height(origin.x() + cell_size * i, origin.y() + cell_size * j));
+    }
+  }
+  return Heightmap(origin, cell_size, nx, ny, data, interpolation);
+}
+
+/**
+ * Weights of the vertices at offsets -1, 0, 1, 2 from the lower vertex of a
+ * cell, and their first and second derivatives, at fraction t of the cell.
+ */
+static void Weights(Heightmap::Interpolation interpolation, double t,
+                    double w[4], double dw[4], double ddw[4]) {
+  if (interpolation == Heightmap::Bilinear) {
+    const double lw[4] = {0, 1 - t, t, 0}, ldw[4] = {0, -1, 1, 0};
+    std::copy(lw, lw + 4, w);
+    std::copy(ldw, ldw + 4, dw);
+    std::fill(ddw, ddw + 4, 0.0);
+    return;
+  }
+  // Catmull-Rom spline.
+  const double t2 = t * t, t3 = t2 * t;
+  const double cw[4] = {0.5 * (-t + 2 * t2 - t3), 0.5 * (2 - 5 * t2 + 3 * t3),
+                        0.5 * (t + 4 * t2 - 3 * t3), 0.5 * (-t2 + t3)};
+  const double cdw[4] = {0.5 * (-1 + 4 * t - 3 * t2), 0.5 * (-10 * t + 9 * t2),
+                         0.5 * (1 + 8 * t - 9 * t2), 0.5 * (-2 * t + 3 * t2)};
+  const double cddw[4] = {0.5 * (4 - 6 * t), 0.5 * (-10 + 18 * t),
+                          0.5 * (8 - 18 * t), 0.5 * (-2 + 6 * t)};
+  std::copy(cw, cw + 4, w);
+  std::copy(cdw, cdw + 4, dw);
+  std::copy(cddw, cddw + 4, ddw);
+}
+
+/* ************************************************************************* */
+double Heightmap::evaluate(const Point2 &xy, Vector2 *gradient,
+                           Matrix2 *hessian) const {
+  // Continuous grid coordinates, clamped to the grid, split into the lower
+  // vertex index and the fraction within the cell.
+  const Point2 g = (xy - origin_) / cell_size_;
+  const size_t n[2] = {nx_, ny_};
+  int idx[2];
+  bool clamped[2];
+  double w[2][4], dw[2][4], ddw[2][4];
+  for (int a = 0; a < 2; a++) {
+    const double max = n[a] - 1;
+    const double c = std::min(std::max(g[a], 0.0), max);
+    clamped[a] = (c != g[a]);
+    idx[a] = std::min(static_cast<int>(c), static_cast<int>(n[a]) - 2);
+    Weights(interpolation_, c - idx[a], w[a], dw[a], ddw[a]);
+  }
+
+  // Sum over the 2x2 or 4x4 neighborhood, replicating the boundary vertices.
+  const int first = interpolation_ == Bilinear ? 1 : 0, last = 3 - first;
+  double h = 0;
+  Vector2 dh = Vector2::Zero();
+  Matrix2 ddh = Matrix2::Zero();
+  for (int dj = first; dj <= last; dj++) {
+    const int j = std::min(std::max(idx[1] + dj - 1, 0), int(ny_) - 1);
+    for (int di = first; di <= last; di++) {
+      const int i = std::min(std::max(idx[0] + di - 1, 0), int(nx_) - 1);
+      const double v = at(i, j);
+      h += w[0][di] * w[1][dj] * v;
+      dh[0] += dw[0][di] * w[1][dj] * v;
+      dh[1] += w[0][di] * dw[1][dj] * v;
+      ddh(0, 0) += ddw[0][di] * w[1][dj] * v;
+      ddh(0, 1) += dw[0][di] * dw[1][dj] * v;
+      ddh(1, 1) += w[0][di] * ddw[1][dj] * v;
+    }
+  }
+  ddh(1, 0) = ddh(0, 1);
+
+  for (int a = 0; a < 2; a++) {
+    if (clamped[a]) {
+      dh[a] = 0;
+      ddh.row(a).setZero();
+      ddh.col(a).setZero();
+    }
+  }
+  if (gradient) *gradient = dh / cell_size_;
+  if (hessian) *hessian = ddh / (cell_size_ * cell_size_);
+  return h;
+}
+
+/* ************************************************************************* */
+double Heightmap::height(const Point2 &xy,
+                         gtsam::OptionalJacobian<1, 2> H) const {
+  Vector2 gradient;
+  const double h = evaluate(xy, H ? &gradient : nullptr);
+  if (H) *H = gradient.transpose();
+  return h;
+}
+
+/* ************************************************************************* */
+double Heightmap::heightAbove(const Point3 &point,
+                              gtsam::OptionalJacobian<1, 3> H) const {
+  Vector2 gradient;
+  const double h = evaluate(point.head<2>(), H ? &gradient : nullptr);
+  if (H) *H << -gradient.transpose(), 1.0;
+  return point.z() - h;
+}
+
+/* ************************************************************************* */
+Vector3 Heightmap::normal(const Point3 &point,
+                          gtsam::OptionalJacobian<3, 3> H) const {
+  Vector2 gradient;
+  Matrix2 hessian;
+  evaluate(point.head<2>(), &gradient, H ? &hessian : nullptr);
+  const Vector3 u(-gradient.x(), -gradient.y(), 1.0);
+  const double norm = u.norm();
+  const Vector3 n = u / norm;
+  if (H) {
+    gtsam::Matrix3 du = gtsam::Matrix3::Zero();
+    du.topLeftCorner<2, 2>() = -hessian;
+    *H = (gtsam::I_3x3 - n * n.transpose()) / norm * du;
+  }
+  return n;
+}
+
+/* ************************************************************************* */
+void Heightmap::print(const std::string &s) const {
+  std::cout << (s.empty() ? s : s + " ") << "Heightmap " << nx_ << "x" << ny_
+            << ", cell size " << cell_size_ << ", origin "
+            << origin_.transpose() << ", "
+            << (interpolation_ == Bilinear ? "bilinear" : "bicubic")
+            << std::endl;
+}
+
+/* ************************************************************************* */
+bool Heightmap::equals(const Heightmap &other, double tol) const {
+  if (nx_ != other.nx_ || ny_ != other.ny_) return false;
+  if (interpolation_ != other.interpolation_) return false;
+  if (std::abs(cell_size_ - other.cell_size_) > tol) return false;
+  if ((origin_ - other.origin_).norm() > tol) return false;
+  for (size_t i = 0; i < data_.size(); i++) {
+    if (std::abs(data_[i] - other.data_[i]) > tol) return false;
+  }
+  return true;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,146 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  Heightmap.h
+ * @brief Terrain height on a regular 2D grid, for contacts on rough terrain.
+ */
+
+#pragma once
+
+#include <gtsam/base/OptionalJacobian.h>
+#include <gtsam/geometry/Point2.h>
+#include <gtsam/geometry/Point3.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+#include <boost/serialization/vector.hpp>
+#endif
+
+namespace gtdynamics {
+
+/**
+ * Heightmap stores the terrain height, along the world z-axis, at the vertices
+ * of a regular grid in the x-y plane. Queries interpolate between the
+ * surrounding vertices, bilinearly (2x2 vertices) or with Catmull-Rom bicubic
+ * splines (4x4 vertices), so they take constant time, and heights, gradients
+ * and normals have analytic derivatives. Queries outside the grid are clamped
+ * to its boundary, with zero slope along the clamped axes.
+ */
+class Heightmap {
+ public:
+  enum Interpolation { Bilinear, Bicubic };
+
+ private:
+  gtsam::Point2 origin_;    // position of vertex (0, 0)
+  double cell_size_ = 1.0;  // distance between neighboring vertices
+  size_t nx_ = 0, ny_ = 0;
+  std::vector<double> data_;  // x varies fastest
+  Interpolation interpolation_ = Bilinear;
+
+ public:
+  /// Default constructor, for serialization.
+  Heightmap() {}
+
+  /**
+   * Constructor.
+   * @param origin position of the first grid vertex in the x-y plane.
+   * @param cell_size distance between neighboring vertices.
+   * @param nx, ny number of vertices along each axis, at least 2.
+   * @param data heights, x varies fastest.
+   * @param interpolation bilinear or bicubic.
+   */
+  Heightmap(const gtsam::Point2 &origin, double cell_size, size_t nx,
+            size_t ny, const std::vector<double> &data,
+            Interpolation interpolation = Bilinear);
+
+  /**
+   * @fn Sample a height function at the grid vertices.
+   * @param origin position of the first grid vertex in the x-y plane.
+   * @param cell_size distance between neighboring vertices.
+   * @param nx, ny number of vertices along each axis, at least 2.
+   * @param height height as a function of x and y.
+   * @param interpolation bilinear or bicubic.
+   */
+  static Heightmap FromFunction(
+      const gtsam::Point2 &origin, double cell_size, size_t nx, size_t ny,
+      const std::function<double(double, double)> &height,
+      Interpolation interpolation = Bilinear);
+
+  /**
+   * Terrain height below a point in the x-y plane.
+   * @param xy query point.
+   * @param H optional gradient of the height w.r.t. the point.
+   */
+  double height(const gtsam::Point2 &xy,
+                gtsam::OptionalJacobian<1, 2> H = {}) const;
+
+  /**
+   * Height of a point above the terrain, z - height(x, y), negative below it.
+   * @param point query point.
+   * @param H optional Jacobian w.r.t. the point.
+   */
+  double heightAbove(const gtsam::Point3 &point,
+                     gtsam::OptionalJacobian<1, 3> H = {}) const;
+
+  /**
+   * Unit upward normal of the terrain below a point.
+   * @param point query point, only x and y matter.
+   * @param H optional Jacobian w.r.t. the point.
+   */
+  gtsam::Vector3 normal(const gtsam::Point3 &point,
+                        gtsam::OptionalJacobian<3, 3> H = {}) const;
+
+  /// Position of the first grid vertex.
+  const gtsam::Point2 &origin() const { return origin_; }
+
+  /// Distance between neighboring vertices.
+  double cellSize() const { return cell_size_; }
+
+  /// Number of vertices along x and y.
+  size_t nx() const { return nx_; }
+  size_t ny() const { return ny_; }
+
+  /// Interpolation between vertices.
+  Interpolation interpolation() const { return interpolation_; }
+
+  /// Height stored at vertex (i, j).
+  double at(size_t i, size_t j) const { return data_[j * nx_ + i]; }
+
+  /// Print a short description.
+  void print(const std::string &s = "") const;
+
+  /// Check equality up to a tolerance.
+  bool equals(const Heightmap &other, double tol = 1e-9) const;
+
+ private:
+  /// Interpolated height, with its gradient and Hessian w.r.t. x and y.
+  double evaluate(const gtsam::Point2 &xy, gtsam::Vector2 *gradient = nullptr,
+                  gtsam::Matrix2 *hessian = nullptr) const;
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &BOOST_SERIALIZATION_NVP(origin_);
+    ar &BOOST_SERIALIZATION_NVP(cell_size_);
+    ar &BOOST_SERIALIZATION_NVP(nx_);
+    ar &BOOST_SERIALIZATION_NVP(ny_);
+    ar &BOOST_SERIALIZATION_NVP(data_);
+    ar &BOOST_SERIALIZATION_NVP(interpolation_);
+  }
+#endif
+};
+
+using HeightmapSharedPtr = std::shared_ptr<Heightmap>;
+
+}  // namespace gtdynamics
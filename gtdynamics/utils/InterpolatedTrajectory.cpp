@@ -0,0 +1,237 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  InterpolatedTrajectory.cpp
+ * @brief Continuous-time trajectory compiled from optimized knot values, for
+ * streaming setpoints to controllers.
+ */
+
+#include <gtdynamics/utils/InterpolatedTrajectory.h>
+#include <gtdynamics/utils/values.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::Matrix;
+using gtsam::Pose3;
+using gtsam::Values;
+using gtsam::Vector;
+
+namespace {
+
+/// Joint values at every knot, as a (K + 1) x n matrix.
+Matrix KnotMatrix(const Robot &robot, const Values &values, size_t num_knots,
+                  gtsam::Key (*key)(int, int)) {
+  Matrix result(num_knots, robot.numJoints());
+  for (size_t k = 0; k < num_knots; k++) {
+    for (auto &&joint : robot.joints()) {
+      result(k, joint->id()) = values.atDouble(key(joint->id(), k));
+    }
+  }
+  return result;
+}
+
+/// Derivative of knot values by finite differences, one-sided at the ends.
+Matrix Differentiate(const Matrix &x, const std::vector<double> &times) {
+  const size_t K = times.size() - 1;
+  Matrix dx(x.rows(), x.cols());
+  for (size_t k = 0; k <= K; k++) {
+    const size_t k0 = std::max<size_t>(k, 1) - 1, k1 = std::min(k + 1, K);
+    dx.row(k) = (x.row(k1) - x.row(k0)) / (times[k1] - times[k0]);
+  }
+  return dx;
+}
+
+/// Whether the values have the key of every joint at every knot.
+bool HasAll(const Robot &robot, const Values &values, size_t num_knots,
+            gtsam::Key (*key)(int, int)) {
+  for (size_t k = 0; k < num_knots; k++) {
+    for (auto &&joint : robot.joints()) {
+      if (!values.exists(key(joint->id(), k))) return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+InterpolatedTrajectory::InterpolatedTrajectory(
+    const Robot &robot, const Values &values, const std::vector<double> &times,
+    Interpolation interpolation)
+    : interpolation_(interpolation),
+      num_joints_(robot.numJoints()),
+      times_(times) {
+  const size_t num_knots = times.size();
+  if (num_knots < 2) {
+    throw std::invalid_argument(
+        "InterpolatedTrajectory: need at least 2 knots.");
+  }
+  for (size_t k = 0; k + 1 < num_knots; k++) {
+    if (times[k + 1] <= times[k]) {
+      throw std::invalid_argument(
+          "InterpolatedTrajectory: knot times should be increasing.");
+    }
+  }
+
+  // Knot angles, velocities and accelerations.
+  const Matrix q = KnotMatrix(robot, values, num_knots, JointAngleKey);
+  const Matrix v = HasAll(robot, values, num_knots, JointVelKey)
+                       ? KnotMatrix(robot, values, num_knots, JointVelKey)
+                       : Differentiate(q, times);
+  Matrix a = Matrix::Zero(num_knots, num_joints_);
+  if (interpolation == Quintic) {
+    a = HasAll(robot, values, num_knots, JointAccelKey)
+            ? KnotMatrix(robot, values, num_knots, JointAccelKey)
+            : Differentiate(v, times);
+  }
+
+  // Hermite coefficients in the normalized time tau in [0, 1] of each
+  // segment, where derivatives scale with the segment duration h.
+  const size_t num_segments = num_knots - 1;
+  coefficients_ = Matrix::Zero(6 * num_segments, num_joints_);
+  for (size_t k = 0; k < num_segments; k++) {
+    const double h = times[k + 1] - times[k];
+    const Vector dq = q.row(k + 1) - q.row(k);
+    const Vector v0 = h * v.row(k), v1 = h * v.row(k + 1);
+    auto c = coefficients_.middleRows(6 * k, 6);
+    c.row(0) = q.row(k);
+    c.row(1) = v0;
+    if (interpolation == Cubic) {
+      c.row(2) = 3 * dq - 2 * v0 - v1;
+      c.row(3) = -2 * dq + v0 + v1;
+    } else {
+      const Vector a0 = h * h * a.row(k), a1 = h * h * a.row(k + 1);
+      c.row(2) = a0 / 2;
+      c.row(3) = 10 * dq - 6 * v0 - 4 * v1 - (3 * a0 - a1) / 2;
+      c.row(4) = -15 * dq + 8 * v0 + 7 * v1 + (3 * a0 - 2 * a1) / 2;
+      c.row(5) = 6 * dq - 3 * (v0 + v1) - (a0 - a1) / 2;
+    }
+  }
+
+  // Link poses, and the relative twist of each link over each segment.
+  bool has_poses = true;
+  for (size_t k = 0; k < num_knots && has_poses; k++) {
+    for (auto &&link : robot.links()) {
+      if (!values.exists(PoseKey(link->id(), k))) has_poses = false;
+    }
+  }
+  if (has_poses) {
+    poses_.assign(num_knots, std::vector<Pose3>(robot.numLinks()));
+    for (size_t k = 0; k < num_knots; k++) {
+      for (auto &&link : robot.links()) {
+        poses_[k][link->id()] = Pose(values, link->id(), k);
+      }
+    }
+    twists_.assign(num_segments,
+                   std::vector<gtsam::Vector6>(robot.numLinks()));
+    for (size_t k = 0; k < num_segments; k++) {
+      for (size_t i = 0; i < robot.numLinks(); i++) {
+        twists_[k][i] =
+            Pose3::Logmap(poses_[k][i].between(poses_[k + 1][i]));
+      }
+    }
+  }
+
+  // Segment lookup table, with as many buckets as segments: with evenly
+  // spaced knots, each bucket overlaps at most two segments.
+  const size_t num_buckets = num_segments;
+  bucket_width_ = (endTime() - startTime()) / num_buckets;
+  buckets_.resize(num_buckets + 1);
+  size_t s = 0;
+  for (size_t b = 0; b < num_buckets; b++) {
+    const double t = startTime() + b * bucket_width_;
+    while (s + 1 < num_segments && times_[s + 1] <= t) s++;
+    buckets_[b] = s;
+  }
+  buckets_[num_buckets] = num_segments - 1;
+}
+
+/* ************************************************************************* */
+InterpolatedTrajectory::InterpolatedTrajectory(const Robot &robot,
+                                               const Trajectory &trajectory,
+                                               const Values &results,
+                                               Interpolation interpolation)
+    : InterpolatedTrajectory(robot, results, KnotTimes(trajectory, results),
+                             interpolation) {}
+
+/* ************************************************************************* */
+std::vector<double> InterpolatedTrajectory::KnotTimes(
+    const Trajectory &trajectory, const Values &results) {
+  std::vector<double> times{0.0};
+  for (size_t p = 0; p < trajectory.numPhases(); p++) {
+    if (!results.exists(PhaseKey(p))) {
+      throw std::invalid_argument(
+          "InterpolatedTrajectory: results have no time step for phase " +
+          std::to_string(p) + ".");
+    }
+    const double dt = results.atDouble(PhaseKey(p));
+    for (size_t k = 0; k < trajectory.phase(p).numTimeSteps(); k++) {
+      times.push_back(times.back() + dt);
+    }
+  }
+  return times;
+}
+
+/* ************************************************************************* */
+size_t InterpolatedTrajectory::segment(double t) const {
+  const double offset = std::max(t - startTime(), 0.0);
+  const size_t b = std::min(static_cast<size_t>(offset / bucket_width_),
+                            buckets_.size() - 2);
+  // Bisect the segments that overlap the bucket.
+  const auto first = times_.begin() + buckets_[b] + 1;
+  const auto last = times_.begin() + buckets_[b + 1] + 1;
+  return std::upper_bound(first, last, t) - times_.begin() - 1;
+}
+
+/* ************************************************************************* */
+TrajectorySample InterpolatedTrajectory::makeSample() const {
+  TrajectorySample sample;
+  sample.q = Vector::Zero(num_joints_);
+  sample.v = Vector::Zero(num_joints_);
+  sample.a = Vector::Zero(num_joints_);
+  if (hasPoses()) sample.poses.resize(poses_.front().size());
+  return sample;
+}
+
+/* ************************************************************************* */
+void InterpolatedTrajectory::sample(double t, TrajectorySample *sample) const {
+  t = std::min(std::max(t, startTime()), endTime());
+  const size_t s = segment(t);
+  const double h = times_[s + 1] - times_[s];
+  const double tau = (t - times_[s]) / h;
+  const auto c = coefficients_.middleRows(6 * s, 6);
+
+  // Horner's scheme on the angles and their derivatives w.r.t. tau.
+  const int degree = interpolation_ == Cubic ? 3 : 5;
+  sample->t = t;
+  sample->q = c.row(degree).transpose();
+  sample->v = degree * c.row(degree).transpose();
+  sample->a = degree * (degree - 1) * c.row(degree).transpose();
+  for (int i = degree - 1; i >= 0; i--) {
+    sample->q = tau * sample->q + c.row(i).transpose();
+    if (i >= 1) sample->v = tau * sample->v + i * c.row(i).transpose();
+    if (i >= 2) {
+      sample->a = tau * sample->a + i * (i - 1) * c.row(i).transpose();
+    }
+  }
+  sample->v /= h;
+  sample->a /= h * h;
+
+  if (hasPoses()) {
+    for (size_t i = 0; i < sample->poses.size(); i++) {
+      sample->poses[i] = poses_[s][i] * Pose3::Expmap(tau * twists_[s][i]);
+    }
+  }
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,183 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  InterpolatedTrajectory.h
+ * @brief Continuous-time trajectory compiled from optimized knot values, for
+ * streaming setpoints to controllers.
+ */
+
+#pragma once
+
+#include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/Trajectory.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace gtdynamics {
+
+/// Setpoint of a trajectory at a given time.
+struct TrajectorySample {
+  double t = 0.0;
+  gtsam::Vector q, v, a;            // joint angles, velocities, accelerations
+  std::vector<gtsam::Pose3> poses;  // link poses, indexed by link id
+};
+
+/**
+ * InterpolatedTrajectory interpolates joint angles with a Hermite spline per
+ * joint, cubic on angles and velocities or quintic on angles, velocities and
+ * accelerations, and link poses along the SE(3) geodesic between knots.
+ *
+ * All spline coefficients and relative link twists are computed once, at
+ * construction. Segments are found through a table of uniform time buckets,
+ * one per segment, and bisection among the segments overlapping a bucket. So
+ * sample(t, &sample) takes constant time for evenly spaced knots, logarithmic
+ * time at worst, and does not allocate once the sample has been sized by
+ * makeSample().
+ * Times outside the trajectory are clamped to its ends.
+ */
+class InterpolatedTrajectory {
+ public:
+  enum Interpolation { Cubic, Quintic };
+
+ private:
+  Interpolation interpolation_;
+  size_t num_joints_;
+  std::vector<double> times_;     // knot times
+  gtsam::Matrix coefficients_;    // 6 rows per segment, one column per joint
+  std::vector<std::vector<gtsam::Pose3>> poses_;    // [knot][link]
+  std::vector<std::vector<gtsam::Vector6>> twists_;  // [segment][link]
+  double bucket_width_;
+  std::vector<size_t> buckets_;  // first segment of each time bucket, and
+                                 // the last segment
+
+ public:
+  /**
+   * Construct from values at knots 0..K, at the given times. Joint velocities
+   * and accelerations missing from the values are estimated by finite
+   * differences. Link poses are interpolated only if all of them are given.
+   * @param robot the robot.
+   * @param values joint angles, and optionally velocities, accelerations and
+   * link poses, at time steps 0..K.
+   * @param times increasing knot times, of size K + 1 >= 2.
+   * @param interpolation spline type.
+   */
+  InterpolatedTrajectory(const Robot &robot, const gtsam::Values &values,
+                         const std::vector<double> &times,
+                         Interpolation interpolation = Quintic);
+
+  /**
+   * Construct from the results of a trajectory optimization, with the time
+   * step of each phase given by its PhaseKey.
+   * @param robot the robot.
+   * @param trajectory the trajectory.
+   * @param results optimized values.
+   * @param interpolation spline type.
+   */
+  InterpolatedTrajectory(const Robot &robot, const Trajectory &trajectory,
+                         const gtsam::Values &results,
+                         Interpolation interpolation = Quintic);
+
+  /// Knot times, from the results of a trajectory optimization.
+  static std::vector<double> KnotTimes(const Trajectory &trajectory,
+                                       const gtsam::Values &results);
+
+  /// Start time.
+  double startTime() const { return times_.front(); }
+
+  /// End time.
+  double endTime() const { return times_.back(); }
+
+  /// Number of spline segments.
+  size_t numSegments() const { return times_.size() - 1; }
+
+  /// Whether link poses are interpolated.
+  bool hasPoses() const { return !poses_.empty(); }
+
+  /// Index of the segment containing time t, see the class documentation.
+  size_t segment(double t) const;
+
+  /// A sample sized for this trajectory, to be filled by sample(t, &sample).
+  TrajectorySample makeSample() const;
+
+  /// Sample at time t into a sample sized by makeSample(), without allocating.
+  void sample(double t, TrajectorySample *sample) const;
+
+  /// Sample at time t.
+  TrajectorySample sample(double t) const {
+    TrajectorySample result = makeSample();
+    sample(t, &result);
+    return result;
+  }
+
+  /// Input iterator over samples at a fixed rate, reusing a single sample.
+  class Iterator {
+   private:
+    const InterpolatedTrajectory *trajectory_;
+    double dt_;
+    size_t index_;
+    TrajectorySample sample_;
+
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = TrajectorySample;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TrajectorySample *;
+    using reference = const TrajectorySample &;
+
+    Iterator(const InterpolatedTrajectory *trajectory, double dt, size_t index)
+        : trajectory_(trajectory), dt_(dt), index_(index) {}
+
+    reference operator*() {
+      if (sample_.q.size() == 0) sample_ = trajectory_->makeSample();
+      trajectory_->sample(trajectory_->startTime() + index_ * dt_, &sample_);
+      return sample_;
+    }
+    pointer operator->() { return &**this; }
+    Iterator &operator++() {
+      ++index_;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+  };
+
+  /// Range of samples every dt, from the start to the end time.
+  class Stream {
+   private:
+    const InterpolatedTrajectory *trajectory_;
+    double dt_;
+    size_t size_;
+
+   public:
+    Stream(const InterpolatedTrajectory *trajectory, double dt)
+        : trajectory_(trajectory),
+          dt_(dt),
+          size_(static_cast<size_t>(
+                    (trajectory->endTime() - trajectory->startTime()) / dt +
+                    1e-6) +
+                1) {}
+    Iterator begin() const { return Iterator(trajectory_, dt_, 0); }
+    Iterator end() const { return Iterator(trajectory_, dt_, size_); }
+    size_t size() const { return size_; }
+  };
+
+  /**
+   * Stream samples at a fixed rate, e.g.
+   *   for (const auto &sample : trajectory.stream(1e-3)) send(sample);
+   * @param dt sampling period.
+   */
+  Stream stream(double dt) const { return Stream(this, dt); }
+};
+
+}  // namespace gtdynamics
@@ -0,0 +1,79 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  Parallel.h
+ * @brief Parallel loop over independent work items, using TBB when GTDynamics
+ * is built with it and std::thread otherwise.
+ */
+
+#pragma once
+
+#include <gtdynamics/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef GTDYNAMICS_USE_TBB
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#endif
+
+namespace gtdynamics {
+
+/**
+ * Call f(i) for i in [0, n), possibly concurrently. f must be safe to call
+ * from several threads at once. The first exception thrown by f is rethrown
+ * once all work has stopped.
+ * @param n number of work items.
+ * @param f function to call on each index.
+ * @param num_threads maximum number of threads, 0 for hardware concurrency,
+ * and 1 to run serially on the calling thread.
+ */
+template <typename FUNC>
+void ParallelFor(size_t n, const FUNC &f, size_t num_threads = 0) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, n);
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; i++) f(i);
+    return;
+  }
+
+#ifdef GTDYNAMICS_USE_TBB
+  tbb::task_arena arena(static_cast<int>(num_threads));
+  arena.execute(
+      [&]() { tbb::parallel_for(size_t(0), n, [&f](size_t i) { f(i); }); });
+#else
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+        next = n;  // stop handing out work
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t k = 1; k < num_threads; k++) threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+#endif
+}
+
+}  // namespace gtdynamics
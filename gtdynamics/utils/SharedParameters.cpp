@@ -0,0 +1,67 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SharedParameters.cpp
+ * @brief Immutable parameter blocks shared by the factors that use them.
+ */
+
+#include <gtdynamics/utils/SharedParameters.h>
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+namespace gtdynamics {
+
+namespace {
+/// Interned blocks, by key, and the size at which to drop expired ones.
+struct Pool {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::weak_ptr<const void>> blocks;
+  size_t prune_size = 64;
+
+  /// Drop expired blocks, and prune again when the pool has doubled.
+  void prune() {
+    for (auto it = blocks.begin(); it != blocks.end();) {
+      it = it->second.expired() ? blocks.erase(it) : std::next(it);
+    }
+    prune_size = std::max<size_t>(64, 2 * blocks.size());
+  }
+};
+
+Pool &GetPool() {
+  static Pool pool;
+  return pool;
+}
+}  // namespace
+
+/* ************************************************************************* */
+std::shared_ptr<const void> SharedParameters::Intern(
+    const std::string &key,
+    const std::function<std::shared_ptr<const void>()> &make) {
+  Pool &pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  std::weak_ptr<const void> &entry = pool.blocks[key];
+  if (auto block = entry.lock()) return block;
+  std::shared_ptr<const void> block = make();
+  entry = block;
+  if (pool.blocks.size() > pool.prune_size) pool.prune();
+  return block;
+}
+
+/* ************************************************************************* */
+size_t SharedParameters::Size() {
+  Pool &pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  size_t size = 0;
+  for (auto &&entry : pool.blocks) size += !entry.second.expired();
+  return size;
+}
+
+}  // namespace gtdynamics
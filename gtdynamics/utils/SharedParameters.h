@@ -0,0 +1,83 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SharedParameters.h
+ * @brief Immutable parameter blocks shared by the factors that use them.
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/base/OptionalJacobian.h>
+#include <gtsam/nonlinear/Expression.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace gtdynamics {
+
+/// Immutable parameter block, shared by all the factors that use it.
+template <typename T>
+using SharedParameter = std::shared_ptr<const T>;
+
+/**
+ * SharedParameters interns immutable parameter blocks, e.g., the inertia of a
+ * link or the constant Jacobian of a contact constraint, so that the factors
+ * of identical limbs, and of the same limb at every time step, refer to a
+ * single copy instead of each storing their own. Blocks are compared bit for
+ * bit, and freed once nothing refers to them. Safe to use from several
+ * threads at once, e.g., when building graphs in parallel.
+ */
+class SharedParameters {
+ private:
+  /// Block interned under key, made by make if there is none yet.
+  static std::shared_ptr<const void> Intern(
+      const std::string &key,
+      const std::function<std::shared_ptr<const void>()> &make);
+
+ public:
+  /// Shared copy of a fixed-size matrix.
+  template <int M, int N>
+  static SharedParameter<Eigen::Matrix<double, M, N>> Share(
+      const Eigen::Matrix<double, M, N> &block) {
+    using Block = Eigen::Matrix<double, M, N>;
+    std::string key = std::to_string(M) + "x" + std::to_string(N) + ":";
+    key.append(reinterpret_cast<const char *>(block.data()), sizeof(Block));
+    return std::static_pointer_cast<const Block>(Intern(key, [&block]() {
+      return std::allocate_shared<Block>(Eigen::aligned_allocator<Block>(),
+                                         block);
+    }));
+  }
+
+  /// Number of blocks currently shared.
+  static size_t Size();
+};
+
+/**
+ * @fn Linear expression A * x. Unlike gtsam::linearExpression, which stores
+ * A both in the function and as its Jacobian, A is a shared block.
+ * @param A constant matrix.
+ * @param x vector expression.
+ */
+template <int M, int N>
+gtsam::Expression<Eigen::Matrix<double, M, 1>> SharedLinearExpression(
+    const Eigen::Matrix<double, M, N> &A,
+    const gtsam::Expression<Eigen::Matrix<double, N, 1>> &x) {
+  const SharedParameter<Eigen::Matrix<double, M, N>> shared_A =
+      SharedParameters::Share(A);
+  return gtsam::Expression<Eigen::Matrix<double, M, 1>>(
+      [shared_A](const Eigen::Matrix<double, N, 1> &v,
+                 gtsam::OptionalJacobian<M, N> H_v) {
+        if (H_v) *H_v = *shared_A;
+        return Eigen::Matrix<double, M, 1>(*shared_A * v);
+      },
+      x);
+}
+
+}  // namespace gtdynamics
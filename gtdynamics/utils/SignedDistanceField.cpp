@@ -0,0 +1,141 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SignedDistanceField.cpp
+ * @brief Precomputed 3D signed distance field on a regular grid.
+ */
+
+#include <gtdynamics/utils/SignedDistanceField.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace gtdynamics {
+
+using gtsam::Point3;
+
+/* ************************************************************************* */
+SignedDistanceField::SignedDistanceField(const Point3 &origin,
+                                         double cell_size, size_t nx,
+                                         size_t ny, size_t nz,
+                                         const std::vector<double> &data)
+    : origin_(origin),
+      cell_size_(cell_size),
+      nx_(nx),
+      ny_(ny),
+      nz_(nz),
+      data_(data) {
+  if (nx < 2 || ny < 2 || nz < 2) {
+    throw std::invalid_argument(
+        "SignedDistanceField: need at least 2 vertices along each axis.");
+  }
+  if (cell_size <= 0) {
+    throw std::invalid_argument(
+        "SignedDistanceField: cell size must be positive.");
+  }
+  if (data.size() != nx * ny * nz) {
+    throw std::invalid_argument("SignedDistanceField: expected " +
+                                std::to_string(nx * ny * nz) +
+                                " values, got " + std::to_string(data.size()));
+  }
+}
+
+/* ************************************************************************* */
+SignedDistanceField SignedDistanceField::FromFunction(
+    const Point3 &origin, double cell_size, size_t nx, size_t ny, size_t nz,
+    const std::function<double(const Point3 &)> &distance) {
+  std::vector<double> data;
+  data.reserve(nx * ny * nz);
+  for (size_t l = 0; l < nz; l++) {
+    for (size_t j = 0; j < ny; j++) {
+      for (size_t i = 0; i < nx; i++) {
+        data.push_back(distance(origin + cell_size * Point3(i, j, l)));
+      }
+    }
+  }
+  return SignedDistanceField(origin, cell_size, nx, ny, nz, data);
+}
+
+/* ************************************************************************* */
+double SignedDistanceField::distance(const Point3 &point,
+                                     gtsam::OptionalJacobian<1, 3> H) const {
+  // Continuous grid coordinates, clamped to the grid, split into the lower
+  // vertex index and the fraction within the cell.
+  const Point3 g = (point - origin_) / cell_size_;
+  const size_t n[3] = {nx_, ny_, nz_};
+  size_t idx[3];
+  double t[3];
+  bool clamped[3];
+  for (int a = 0; a < 3; a++) {
+    const double max = n[a] - 1;
+    const double c = std::min(std::max(g[a], 0.0), max);
+    clamped[a] = (c != g[a]);
+    idx[a] = std::min(static_cast<size_t>(c), n[a] - 2);
+    t[a] = c - idx[a];
+  }
+
+  // Values at the 8 corners of the cell, v[dx][dy][dz].
+  double v[2][2][2];
+  for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+      for (int dx = 0; dx < 2; dx++)
+        v[dx][dy][dz] = at(idx[0] + dx, idx[1] + dy, idx[2] + dz);
+
+  // Interpolate along x, then y, then z.
+  double vx[2][2];
+  for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+      vx[dy][dz] = (1 - t[0]) * v[0][dy][dz] + t[0] * v[1][dy][dz];
+  const double vxy0 = (1 - t[1]) * vx[0][0] + t[1] * vx[1][0];
+  const double vxy1 = (1 - t[1]) * vx[0][1] + t[1] * vx[1][1];
+  const double d = (1 - t[2]) * vxy0 + t[2] * vxy1;
+
+  if (H) {
+    double dd_dt[3] = {0, 0, 0};
+    for (int dz = 0; dz < 2; dz++) {
+      const double wz = dz ? t[2] : 1 - t[2];
+      for (int dy = 0; dy < 2; dy++) {
+        const double wy = dy ? t[1] : 1 - t[1];
+        dd_dt[0] += wy * wz * (v[1][dy][dz] - v[0][dy][dz]);
+      }
+    }
+    for (int dz = 0; dz < 2; dz++) {
+      const double wz = dz ? t[2] : 1 - t[2];
+      dd_dt[1] += wz * (vx[1][dz] - vx[0][dz]);
+    }
+    dd_dt[2] = vxy1 - vxy0;
+    for (int a = 0; a < 3; a++) {
+      (*H)(0, a) = clamped[a] ? 0.0 : dd_dt[a] / cell_size_;
+    }
+  }
+  return d;
+}
+
+/* ************************************************************************* */
+void SignedDistanceField::print(const std::string &s) const {
+  std::cout << (s.empty() ? s : s + " ") << "SignedDistanceField " << nx_
+            << "x" << ny_ << "x" << nz_ << ", cell size " << cell_size_
+            << ", origin " << origin_.transpose() << std::endl;
+}
+
+/* ************************************************************************* */
+bool SignedDistanceField::equals(const SignedDistanceField &other,
+                                 double tol) const {
+  if (nx_ != other.nx_ || ny_ != other.ny_ || nz_ != other.nz_) return false;
+  if (std::abs(cell_size_ - other.cell_size_) > tol) return false;
+  if ((origin_ - other.origin_).norm() > tol) return false;
+  for (size_t i = 0; i < data_.size(); i++) {
+    if (std::abs(data_[i] - other.data_[i]) > tol) return false;
+  }
+  return true;
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,144 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  SignedDistanceField.h
+ * @brief Precomputed 3D signed distance field on a regular grid.
+ */
+
+#pragma once
+
+#include <gtsam/base/OptionalJacobian.h>
+#include <gtsam/geometry/Point3.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+#include <boost/serialization/vector.hpp>
+#endif
+
+namespace gtdynamics {
+
+/**
+ * SignedDistanceField stores the signed distance to the nearest obstacle
+ * surface at the vertices of a regular 3D grid, negative inside obstacles.
+ * Queries interpolate trilinearly between the 8 surrounding vertices, so they
+ * cost a handful of memory lookups, and have analytic gradients. Queries
+ * outside the grid are clamped to its boundary, with zero gradient along the
+ * clamped axes.
+ */
+class SignedDistanceField {
+ private:
+  gtsam::Point3 origin_;     // position of vertex (0, 0, 0)
+  double cell_size_ = 1.0;   // distance between neighboring vertices
+  size_t nx_ = 0, ny_ = 0, nz_ = 0;
+  std::vector<double> data_;  // x varies fastest, then y, then z
+
+ public:
+  /// Default constructor, for serialization.
+  SignedDistanceField() {}
+
+  /**
+   * Constructor.
+   * @param origin position of the first grid vertex.
+   * @param cell_size distance between neighboring vertices.
+   * @param nx, ny, nz number of vertices along each axis, at least 2.
+   * @param data signed distances, x varies fastest, then y, then z.
+   */
+  SignedDistanceField(const gtsam::Point3 &origin, double cell_size,
+                      size_t nx, size_t ny, size_t nz,
+                      const std::vector<double> &data);
+
+  /**
+   * @fn Sample a signed distance function at the grid vertices.
+   * @param origin position of the first grid vertex.
+   * @param cell_size distance between neighboring vertices.
+   * @param nx, ny, nz number of vertices along each axis, at least 2.
+   * @param distance signed distance function.
+   */
+  static SignedDistanceField FromFunction(
+      const gtsam::Point3 &origin, double cell_size, size_t nx, size_t ny,
+      size_t nz, const std::function<double(const gtsam::Point3 &)> &distance);
+
+  /**
+   * Signed distance at a point, by trilinear interpolation.
+   * @param point query point.
+   * @param H optional gradient of the distance w.r.t. the point.
+   */
+  double distance(const gtsam::Point3 &point,
+                  gtsam::OptionalJacobian<1, 3> H = {}) const;
+
+  /// Position of the first grid vertex.
+  const gtsam::Point3 &origin() const { return origin_; }
+
+  /// Distance between neighboring vertices.
+  double cellSize() const { return cell_size_; }
+
+  /// Number of vertices along x, y and z.
+  size_t nx() const { return nx_; }
+  size_t ny() const { return ny_; }
+  size_t nz() const { return nz_; }
+
+  /// Signed distance stored at vertex (i, j, l).
+  double at(size_t i, size_t j, size_t l) const {
+    return data_[(l * ny_ + j) * nx_ + i];
+  }
+
+  /// Print a short description.
+  void print(const std::string &s = "") const;
+
+  /// Check equality up to a tolerance.
+  bool equals(const SignedDistanceField &other, double tol = 1e-9) const;
+
+ private:
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &BOOST_SERIALIZATION_NVP(origin_);
+    ar &BOOST_SERIALIZATION_NVP(cell_size_);
+    ar &BOOST_SERIALIZATION_NVP(nx_);
+    ar &BOOST_SERIALIZATION_NVP(ny_);
+    ar &BOOST_SERIALIZATION_NVP(nz_);
+    ar &BOOST_SERIALIZATION_NVP(data_);
+  }
+#endif
+};
+
+using SignedDistanceFieldSharedPtr = std::shared_ptr<SignedDistanceField>;
+
+/// Default clearance from obstacles, and sigma of the obstacle cost models.
+constexpr double kObstacleEpsilon = 0.05;
+constexpr double kObstacleSigma = 0.01;
+
+/// Sphere rigidly attached to a link, with its center in the link CoM frame.
+struct LinkSphere {
+  gtsam::Point3 center;
+  double radius;
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+  /// Serialization function
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE &ar, const unsigned int version) {  // NOLINT
+    ar &BOOST_SERIALIZATION_NVP(center);
+    ar &BOOST_SERIALIZATION_NVP(radius);
+  }
+#endif
+};
+
+using LinkSpheres = std::vector<LinkSphere>;
+
+/// Sphere approximations of links, by link name.
+using RobotSpheres = std::map<std::string, LinkSpheres>;
+
+}  // namespace gtdynamics
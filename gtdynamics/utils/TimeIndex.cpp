@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TimeIndex.cpp
+ * @brief Index of trajectory keys by time step and variable type.
+ */
+
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/TimeIndex.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace gtdynamics {
+
+using gtsam::Key;
+using gtsam::KeyVector;
+using gtsam::Values;
+
+namespace {
+const KeyVector kNoKeys;
+}  // namespace
+
+/* ************************************************************************* */
+TimeIndex::TimeIndex(const KeyVector &keys,
+                     const std::set<std::string> &untimed_labels)
+    : untimed_labels_(untimed_labels) {
+  // Decode every key once, and find the range of time steps.
+  std::vector<DynamicsSymbol> symbols;
+  symbols.reserve(keys.size());
+  size_t k_min = std::numeric_limits<size_t>::max(), k_max = 0;
+  for (auto &&key : keys) {
+    symbols.emplace_back(key);
+    if (untimed_labels_.count(symbols.back().label())) continue;
+    k_min = std::min<size_t>(k_min, symbols.back().time());
+    k_max = std::max<size_t>(k_max, symbols.back().time());
+  }
+  if (k_min <= k_max) {
+    first_step_ = k_min;
+    steps_.resize(k_max - k_min + 1);
+  }
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    add(keys[i], symbols[i].label(), symbols[i].time());
+  }
+}
+
+/* ************************************************************************* */
+void TimeIndex::add(Key key, const std::string &label, size_t k) {
+  if (untimed_labels_.count(label)) {
+    untimed_.push_back(key);
+    return;
+  }
+  steps_[k - first_step_].push_back(key);
+  auto &labeled = labeled_steps_[label];
+  if (labeled.empty()) labeled.resize(steps_.size());
+  labeled[k - first_step_].push_back(key);
+}
+
+/* ************************************************************************* */
+const KeyVector &TimeIndex::keys(size_t k) const {
+  if (k < first_step_ || k - first_step_ >= steps_.size()) return kNoKeys;
+  return steps_[k - first_step_];
+}
+
+/* ************************************************************************* */
+const KeyVector &TimeIndex::keys(size_t k, const std::string &label) const {
+  auto it = labeled_steps_.find(label);
+  if (it == labeled_steps_.end()) return kNoKeys;
+  if (k < first_step_ || k - first_step_ >= steps_.size()) return kNoKeys;
+  return it->second[k - first_step_];
+}
+
+/* ************************************************************************* */
+std::vector<std::string> TimeIndex::labels() const {
+  std::vector<std::string> result;
+  for (auto &&it : labeled_steps_) result.push_back(it.first);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/* ************************************************************************* */
+Values TimeIndex::values(const Values &values, size_t k_start,
+                         size_t k_end) const {
+  Values result;
+  for (size_t k = k_start; k <= k_end; k++) {
+    for (auto &&key : keys(k)) {
+      result.insert(key, values.at(key));
+    }
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+Key TimeIndex::ShiftKey(Key key, int offset) {
+  const DynamicsSymbol symbol(key);
+  if (offset < 0 && symbol.time() < static_cast<uint64_t>(-offset)) {
+    throw std::invalid_argument("TimeIndex::ShiftKey: " + std::string(symbol) +
+                                " would be shifted before time step 0.");
+  }
+  return DynamicsSymbol::LinkJointSymbol(symbol.label(), symbol.linkIdx(),
+                                         symbol.jointIdx(),
+                                         symbol.time() + offset);
+}
+
+/* ************************************************************************* */
+std::map<Key, Key> TimeIndex::shiftMap(int offset) const {
+  std::map<Key, Key> result;
+  for (size_t i = 0; i < steps_.size(); i++) {
+    if (static_cast<int>(first_step_ + i) + offset < 0) continue;
+    for (auto &&key : steps_[i]) {
+      result.emplace(key, ShiftKey(key, offset));
+    }
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+Values TimeIndex::shift(const Values &values, int offset) const {
+  Values result;
+  for (auto &&[key, shifted] : shiftMap(offset)) {
+    result.insert(shifted, values.at(key));
+  }
+  for (auto &&key : untimed_) {
+    result.insert(key, values.at(key));
+  }
+  return result;
+}
+
+}  // namespace gtdynamics
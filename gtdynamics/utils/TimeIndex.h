@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  TimeIndex.h
+ * @brief Index of trajectory keys by time step and variable type.
+ */
+
+#pragma once
+
+#include <gtsam/inference/Key.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gtdynamics {
+
+/**
+ * TimeIndex partitions keys by time step, and within each step by variable
+ * type, i.e., DynamicsSymbol label. Every key is decoded once, at
+ * construction, after which the keys of a step are returned by reference in
+ * constant time, and those of a variable type at a step in constant expected
+ * time, from a hash table of the labels.
+ *
+ * Keys with a label in `untimed_labels`, by default the phase durations "dt"
+ * which are indexed by phase rather than time step, are kept apart and left
+ * unchanged by time shifts.
+ */
+class TimeIndex {
+ private:
+  std::set<std::string> untimed_labels_;
+  size_t first_step_ = 0;
+  std::vector<gtsam::KeyVector> steps_;  // keys of step first_step_ + i
+  std::unordered_map<std::string, std::vector<gtsam::KeyVector>>
+      labeled_steps_;
+  gtsam::KeyVector untimed_;
+
+  /// Add a key, given its decoded label and time step.
+  void add(gtsam::Key key, const std::string &label, size_t k);
+
+ public:
+  /**
+   * Construct from keys.
+   * @param keys keys encoded as DynamicsSymbol.
+   * @param untimed_labels labels of keys that are not indexed by time step.
+   */
+  explicit TimeIndex(const gtsam::KeyVector &keys,
+                     const std::set<std::string> &untimed_labels = {"dt"});
+
+  /**
+   * Construct from the keys of values.
+   * @param values values with keys encoded as DynamicsSymbol.
+   * @param untimed_labels labels of keys that are not indexed by time step.
+   */
+  explicit TimeIndex(const gtsam::Values &values,
+                     const std::set<std::string> &untimed_labels = {"dt"})
+      : TimeIndex(values.keys(), untimed_labels) {}
+
+  /// First time step with keys.
+  size_t firstStep() const { return first_step_; }
+
+  /// Last time step with keys, or firstStep() - 1 if there are none.
+  size_t lastStep() const { return first_step_ + steps_.size() - 1; }
+
+  /// Number of time steps from the first to the last.
+  size_t numSteps() const { return steps_.size(); }
+
+  /// Keys at time step k, empty if there are none.
+  const gtsam::KeyVector &keys(size_t k) const;
+
+  /// Keys with a given label, e.g., "q" for joint angles, at time step k.
+  const gtsam::KeyVector &keys(size_t k, const std::string &label) const;
+
+  /// Keys that are not indexed by time step.
+  const gtsam::KeyVector &untimedKeys() const { return untimed_; }
+
+  /// Labels of the timed keys, sorted.
+  std::vector<std::string> labels() const;
+
+  /**
+   * Values of the keys from time step k_start to k_end, included.
+   * @param values values to extract from, with the indexed keys.
+   */
+  gtsam::Values values(const gtsam::Values &values, size_t k_start,
+                       size_t k_end) const;
+
+  /// Values of the keys at time step k.
+  gtsam::Values values(const gtsam::Values &values, size_t k) const {
+    return this->values(values, k, k);
+  }
+
+  /// Key with the same label, link and joint, with its time step shifted.
+  static gtsam::Key ShiftKey(gtsam::Key key, int offset);
+
+  /**
+   * Map from every timed key to its key shifted by offset, e.g., to rekey a
+   * factor graph. Keys shifted before time step 0 are left out.
+   */
+  std::map<gtsam::Key, gtsam::Key> shiftMap(int offset) const;
+
+  /**
+   * Values with every timed key shifted by offset time steps. Steps shifted
+   * before time step 0 are dropped, and untimed values are copied as is. For
+   * a receding horizon warm start, shift by -1 and fill the last step.
+   * @param values values to shift, with the indexed keys.
+   * @param offset time step offset.
+   */
+  gtsam::Values shift(const gtsam::Values &values, int offset) const;
+};
+
+}  // namespace gtdynamics
@@ -0,0 +1,168 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  Tracer.cpp
+ * @brief Timeline tracer implementation.
+ */
+
+#include <gtdynamics/utils/Tracer.h>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace gtdynamics {
+
+/* ************************************************************************* */
+Tracer &Tracer::Instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+/* ************************************************************************* */
+uint32_t Tracer::ThreadId() {
+  static std::atomic<uint32_t> next_tid{0};
+  thread_local const uint32_t tid = next_tid++;
+  return tid;
+}
+
+/* ************************************************************************* */
+void Tracer::enable(size_t capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("Tracer::enable: capacity must be positive.");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer_.assign(capacity, TraceEvent{nullptr, 0.0, 0.0, 0});
+  next_ = 0;
+  size_ = 0;
+  num_dropped_ = 0;
+  epoch_.store(Clock::now().time_since_epoch().count(),
+               std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+/* ************************************************************************* */
+void Tracer::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  next_ = 0;
+  size_ = 0;
+  num_dropped_ = 0;
+}
+
+/* ************************************************************************* */
+void Tracer::record(const char *name, double start_us, double duration_us) {
+  if (!enabled()) return;
+  const uint32_t tid = ThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buffer_.empty()) return;
+  buffer_[next_] = TraceEvent{name, start_us, duration_us, tid};
+  next_ = (next_ + 1) % buffer_.size();
+  if (size_ < buffer_.size()) {
+    ++size_;
+  } else {
+    ++num_dropped_;
+  }
+}
+
+/* ************************************************************************* */
+void Tracer::setThreadName(const std::string &name) {
+  const uint32_t tid = ThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_names_.size() <= tid) thread_names_.resize(tid + 1);
+  thread_names_[tid] = name;
+}
+
+/* ************************************************************************* */
+std::vector<TraceEvent> Tracer::events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<TraceEvent> result;
+  if (buffer_.empty()) return result;
+  result.reserve(size_);
+  const size_t first = (next_ + buffer_.size() - size_) % buffer_.size();
+  for (size_t n = 0; n < size_; ++n) {
+    result.push_back(buffer_[(first + n) % buffer_.size()]);
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+size_t Tracer::numDropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_dropped_;
+}
+
+/* ************************************************************************* */
+// Write a string as a JSON string literal.
+static void WriteJsonString(std::ostream &os, const std::string &s) {
+  os << '"';
+  for (const char c : s) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        os << c;
+    }
+  }
+  os << '"';
+}
+
+/* ************************************************************************* */
+void Tracer::writeChromeTrace(std::ostream &os) const {
+  const std::vector<TraceEvent> spans = events();
+  std::vector<std::string> thread_names;
+  size_t num_dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_names = thread_names_;
+    num_dropped = num_dropped_;
+  }
+
+  // Complete ("X") events carry both begin and end, so the timeline stays
+  // well-formed even after the ring buffer wrapped around.
+  os << "{\"traceEvents\":[\n";
+  bool first = true;
+  for (uint32_t tid = 0; tid < thread_names.size(); ++tid) {
+    if (thread_names[tid].empty()) continue;
+    os << (first ? "" : ",\n")
+       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+       << ",\"args\":{\"name\":";
+    WriteJsonString(os, thread_names[tid]);
+    os << "}}";
+    first = false;
+  }
+  os << std::fixed << std::setprecision(3);
+  for (const TraceEvent &event : spans) {
+    os << (first ? "" : ",\n") << "{\"name\":";
+    WriteJsonString(os, event.name ? event.name : "");
+    os << ",\"cat\":\"gtdynamics\",\"ph\":\"X\",\"ts\":" << event.start_us
+       << ",\"dur\":" << event.duration_us << ",\"pid\":1,\"tid\":"
+       << event.tid << "}";
+    first = false;
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+     << num_dropped << "}}\n";
+}
+
+/* ************************************************************************* */
+void Tracer::writeChromeTrace(const std::string &file_path) const {
+  std::ofstream os(file_path);
+  if (!os) {
+    throw std::runtime_error("Tracer: cannot open " + file_path);
+  }
+  writeChromeTrace(os);
+}
+
+}  // namespace gtdynamics
@@ -0,0 +1,141 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  Tracer.h
+ * @brief Lightweight timeline tracer with Chrome trace-event JSON export.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gtdynamics {
+
+/// A single timed span, recorded when the span ends.
+struct TraceEvent {
+  const char *name;    ///< Static label, e.g. "LM_iterate".
+  double start_us;     ///< Start time in microseconds since Tracer::enable.
+  double duration_us;  ///< Duration in microseconds.
+  uint32_t tid;        ///< Small integer id of the recording thread.
+};
+
+/**
+ * Tracer records begin/end spans of the optimization pipeline into a bounded
+ * ring buffer, and writes them as Chrome trace-event JSON, which can be opened
+ * in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Tracing is off by default: a disabled tracer costs one atomic load per span.
+ * Once the buffer is full the oldest spans are overwritten, so memory stays
+ * bounded when tracing is left on for long runs.
+ *
+ * Usage:
+ *   Tracer::Instance().enable();
+ *   { TraceScope trace("my_span"); ... }
+ *   Tracer::Instance().writeChromeTrace("trace.json");
+ */
+class Tracer {
+ public:
+  /// Default number of spans kept in the ring buffer.
+  static constexpr size_t kDefaultCapacity = 1 << 16;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::vector<TraceEvent> buffer_;  // ring buffer, size == capacity
+  size_t next_ = 0;                 // next write position in buffer_
+  size_t size_ = 0;                 // number of valid events in buffer_
+  size_t num_dropped_ = 0;          // events overwritten since enable()
+  std::atomic<Clock::rep> epoch_;          // clock ticks at last enable()
+  std::vector<std::string> thread_names_;  // indexed by tid
+
+ public:
+  /// Process-wide tracer used by the instrumented GTDynamics code.
+  static Tracer &Instance();
+
+  /// Constructor, tracer starts disabled.
+  Tracer() : epoch_(Clock::now().time_since_epoch().count()) {}
+
+  /**
+   * Start recording, discarding previously recorded events.
+   * @param capacity maximum number of spans kept in memory.
+   */
+  void enable(size_t capacity = kDefaultCapacity);
+
+  /// Stop recording, keeping the events recorded so far.
+  void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+  /// Return true if spans are being recorded.
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /// Discard all recorded events.
+  void clear();
+
+  /// Microseconds elapsed since the last call to enable().
+  double now() const {
+    const Clock::duration elapsed =
+        Clock::now().time_since_epoch() -
+        Clock::duration(epoch_.load(std::memory_order_relaxed));
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+  }
+
+  /// Record a finished span. Thread-safe.
+  void record(const char *name, double start_us, double duration_us);
+
+  /// Give the calling thread a human-readable name in the trace.
+  void setThreadName(const std::string &name);
+
+  /// Small integer id of the calling thread, stable for the process lifetime.
+  static uint32_t ThreadId();
+
+  /// Return recorded events, oldest first.
+  std::vector<TraceEvent> events() const;
+
+  /// Number of events overwritten because the buffer was full.
+  size_t numDropped() const;
+
+  /// Write the recorded events as Chrome trace-event JSON.
+  void writeChromeTrace(std::ostream &os) const;
+
+  /// Write the recorded events as Chrome trace-event JSON to a file.
+  void writeChromeTrace(const std::string &file_path) const;
+};
+
+/**
+ * RAII span: records [construction, destruction) in Tracer::Instance() if
+ * tracing is enabled. The name must outlive the tracer, i.e., be a literal.
+ */
+class TraceScope {
+  const char *name_;
+  double start_us_;
+
+ public:
+  explicit TraceScope(const char *name)
+      : name_(name),
+        start_us_(Tracer::Instance().enabled() ? Tracer::Instance().now()
+                                               : -1.0) {}
+
+  ~TraceScope() {
+    if (start_us_ >= 0.0) {
+      Tracer &tracer = Tracer::Instance();
+      tracer.record(name_, start_us_, tracer.now() - start_us_);
+    }
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+};
+
+}  // namespace gtdynamics
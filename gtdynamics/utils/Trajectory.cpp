@@ -14,6 +14,7 @@
 
 #include <gtdynamics/factors/ObjectiveFactors.h>
 #include <gtdynamics/universal_robot/Robot.h>
+#include <gtdynamics/utils/Tracer.h>
 #include <gtdynamics/utils/Trajectory.h>
 #include <gtsam/geometry/Point3.h>
 
@@ -50,6 +51,7 @@ vector<NonlinearFactorGraph> Trajectory::getTransitionGraphs(
 NonlinearFactorGraph Trajectory::multiPhaseFactorGraph(
     const Robot &robot, const DynamicsGraph &graph_builder,
     const CollocationScheme collocation, double mu) const {
+  TraceScope trace("multiPhaseFactorGraph");
   // Graphs for transition between phases + their initial values.
   auto transition_graphs = getTransitionGraphs(robot, graph_builder, mu);
   return graph_builder.multiPhaseTrajectoryFG(robot, phaseDurations(),
@@ -14,11 +14,14 @@
 
 #pragma once
 
+#include <gtdynamics/optimizer/EqualityConstraint.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Vector.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/nonlinear/ExpressionFactor.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
 #include <gtsam/nonlinear/expressions.h>
 
 namespace gtdynamics {
@@ -74,6 +77,33 @@ Symbol x1_key('x', 1);
 Symbol x2_key('x', 2);
 Double_ x1(x1_key), x2(x2_key);
 
+/// Cost factors of the example.
+gtsam::NonlinearFactorGraph Cost() {
+  gtsam::NonlinearFactorGraph graph;
+  auto cost_noise = gtsam::noiseModel::Isotropic::Sigma(1, 1.0);
+  graph.add(gtsam::ExpressionFactor<double>(cost_noise, 0., x1 + exp(-x2)));
+  graph.add(gtsam::ExpressionFactor<double>(cost_noise, 0.,
+                                            pow(x1, 2.0) + 2.0 * x2 + 1.0));
+  return graph;
+}
+
+/// Equality constraint of the example, tight enough for InitValues() to be
+/// infeasible.
+EqualityConstraints Constraints() {
+  EqualityConstraints constraints;
+  auto g1 = x1 + pow(x1, 3) + x2 + pow(x2, 2);
+  constraints.emplace_shared<DoubleExpressionEquality>(g1, 0.1);
+  return constraints;
+}
+
+/// Infeasible initial values.
+gtsam::Values InitValues() {
+  gtsam::Values init_values;
+  init_values.insert(x1_key, -0.2);
+  init_values.insert(x2_key, -0.2);
+  return init_values;
+}
+
 }  // namespace constrained_example
 
 }  // namespace gtdynamics
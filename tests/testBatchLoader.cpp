@@ -0,0 +1,65 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testBatchLoader.cpp
+ * @brief Test parallel loading and validation of robot models.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/config.h>
+#include <gtdynamics/universal_robot/BatchLoader.h>
+#include <gtdynamics/universal_robot/Link.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+
+#include <sstream>
+
+using namespace gtdynamics;
+using gtsam::Pose3;
+
+TEST(ValidateRobot, valid) {
+  EXPECT_LONGS_EQUAL(0, ValidateRobot(CreateSerialChain(4)).size());
+  EXPECT_LONGS_EQUAL(0, ValidateRobot(CreateLeggedRobot(4)).size());
+}
+
+TEST(ValidateRobot, invalid) {
+  // Two disconnected links, one with a non-physical inertia.
+  auto l1 = std::make_shared<Link>(0, "l1", 1.0, gtsam::I_3x3, Pose3(),
+                                   Pose3());
+  gtsam::Matrix3 inertia = gtsam::Vector3(1, 1, 5).asDiagonal();
+  auto l2 = std::make_shared<Link>(1, "l2", 1.0, inertia, Pose3(), Pose3());
+  Robot robot({{"l1", l1}, {"l2", l2}}, {});
+
+  auto errors = ValidateRobot(robot);
+  EXPECT_LONGS_EQUAL(2, errors.size());
+  EXPECT(errors[0].find("not connected") != std::string::npos);
+  EXPECT(errors[1].find("triangle inequality") != std::string::npos);
+}
+
+TEST(LoadRobotsFromFiles, summary) {
+  std::vector<std::string> files{
+      kSdfPath + std::string("test/four_bar_linkage_pure.sdf"),
+      kUrdfPath + std::string("test/simple_urdf.urdf"),
+      kSdfPath + std::string("does_not_exist.sdf")};
+  ModelLoadSummary summary = LoadRobotsFromFiles(files, 2);
+
+  EXPECT_LONGS_EQUAL(3, summary.results.size());
+  EXPECT_LONGS_EQUAL(1, summary.numFailed());
+  EXPECT(summary.results[0].ok());
+  EXPECT(summary.results[1].ok());
+  EXPECT(!summary.results[2].robot);
+  EXPECT(summary.results[2].file_path == files[2]);
+
+  std::stringstream ss;
+  summary.print(ss);
+  EXPECT(ss.str().find("2/3 models valid") != std::string::npos);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
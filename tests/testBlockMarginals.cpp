@@ -0,0 +1,125 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testBlockMarginals.cpp
+ * @brief Test marginal covariances read from the root of a Bayes tree.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/BlockMarginals.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/Marginals.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+const int num_steps = 5;
+const auto prior_model = noiseModel::Isotropic::Sigma(6, 0.1);
+const auto odometry_model = noiseModel::Diagonal::Sigmas(
+    (Vector(6) << 0.01, 0.02, 0.03, 0.1, 0.2, 0.3).finished());
+const auto link_model = noiseModel::Isotropic::Sigma(6, 0.05);
+
+// Two links over time: odometry on link 0 and relative poses of link 1.
+NonlinearFactorGraph Graph() {
+  NonlinearFactorGraph graph;
+  graph.addPrior(PoseKey(0, 0), Pose3(), prior_model);
+  const Pose3 step(Rot3::Rz(0.1), Point3(0.1, 0, 0));
+  const Pose3 link(Rot3::Ry(0.2), Point3(0, 0, -0.3));
+  for (int k = 0; k <= num_steps; k++) {
+    graph.emplace_shared<BetweenFactor<Pose3>>(PoseKey(0, k), PoseKey(1, k),
+                                               link, link_model);
+    if (k > 0) {
+      graph.emplace_shared<BetweenFactor<Pose3>>(
+          PoseKey(0, k - 1), PoseKey(0, k), step, odometry_model);
+    }
+  }
+  return graph;
+}
+
+Values Solution(const NonlinearFactorGraph &graph) {
+  Values init;
+  for (int k = 0; k <= num_steps; k++) {
+    InsertPose(&init, 0, k, Pose3(Rot3(), Point3(0.1 * k, 0, 0)));
+    InsertPose(&init, 1, k, Pose3(Rot3(), Point3(0.1 * k, 0, -0.3)));
+  }
+  return LevenbergMarquardtOptimizer(graph, init).optimize();
+}
+}  // namespace example
+
+// Batch elimination agrees with gtsam::Marginals.
+TEST(BlockMarginals, Batch) {
+  const auto graph = example::Graph();
+  const Values solution = example::Solution(graph);
+  const Key key0 = PoseKey(0, example::num_steps),
+            key1 = PoseKey(1, example::num_steps);
+
+  const BlockMarginals block_marginals(graph, solution, {key0, key1});
+  const Marginals marginals(graph, solution);
+  EXPECT(assert_equal(marginals.marginalCovariance(key0),
+                      block_marginals.marginalCovariance(key0), 1e-9));
+  EXPECT(assert_equal(marginals.marginalCovariance(key1),
+                      block_marginals.marginalCovariance(key1), 1e-9));
+  EXPECT(assert_equal(
+      marginals.jointMarginalCovariance({key0, key1}).at(key0, key1),
+      block_marginals.jointCovariance(key0, key1), 1e-9));
+  EXPECT_LONGS_EQUAL(12, block_marginals.jointCovariance().rows());
+
+  CHECK_EXCEPTION(block_marginals.marginalCovariance(PoseKey(0, 0)),
+                  std::invalid_argument);
+}
+
+// Reusing the Bayes tree of iSAM2, with the latest poses kept at the root.
+TEST(BlockMarginals, ISAM2) {
+  const auto graph = example::Graph();
+  const Values solution = example::Solution(graph);
+  const Key key0 = PoseKey(0, example::num_steps),
+            key1 = PoseKey(1, example::num_steps);
+
+  ISAM2 isam;
+  ISAM2UpdateParams params;
+  params.constrainedKeys = FastMap<Key, int>{{key0, 1}, {key1, 1}};
+  isam.update(graph, solution, params);
+
+  const BlockMarginals block_marginals(isam, {key0, key1});
+  const Marginals marginals(graph, isam.calculateEstimate());
+  EXPECT(assert_equal(marginals.marginalCovariance(key1),
+                      block_marginals.marginalCovariance(key1), 1e-6));
+  EXPECT(assert_equal(
+      marginals.jointMarginalCovariance({key0, key1}).at(key0, key1),
+      block_marginals.jointCovariance(key0, key1), 1e-6));
+
+  // An older pose is not in the root, but still has a marginal covariance.
+  const Key old_key = PoseKey(1, 0);
+  const BlockMarginals old_marginals(isam, {key0, old_key});
+  EXPECT(assert_equal(marginals.marginalCovariance(old_key),
+                      old_marginals.marginalCovariance(old_key), 1e-6));
+  CHECK_EXCEPTION(old_marginals.jointCovariance(key0, old_key),
+                  std::invalid_argument);
+}
+
+// Outputs of an estimator: all link poses and the wrenches of feet in contact.
+TEST(BlockMarginals, EstimationOutputKeys) {
+  const Robot robot = CreateSerialChain(3);
+  const auto link = robot.links()[2];
+  const PointOnLinks contact_points{PointOnLink(link, Point3(0, 0, -1)),
+                                    PointOnLink(link, Point3(0, 0, 1))};
+  const KeyVector keys = EstimationOutputKeys(robot, 7, contact_points);
+  EXPECT_LONGS_EQUAL(4, keys.size());
+  EXPECT(PoseKey(0, 7) == keys[0]);
+  EXPECT(ContactWrenchKey(link->id(), 0, 7) == keys[3]);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
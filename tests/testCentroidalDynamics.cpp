@@ -0,0 +1,171 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testCentroidalDynamics.cpp
+ * @brief Test centroidal dynamics factors and graph builder.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/CentroidalDynamics.h>
+#include <gtdynamics/factors/CentroidalFactors.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/Trajectory.h>
+#include <gtdynamics/utils/WalkCycle.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/factorTesting.h>
+#include <gtsam/slam/PriorFactor.h>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace {
+auto kModel6 = noiseModel::Unit::Create(6);
+const Vector3 kGravity(0, 0, -9.81);
+
+/// Four-legged walker standing on its feet for `num_steps` steps.
+Trajectory StandingTrajectory(const Robot &robot, size_t num_steps) {
+  std::vector<LinkSharedPtr> feet;
+  for (size_t l = 0; l < 4; l++) {
+    feet.push_back(robot.link("leg" + std::to_string(l) + "_link2"));
+  }
+  const double L = RobotGeneratorParams().link_length;
+  auto stance =
+      std::make_shared<FootContactConstraintSpec>(feet, Point3(L / 2, 0, 0));
+  WalkCycle walk_cycle({stance}, {num_steps});
+  return Trajectory(walk_cycle, 1);
+}
+}  // namespace
+
+TEST(CentroidalModel, FromRobot) {
+  Robot robot = CreateLeggedRobot(4);
+  auto model = CentroidalModel::FromRobot(robot, "body");
+
+  double mass = 0;
+  for (auto &&link : robot.links()) mass += link->mass();
+  EXPECT_DOUBLES_EQUAL(mass, model.mass, 1e-9);
+
+  // Symmetric robot: CoM below the body center, inertia diagonal.
+  EXPECT(model.bMc.translation().z() < 0);
+  EXPECT_DOUBLES_EQUAL(0, model.bMc.translation().x(), 1e-9);
+  EXPECT(assert_equal(Matrix3(model.inertia.diagonal().asDiagonal()),
+                      model.inertia, 1e-9));
+  EXPECT(assert_equal(Point3(0, 0, -model.bMc.translation().z()),
+                      model.cMbase.translation(), 1e-9));
+}
+
+TEST(CentroidalMomentumFactor, Jacobians) {
+  KeyVector point_keys{ContactPointKey(1), ContactPointKey(2)};
+  KeyVector force_keys{ContactForceKey(1), ContactForceKey(2)};
+  CentroidalMomentumFactor factor(CentroidalMomentumKey(0),
+                                  CentroidalMomentumKey(1),
+                                  CentroidalPoseKey(0), point_keys, force_keys,
+                                  kModel6, 10.0, kGravity, 0.1);
+  EXPECT_LONGS_EQUAL(2, factor.numContacts());
+
+  Values values;
+  values.insert(CentroidalMomentumKey(0),
+                (Vector6() << 1, 2, 3, 4, 5, 6).finished());
+  values.insert(CentroidalMomentumKey(1),
+                (Vector6() << 0, 1, 0, 1, 0, 1).finished());
+  values.insert(CentroidalPoseKey(0),
+                Pose3(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(0.1, 0, 0.5)));
+  values.insert(point_keys[0], Point3(0.3, 0.2, 0));
+  values.insert(point_keys[1], Point3(-0.3, -0.2, 0));
+  values.insert(force_keys[0], Vector3(1, 2, 40));
+  values.insert(force_keys[1], Vector3(-1, 0, 50));
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-7, 1e-5);
+
+  // Static equilibrium: forces balance gravity, no net moment.
+  Values equilibrium;
+  equilibrium.insert(CentroidalMomentumKey(0), Vector6(Z_6x1));
+  equilibrium.insert(CentroidalMomentumKey(1), Vector6(Z_6x1));
+  equilibrium.insert(CentroidalPoseKey(0), Pose3(Rot3(), Point3(0, 0, 0.5)));
+  equilibrium.insert(point_keys[0], Point3(0.3, 0, 0));
+  equilibrium.insert(point_keys[1], Point3(-0.3, 0, 0));
+  equilibrium.insert(force_keys[0], Vector3(0, 0, 9.81 * 5));
+  equilibrium.insert(force_keys[1], Vector3(0, 0, 9.81 * 5));
+  EXPECT(assert_equal(Vector(Z_6x1), factor.unwhitenedError(equilibrium),
+                      1e-9));
+}
+
+TEST(CentroidalKinematicsFactor, Jacobians) {
+  Matrix3 inertia = Vector3(0.5, 1.0, 1.5).asDiagonal();
+  CentroidalKinematicsFactor factor(CentroidalPoseKey(0), CentroidalPoseKey(1),
+                                    CentroidalMomentumKey(0), kModel6, 10.0,
+                                    inertia, 0.1);
+  Values values;
+  values.insert(CentroidalPoseKey(0),
+                Pose3(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(0.1, 0, 0.5)));
+  values.insert(CentroidalPoseKey(1),
+                Pose3(Rot3::RzRyRx(0.2, 0.1, 0.3), Point3(0.2, 0, 0.4)));
+  values.insert(CentroidalMomentumKey(0),
+                (Vector6() << 0.3, -0.2, 0.1, 4, 5, 6).finished());
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-7, 1e-5);
+
+  // Pure translation at constant linear momentum.
+  Values motion;
+  motion.insert(CentroidalPoseKey(0), Pose3(Rot3(), Point3(0, 0, 0)));
+  motion.insert(CentroidalPoseKey(1), Pose3(Rot3(), Point3(0.1, 0, 0)));
+  motion.insert(CentroidalMomentumKey(0),
+                (Vector6() << 0, 0, 0, 10, 0, 0).finished());
+  EXPECT(assert_equal(Vector(Z_6x1), factor.unwhitenedError(motion), 1e-9));
+}
+
+TEST(ForceFrictionConeFactor, Jacobians) {
+  ForceFrictionConeFactor factor(ContactForceKey(1),
+                                 noiseModel::Unit::Create(2), 0.5, kGravity);
+  EXPECT(assert_equal(Vector2(0, 0), factor.evaluateError(Vector3(1, 1, 10))));
+  EXPECT(assert_equal(Vector2(0, 1), factor.evaluateError(Vector3(0, 0, -1))));
+
+  Values values;
+  values.insert(ContactForceKey(1), Vector3(3, 2, 1));
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-7, 1e-5);
+}
+
+TEST(CentroidalGraph, Standing) {
+  Robot robot = CreateLeggedRobot(4);
+  auto model = CentroidalModel::FromRobot(robot, "body");
+  CentroidalGraph graph_builder(model);
+
+  const size_t num_steps = 5;
+  Trajectory trajectory = StandingTrajectory(robot, num_steps);
+  EXPECT_LONGS_EQUAL(num_steps,
+                     CentroidalGraph::StepContactPoints(trajectory).size());
+
+  // Put the feet on the ground.
+  auto cp = trajectory.phaseContactPoints()[0][0];
+  const Pose3 wTc(Rot3(), Point3(0, 0, -model.nominalContactPoint(cp).z()));
+
+  NonlinearFactorGraph graph = graph_builder.trajectoryFG(trajectory);
+  graph.addPrior(CentroidalPoseKey(0), wTc,
+                 noiseModel::Isotropic::Sigma(6, 1e-3));
+  graph.addPrior<Vector6>(CentroidalMomentumKey(0), Z_6x1,
+                          noiseModel::Isotropic::Sigma(6, 1e-3));
+
+  Values init = graph_builder.initialValues(trajectory, wTc);
+  LevenbergMarquardtOptimizer optimizer(graph, init);
+  Values result = optimizer.optimize();
+
+  // The robot keeps standing: forces carry the weight, momentum stays zero.
+  Vector3 total_force = Z_3x1;
+  for (auto &&foot : trajectory.phaseContactPoints()[0]) {
+    total_force += result.at<Vector3>(ContactForceKey(foot.link->id(), 2));
+  }
+  EXPECT(assert_equal(Vector3(-model.mass * kGravity), total_force, 1e-2));
+  EXPECT(assert_equal(Vector6(Z_6x1),
+                      result.at<Vector6>(CentroidalMomentumKey(num_steps)),
+                      1e-2));
+  EXPECT(assert_equal(wTc, result.at<Pose3>(CentroidalPoseKey(num_steps)),
+                      1e-3));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
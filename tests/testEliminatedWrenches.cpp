@@ -0,0 +1,192 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testEliminatedWrenches.cpp
+ * @brief Test the dynamics formulation without joint wrench variables.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/dynamics/EliminatedWrenches.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/GaussNewtonOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <stdexcept>
+
+#include "wrenchHelpers.h"
+
+using namespace gtdynamics;
+using gtsam::assert_equal;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Values;
+using gtsam::Vector;
+using gtsam::Vector6;
+
+namespace example {
+/// Values without the joint wrenches.
+Values WithoutWrenches(const Values &values) {
+  Values result;
+  for (auto &&key : values.keys()) {
+    if (DynamicsSymbol(key).label() == "F") continue;
+    result.insert(key, values.at(key));
+  }
+  return result;
+}
+}  // namespace example
+
+// Forward dynamics of a free two-link robot, as in testDynamicsGraph.
+TEST(EliminatedWrenches, FD) {
+  auto robot = simple_urdf_eq_mass::getRobot();
+  const size_t t = 777;
+  OptimizerSetting opt;
+  opt.setEliminateWrenches();
+  DynamicsGraph graph_builder(opt, simple_urdf_eq_mass::gravity,
+                              simple_urdf_eq_mass::planar_axis);
+  auto graph = graph_builder.dynamicsFactorGraph(robot, t);
+  EXPECT(!wrench_helpers::HasWrenches(graph));
+
+  // Rest kinematics and unit torques.
+  Values known_values;
+  for (auto &&joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), t, 0.0);
+    InsertJointVel(&known_values, joint->id(), t, 0.0);
+    InsertTorque(&known_values, joint->id(), t, 1.0);
+  }
+  graph.add(graph_builder.forwardDynamicsPriors(robot, t, known_values));
+  for (auto link : robot.links()) {
+    graph.addPrior(PoseKey(link->id(), t), link->bMcom(),
+                   graph_builder.opt().bp_cost_model);
+    graph.addPrior<Vector6>(TwistKey(link->id(), t), gtsam::Z_6x1,
+                            graph_builder.opt().bv_cost_model);
+  }
+  Initializer initializer;
+  gtsam::GaussNewtonOptimizer optimizer(
+      graph, example::WithoutWrenches(initializer.ZeroValues(robot, t)));
+  Values result = optimizer.optimize();
+
+  Vector expected_qAccel = (Vector(1) << 4).finished();
+  EXPECT(assert_equal(expected_qAccel,
+                      DynamicsGraph::jointAccels(robot, result, t), 1e-3));
+}
+
+// The wrenches of all joints, built in one pass, match those built one by one,
+// and depend on the motion of the whole subtree outboard of each joint.
+TEST(EliminatedWrenches, ChildWrenches) {
+  const Robot robot = CreateBinaryTree(3);
+  const size_t k = 2;
+  const EliminatedWrenches eliminated(robot, gtsam::Vector3(0, 0, -9.8));
+
+  Values values;
+  for (auto &&link : robot.links()) {
+    const int i = link->id();
+    InsertPose(&values, i, k,
+               gtsam::Pose3(gtsam::Rot3::Rz(0.1 * i),
+                            gtsam::Point3(0.1 * i, -0.2, 0.3)));
+    InsertTwist(&values, i, k, Vector6::Constant(0.1 * i));
+    InsertTwistAccel(&values, i, k, Vector6::Constant(0.2 - 0.1 * i));
+  }
+  for (auto &&joint : robot.joints()) {
+    InsertJointAngle(&values, joint->id(), k, 0.1 * joint->id());
+  }
+
+  const auto wrenches = eliminated.childWrenches(k);
+  EXPECT_LONGS_EQUAL(robot.numJoints(), wrenches.size());
+  for (auto &&joint : robot.joints()) {
+    const auto &wrench = wrenches.at(joint->id());
+    EXPECT(assert_equal(eliminated.childWrench(joint, k).value(values),
+                        wrench.value(values), 1e-9));
+    for (auto &&other : joint->child()->joints()) {
+      if (other == joint) continue;
+      EXPECT(wrench.keys().count(TwistAccelKey(other->child()->id(), k)));
+    }
+  }
+}
+
+// The trajectory matches the formulation with wrench variables.
+TEST(EliminatedWrenches, Trajectory) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const int num_steps = 5;
+  const double dt = 0.1;
+  Values known_values;
+  for (auto &&joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), 0, 0.0);
+    InsertJointVel(&known_values, joint->id(), 0, 0.0);
+    for (int k = 0; k <= num_steps; k++) {
+      InsertTorque(&known_values, joint->id(), k, 1.0 + k);
+    }
+  }
+  Initializer initializer;
+  const Values init = initializer.ZeroValuesTrajectory(robot, num_steps);
+
+  DynamicsGraph explicit_builder(simple_urdf_eq_mass::gravity,
+                                 simple_urdf_eq_mass::planar_axis);
+  auto explicit_graph = explicit_builder.trajectoryFG(robot, num_steps, dt);
+  explicit_graph.add(
+      explicit_builder.trajectoryFDPriors(robot, num_steps, known_values));
+  const Values expected =
+      gtsam::LevenbergMarquardtOptimizer(explicit_graph, init).optimize();
+
+  OptimizerSetting opt;
+  opt.setEliminateWrenches();
+  DynamicsGraph graph_builder(opt, simple_urdf_eq_mass::gravity,
+                              simple_urdf_eq_mass::planar_axis);
+  auto graph = graph_builder.trajectoryFG(robot, num_steps, dt);
+  graph.add(graph_builder.trajectoryFDPriors(robot, num_steps, known_values));
+  EXPECT(!wrench_helpers::HasWrenches(graph));
+  EXPECT(graph.keys().size() < explicit_graph.keys().size());
+  const Values actual = gtsam::LevenbergMarquardtOptimizer(
+                            graph, example::WithoutWrenches(init))
+                            .optimize();
+
+  for (int k = 0; k <= num_steps; k++) {
+    EXPECT(assert_equal(DynamicsGraph::jointAccels(robot, expected, k),
+                        DynamicsGraph::jointAccels(robot, actual, k), 1e-4));
+    EXPECT(assert_equal(DynamicsGraph::jointAngles(robot, expected, k),
+                        DynamicsGraph::jointAngles(robot, actual, k), 1e-4));
+  }
+
+  // The eliminated wrenches are the optimized wrench variables.
+  const EliminatedWrenches eliminated(robot, simple_urdf_eq_mass::gravity);
+  EXPECT(eliminated.root() == robot.link("l1"));
+  const Values wrenches = eliminated.wrenches(actual, num_steps);
+  for (auto &&key : wrenches.keys()) {
+    EXPECT(assert_equal(expected.at<Vector6>(key), wrenches.at<Vector6>(key),
+                        1e-3));
+  }
+}
+
+// Closed kinematic chains keep their wrench variables: every link of the
+// four-bar is the child of a joint, so there is no root, fixed or not.
+TEST(EliminatedWrenches, ClosedChain) {
+  const gtsam::Vector3 gravity(0, 0, -9.8);
+  const Robot four_bar = four_bar_linkage_pure::getRobot();
+  CHECK_EXCEPTION(EliminatedWrenches(four_bar, gravity),
+                  std::invalid_argument);
+  const Robot fixed_four_bar =
+      four_bar_linkage_pure::getRobot().fixLink("l1");
+  CHECK_EXCEPTION(EliminatedWrenches(fixed_four_bar, gravity),
+                  std::invalid_argument);
+
+  // Nor does the formulation fall back on a null root.
+  OptimizerSetting opt;
+  opt.setEliminateWrenches();
+  const DynamicsGraph graph_builder(opt, gravity);
+  CHECK_EXCEPTION(graph_builder.dynamicsFactors(fixed_four_bar, 0, {}, {}),
+                  std::invalid_argument);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
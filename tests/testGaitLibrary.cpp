@@ -0,0 +1,144 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testGaitLibrary.cpp
+ * @brief Test gait library generation over walk cycle variants.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/GaitLibrary.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <cstdio>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+const Robot robot = CreateSerialChain(3);
+
+// Joint angles, velocities, accelerations and torques pulled to step.x() * k,
+// and a phase duration that depends on the contact sequence.
+GaitProblem Problem(const Trajectory &trajectory, const GaitVariant &variant) {
+  NonlinearFactorGraph graph;
+  Values init;
+  auto model = noiseModel::Isotropic::Sigma(1, 0.1);
+  const int K = trajectory.getEndTimeStep(trajectory.numPhases() - 1);
+  for (int k = 0; k <= K; k++) {
+    const double target = variant.step.x() * k;
+    for (auto &&joint : robot.joints()) {
+      const int j = joint->id();
+      graph.addPrior(JointAngleKey(j, k), target, model);
+      graph.addPrior(JointVelKey(j, k), target, model);
+      graph.addPrior(JointAccelKey(j, k), target, model);
+      graph.addPrior(TorqueKey(j, k), target, model);
+      InsertJointAngle(&init, j, k, 0.0);
+      InsertJointVel(&init, j, k, 0.0);
+      InsertJointAccel(&init, j, k, 0.0);
+      InsertTorque(&init, j, k, 0.0);
+    }
+  }
+  for (size_t p = 0; p < trajectory.numPhases(); p++) {
+    graph.addPrior(PhaseKey(p), 0.01 * (variant.contact_sequence + 1), model);
+    init.insert(PhaseKey(p), 0.0);
+  }
+  return {graph, init};
+}
+
+// 5 steps x 2 phase lengths x 2 contact sequences.
+GaitGrid Grid() {
+  const Point3 contact_in_com(0, 0, -1);
+  auto both = std::make_shared<FootContactConstraintSpec>(
+      std::vector<LinkSharedPtr>{robot.link("link1"), robot.link("link2")},
+      contact_in_com);
+  auto one = std::make_shared<FootContactConstraintSpec>(
+      std::vector<LinkSharedPtr>{robot.link("link2")}, contact_in_com);
+  GaitGrid grid;
+  for (int s = 1; s <= 5; s++) grid.steps.emplace_back(0.1 * s, 0, 0);
+  grid.phase_lengths = {{2, 3}, {3, 3}};
+  grid.contact_sequences = {{both, one}, {one, both}};
+  return grid;
+}
+}  // namespace example
+
+TEST(GaitGrid, Variants) {
+  const auto variants = example::Grid().variants();
+  EXPECT_LONGS_EQUAL(20, variants.size());
+  EXPECT(assert_equal(Point3(0.2, 0, 0), variants[1].step));
+  EXPECT(variants[5].phase_lengths == std::vector<size_t>({3, 3}));
+  EXPECT_LONGS_EQUAL(1, variants[10].contact_sequence);
+}
+
+// Every variant is solved; seeds at the center of each group are cold-started
+// and the others warm-started from their nearest solved neighbour.
+TEST(GaitLibrary, Generate) {
+  const GaitGrid grid = example::Grid();
+  GaitLibraryParams params;
+  params.num_threads = 4;
+  const GaitLibrary library(grid, example::Problem, params);
+  EXPECT_LONGS_EQUAL(20, library.size());
+
+  for (auto &&entry : library.entries()) {
+    EXPECT_DOUBLES_EQUAL(0.0, entry.stats.final_error, 1e-9);
+    const int K = entry.trajectory.getEndTimeStep(
+        entry.trajectory.numPhases() - 1);
+    EXPECT_DOUBLES_EQUAL(entry.variant.step.x() * K,
+                         JointAngle(entry.solution, 0, K), 1e-6);
+  }
+
+  const auto &entries = library.entries();
+  EXPECT_LONGS_EQUAL(-1, entries[2].stats.warm_start);
+  EXPECT_LONGS_EQUAL(2, entries[1].stats.warm_start);
+  EXPECT_LONGS_EQUAL(2, entries[3].stats.warm_start);
+  EXPECT_LONGS_EQUAL(1, entries[0].stats.warm_start);
+  EXPECT_LONGS_EQUAL(3, entries[4].stats.warm_start);
+  EXPECT_LONGS_EQUAL(-1, entries[7].stats.warm_start);
+
+  // Warm starts begin closer to the solution than cold starts.
+  const auto [graph, init] =
+      example::Problem(entries[3].trajectory, entries[3].variant);
+  EXPECT(entries[3].stats.initial_error < graph.error(init));
+
+  // The schedule does not depend on the number of threads.
+  params.num_threads = 1;
+  const GaitLibrary serial(grid, example::Problem, params);
+  for (size_t i = 0; i < serial.size(); i++) {
+    EXPECT_LONGS_EQUAL(entries[i].stats.warm_start,
+                       serial.entries()[i].stats.warm_start);
+  }
+}
+
+// Entries are read back from the library file through its index.
+TEST(GaitLibrary, WriteRead) {
+  GaitLibraryParams params;
+  params.num_threads = 2;
+  const GaitLibrary library(example::Grid(), example::Problem, params);
+  const std::string file_path = "testGaitLibrary.txt";
+  library.write(example::robot, file_path);
+
+  // Entry 7: step 0.3, phase lengths {3, 3}, first contact sequence.
+  const Matrix rows = GaitLibrary::ReadEntry(file_path, 7);
+  const Matrix expected =
+      library.entries()[7].trajectory.phase(1).jointMatrix(
+          example::robot, library.entries()[7].solution, 4, 0.01);
+  EXPECT_LONGS_EQUAL(6, rows.rows());
+  EXPECT_LONGS_EQUAL(4 * 2 + 1, rows.cols());
+  EXPECT(assert_equal(expected, Matrix(rows.bottomRows(3)), 1e-9));
+  EXPECT_DOUBLES_EQUAL(0.3, rows(1, 0), 1e-9);
+
+  CHECK_EXCEPTION(GaitLibrary::ReadEntry(file_path, 20),
+                  std::invalid_argument);
+  std::remove(file_path.c_str());
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,181 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testHeightmap.cpp
+ * @brief Test the heightmap and the contact factors on rough terrain.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/factors/ContactDynamicsFrictionConeFactor.h>
+#include <gtdynamics/factors/ContactHeightFactor.h>
+#include <gtdynamics/utils/Heightmap.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/base/numericalDerivative.h>
+#include <gtsam/base/serializationTestHelpers.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/factorTesting.h>
+
+#include <cmath>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+// Rolling hills, sampled on a 4m square with 10cm cells.
+const auto kHills = [](double x, double y) {
+  return 0.1 * std::sin(x) * std::cos(0.5 * y);
+};
+HeightmapSharedPtr Terrain(Heightmap::Interpolation interpolation) {
+  return std::make_shared<Heightmap>(Heightmap::FromFunction(
+      Point2(-2, -2), 0.1, 41, 41, kHills, interpolation));
+}
+}  // namespace example
+
+// Bilinear interpolation is exact on planes, with the plane normal.
+TEST(Heightmap, Plane) {
+  auto plane = [](double x, double y) { return 0.2 * x - 0.3 * y + 0.1; };
+  const Heightmap heightmap =
+      Heightmap::FromFunction(Point2(0, 0), 0.5, 4, 5, plane);
+  EXPECT_LONGS_EQUAL(4, heightmap.nx());
+  EXPECT_DOUBLES_EQUAL(plane(0.5, 1.5), heightmap.at(1, 3), 1e-12);
+
+  const Point3 p(0.73, 1.21, 0.5);
+  Matrix13 H;
+  EXPECT_DOUBLES_EQUAL(p.z() - plane(p.x(), p.y()),
+                       heightmap.heightAbove(p, H), 1e-12);
+  EXPECT(assert_equal(Matrix13(-0.2, 0.3, 1.0), H, 1e-12));
+  EXPECT(assert_equal(Vector3(Vector3(-0.2, 0.3, 1.0).normalized()),
+                      heightmap.normal(p), 1e-12));
+}
+
+// Heights, gradients and normals match numerical differentiation of the
+// interpolation, and bicubic is closer to the sampled function.
+TEST(Heightmap, Derivatives) {
+  const Point3 p(0.33, -0.47, 0.2);
+  double errors[2];
+  for (auto interpolation : {Heightmap::Bilinear, Heightmap::Bicubic}) {
+    const auto terrain = example::Terrain(interpolation);
+    auto height_above = [&](const Point3 &q) {
+      return terrain->heightAbove(q);
+    };
+    auto normal = [&](const Point3 &q) { return terrain->normal(q); };
+    Matrix13 H_height;
+    Matrix3 H_normal;
+    errors[interpolation] =
+        std::abs(terrain->heightAbove(p, H_height) -
+                 (p.z() - example::kHills(p.x(), p.y())));
+    terrain->normal(p, H_normal);
+    EXPECT(assert_equal(numericalDerivative11<double, Point3>(height_above, p),
+                        H_height, 1e-6));
+    EXPECT(assert_equal(numericalDerivative11<Vector3, Point3>(normal, p),
+                        H_normal, 1e-6));
+  }
+  EXPECT(errors[Heightmap::Bicubic] < errors[Heightmap::Bilinear]);
+  EXPECT(errors[Heightmap::Bilinear] < 1e-3);
+}
+
+// Queries outside the grid are clamped, with zero slope along the clamped
+// axes.
+TEST(Heightmap, Clamped) {
+  const auto terrain = example::Terrain(Heightmap::Bicubic);
+  Matrix12 H;
+  EXPECT_DOUBLES_EQUAL(terrain->height(Point2(2.0, 0.3)),
+                       terrain->height(Point2(5.0, 0.3), H), 1e-12);
+  EXPECT_DOUBLES_EQUAL(0.0, H(0, 0), 1e-12);
+}
+
+TEST(Heightmap, InvalidArguments) {
+  CHECK_EXCEPTION(Heightmap(Point2(0, 0), 0.1, 1, 2, std::vector<double>(2)),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(Heightmap(Point2(0, 0), 0.0, 2, 2, std::vector<double>(4)),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(Heightmap(Point2(0, 0), 0.1, 2, 2, std::vector<double>(3)),
+                  std::invalid_argument);
+}
+
+// The contact point settles on the terrain rather than on the z = 0 plane.
+TEST(ContactHeightFactor, Heightmap) {
+  const auto terrain = example::Terrain(Heightmap::Bicubic);
+  const Key pose_key = PoseKey(0, 0);
+  const Point3 comPc(0, 0, -1);
+  ContactHeightFactor factor(pose_key, noiseModel::Isotropic::Sigma(1, 1e-3),
+                             comPc, terrain);
+
+  Values values;
+  values.insert(pose_key, Pose3(Rot3::Ry(0.3), Point3(0.7, 0.4, 1.5)));
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-7, 1e-5);
+
+  NonlinearFactorGraph graph;
+  graph.add(factor);
+  const Values result = LevenbergMarquardtOptimizer(graph, values).optimize();
+  const Point3 contact = result.at<Pose3>(pose_key).transformFrom(comPc);
+  EXPECT_DOUBLES_EQUAL(terrain->height(contact.head<2>()), contact.z(), 1e-6);
+}
+
+// On a slope, the cone is around the terrain normal: a force along the normal
+// is inside, while a vertical force of the same magnitude may slip.
+TEST(ContactDynamicsFrictionConeFactor, Heightmap) {
+  auto slope = [](double x, double y) { return 0.5 * x; };
+  const auto terrain = std::make_shared<Heightmap>(
+      Heightmap::FromFunction(Point2(-2, -2), 0.5, 9, 9, slope));
+  const Key pose_key = PoseKey(0, 0), wrench_key = ContactWrenchKey(0, 0, 0);
+  const Point3 comPc(0, 0, -0.5);
+  ContactDynamicsFrictionConeFactor factor(
+      pose_key, wrench_key, noiseModel::Isotropic::Sigma(1, 1.0), 0.4,
+      terrain, comPc);
+
+  const Pose3 pose(Rot3(), Point3(0.3, 0.2, 0.65));
+  const Vector3 n = Vector3(-0.5, 0, 1).normalized();
+  Vector6 along_normal, vertical;
+  along_normal << 0, 0, 0, n;
+  vertical << 0, 0, 0, 0, 0, 1;
+  EXPECT(assert_equal(Vector1(0), factor.evaluateError(pose, along_normal)));
+  EXPECT(factor.evaluateError(pose, vertical)(0) > 0);
+
+  // Jacobians, including the change of normal with position, on hills.
+  ContactDynamicsFrictionConeFactor hills_factor(
+      pose_key, wrench_key, noiseModel::Isotropic::Sigma(1, 1.0), 0.4,
+      example::Terrain(Heightmap::Bicubic), comPc);
+  Values values;
+  values.insert(pose_key, Pose3(Rot3::Rz(0.2), Point3(0.7, 0.4, 0.6)));
+  values.insert(wrench_key, (Vector6() << 0, 0, 0, 1, 0.5, 2).finished());
+  EXPECT_CORRECT_FACTOR_JACOBIANS(hills_factor, values, 1e-7, 1e-5);
+}
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+
+// Declaration needed for serialization of the noise model.
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic,
+                        "gtsam_noiseModel_Isotropic")
+
+// The friction cone factor round-trips with and without its heightmap.
+TEST(ContactDynamicsFrictionConeFactor, Serialization) {
+  using namespace gtsam::serializationTestHelpers;
+  const Key pose_key = PoseKey(0, 0), wrench_key = ContactWrenchKey(0, 0, 0);
+  const auto model = noiseModel::Isotropic::Sigma(1, 1.0);
+  const ContactDynamicsFrictionConeFactor flat(pose_key, wrench_key, model,
+                                               0.4, Vector3(0, 0, -9.8));
+  EXPECT(equalsObj(flat));
+  EXPECT(equalsXML(flat));
+  EXPECT(equalsBinary(flat));
+
+  const ContactDynamicsFrictionConeFactor rough(
+      pose_key, wrench_key, model, 0.4, example::Terrain(Heightmap::Bicubic),
+      Point3(0, 0, -0.5));
+  EXPECT(!rough.equals(flat));
+  EXPECT(equalsObj(rough));
+  EXPECT(equalsXML(rough));
+  EXPECT(equalsBinary(rough));
+}
+#endif
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
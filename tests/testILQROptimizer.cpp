@@ -0,0 +1,135 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testILQROptimizer.cpp
+ * @brief Test the iLQR trajectory optimizer.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/factors/MinTorqueFactor.h>
+#include <gtdynamics/optimizer/ILQROptimizer.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <stdexcept>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+const int num_steps = 10;
+const double dt = 0.05;
+const DynamicsGraph graph_builder(simple_urdf_eq_mass::gravity,
+                                  simple_urdf_eq_mass::planar_axis);
+
+/// Swing the pendulum to 1 rad with small torques.
+NonlinearFactorGraph Cost(const Robot &robot) {
+  NonlinearFactorGraph cost;
+  const int j = robot.joints()[0]->id();
+  cost.addPrior(JointAngleKey(j, num_steps), 1.0,
+                noiseModel::Isotropic::Sigma(1, 1e-2));
+  cost.addPrior(JointVelKey(j, num_steps), 0.0,
+                noiseModel::Isotropic::Sigma(1, 1e-1));
+  for (int k = 0; k <= num_steps; k++) {
+    cost.emplace_shared<MinTorqueFactor>(TorqueKey(j, k),
+                                         noiseModel::Isotropic::Sigma(1, 10));
+  }
+  return cost;
+}
+}  // namespace example
+
+// The rollout is the forward dynamics trajectory with Euler collocation.
+TEST(ILQROptimizer, Rollout) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const int j = robot.joints()[0]->id();
+  Values known_values;
+  InsertJointAngle(&known_values, j, 0, 0.0);
+  InsertJointVel(&known_values, j, 0, 0.0);
+  for (int k = 0; k <= example::num_steps; k++) {
+    InsertTorque(&known_values, j, k, 1.0 + k);
+  }
+
+  auto graph = example::graph_builder.trajectoryFG(
+      robot, example::num_steps, example::dt, CollocationScheme::Euler);
+  graph.add(example::graph_builder.trajectoryFDPriors(
+      robot, example::num_steps, known_values));
+  Initializer initializer;
+  const Values expected =
+      LevenbergMarquardtOptimizer(
+          graph, initializer.ZeroValuesTrajectory(robot, example::num_steps))
+          .optimize();
+
+  ILQROptimizer optimizer(robot, example::graph_builder, example::num_steps,
+                          example::dt);
+  const Values actual = optimizer.rollout(known_values);
+  for (int k = 0; k <= example::num_steps; k++) {
+    EXPECT_DOUBLES_EQUAL(JointAngle(expected, j, k), JointAngle(actual, j, k),
+                         1e-4);
+    EXPECT_DOUBLES_EQUAL(JointAccel(expected, j, k), JointAccel(actual, j, k),
+                         1e-4);
+  }
+}
+
+// iLQR and LM on the trajectory graph find the same optimal trajectory.
+TEST(ILQROptimizer, Optimize) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const int j = robot.joints()[0]->id();
+  const auto cost = example::Cost(robot);
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, example::num_steps);
+
+  auto graph = example::graph_builder.trajectoryFG(
+      robot, example::num_steps, example::dt, CollocationScheme::Euler);
+  graph.add(cost);
+  graph.addPrior(JointAngleKey(j, 0), 0.0,
+                 noiseModel::Isotropic::Sigma(1, 1e-4));
+  graph.addPrior(JointVelKey(j, 0), 0.0, noiseModel::Isotropic::Sigma(1, 1e-4));
+  const Values expected = LevenbergMarquardtOptimizer(graph, init).optimize();
+
+  ILQROptimizer optimizer(robot, example::graph_builder, example::num_steps,
+                          example::dt);
+  ConstrainedOptResult intermediate;
+  const Values actual = optimizer.optimize(cost, {}, init, &intermediate);
+  EXPECT(!intermediate.intermediate_values.empty());
+  EXPECT(cost.error(actual) < cost.error(optimizer.rollout(init)));
+  for (int k = 0; k <= example::num_steps; k++) {
+    EXPECT_DOUBLES_EQUAL(JointAngle(expected, j, k), JointAngle(actual, j, k),
+                         1e-2);
+    EXPECT_DOUBLES_EQUAL(Torque(expected, j, k), Torque(actual, j, k), 1e-1);
+  }
+}
+
+// Costs coupling time steps, and floating-base robots, are not supported.
+TEST(ILQROptimizer, Unsupported) {
+  auto robot = simple_urdf_eq_mass::getRobot();
+  CHECK_EXCEPTION(ILQROptimizer(robot, example::graph_builder, 1, 0.1),
+                  std::invalid_argument);
+
+  robot = robot.fixLink("l1");
+  const int j = robot.joints()[0]->id();
+  ILQROptimizer optimizer(robot, example::graph_builder, 1, 0.1);
+  NonlinearFactorGraph cost;
+  cost.emplace_shared<BetweenFactor<double>>(
+      JointAngleKey(j, 0), JointAngleKey(j, 1), 0.0,
+      noiseModel::Isotropic::Sigma(1, 1.0));
+  Initializer initializer;
+  CHECK_EXCEPTION(
+      optimizer.optimize(cost, {}, initializer.ZeroValuesTrajectory(robot, 1)),
+      std::invalid_argument);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
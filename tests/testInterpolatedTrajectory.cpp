@@ -0,0 +1,177 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testInterpolatedTrajectory.cpp
+ * @brief Test trajectory interpolation and streaming.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/InterpolatedTrajectory.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <cmath>
+
+#include "walkCycleExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+auto robot = simple_urdf::getRobot();
+const int j = robot.joint("j1")->id();
+
+// Non-uniform knot times.
+const std::vector<double> times{0.0, 0.1, 0.25, 0.3, 0.5, 0.8};
+
+// Quintic and cubic joint angle profiles.
+double q5(double t) { return std::pow(t, 5) - 2 * t * t * t + t; }
+double v5(double t) { return 5 * std::pow(t, 4) - 6 * t * t + 1; }
+double a5(double t) { return 20 * t * t * t - 12 * t; }
+double q3(double t) { return t * t * t - t * t + 0.5; }
+double v3(double t) { return 3 * t * t - 2 * t; }
+
+// Link poses moving with constant twists.
+const Pose3 wT0(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(1, 2, 3));
+const Vector6 xi = (Vector6() << 0.3, -0.2, 0.5, 1.0, 0.0, -0.4).finished();
+Pose3 wTl(int i, double t) { return wT0 * Pose3::Expmap((i + 1) * t * xi); }
+}  // namespace example
+
+// A quintic spline reproduces a quintic profile, and link poses follow the
+// SE(3) geodesic.
+TEST(InterpolatedTrajectory, Quintic) {
+  using namespace example;
+  Values values;
+  for (size_t k = 0; k < times.size(); k++) {
+    InsertJointAngle(&values, j, k, q5(times[k]));
+    InsertJointVel(&values, j, k, v5(times[k]));
+    InsertJointAccel(&values, j, k, a5(times[k]));
+    for (auto &&link : robot.links()) {
+      InsertPose(&values, link->id(), k, wTl(link->id(), times[k]));
+    }
+  }
+
+  InterpolatedTrajectory trajectory(robot, values, times);
+  EXPECT_LONGS_EQUAL(5, trajectory.numSegments());
+  EXPECT(trajectory.hasPoses());
+
+  TrajectorySample sample = trajectory.makeSample();
+  for (double t : {0.0, 0.05, 0.1, 0.27, 0.42, 0.799, 0.8}) {
+    trajectory.sample(t, &sample);
+    EXPECT_DOUBLES_EQUAL(t, sample.t, 1e-12);
+    EXPECT_DOUBLES_EQUAL(q5(t), sample.q(j), 1e-9);
+    EXPECT_DOUBLES_EQUAL(v5(t), sample.v(j), 1e-8);
+    EXPECT_DOUBLES_EQUAL(a5(t), sample.a(j), 1e-7);
+    for (auto &&link : robot.links()) {
+      EXPECT(assert_equal(wTl(link->id(), t), sample.poses[link->id()], 1e-9));
+    }
+  }
+
+  // Times outside the trajectory are clamped.
+  EXPECT_DOUBLES_EQUAL(q5(0.8), trajectory.sample(2.0).q(j), 1e-9);
+  EXPECT_LONGS_EQUAL(0, trajectory.segment(-1.0));
+  EXPECT_LONGS_EQUAL(2, trajectory.segment(0.25));
+  EXPECT_LONGS_EQUAL(4, trajectory.segment(0.8));
+}
+
+// A cubic spline reproduces a cubic profile, with velocities estimated by
+// finite differences when missing.
+TEST(InterpolatedTrajectory, Cubic) {
+  using namespace example;
+  Values values;
+  for (size_t k = 0; k < times.size(); k++) {
+    InsertJointAngle(&values, j, k, q3(times[k]));
+    InsertJointVel(&values, j, k, v3(times[k]));
+  }
+  InterpolatedTrajectory trajectory(robot, values, times,
+                                    InterpolatedTrajectory::Cubic);
+  EXPECT(!trajectory.hasPoses());
+  for (double t : {0.02, 0.2, 0.61}) {
+    auto sample = trajectory.sample(t);
+    EXPECT_DOUBLES_EQUAL(q3(t), sample.q(j), 1e-9);
+    EXPECT_DOUBLES_EQUAL(v3(t), sample.v(j), 1e-8);
+    EXPECT_DOUBLES_EQUAL(6 * t - 2, sample.a(j), 1e-7);
+  }
+
+  Values angles;
+  for (size_t k = 0; k < times.size(); k++) {
+    InsertJointAngle(&angles, j, k, q3(times[k]));
+  }
+  InterpolatedTrajectory estimated(robot, angles, times,
+                                   InterpolatedTrajectory::Cubic);
+  for (size_t k = 0; k < times.size(); k++) {
+    EXPECT_DOUBLES_EQUAL(q3(times[k]), estimated.sample(times[k]).q(j), 1e-9);
+  }
+}
+
+// The lookup table has one bucket per segment, however uneven the knots are,
+// and still finds the segment of any time.
+TEST(InterpolatedTrajectory, UnevenKnots) {
+  using namespace example;
+  const std::vector<double> uneven{0.0, 1e-9, 2e-9, 0.5, 1e3};
+  Values values;
+  for (size_t k = 0; k < uneven.size(); k++) {
+    InsertJointAngle(&values, j, k, q3(uneven[k]));
+    InsertJointVel(&values, j, k, v3(uneven[k]));
+  }
+  InterpolatedTrajectory trajectory(robot, values, uneven,
+                                    InterpolatedTrajectory::Cubic);
+  EXPECT_LONGS_EQUAL(0, trajectory.segment(5e-10));
+  EXPECT_LONGS_EQUAL(1, trajectory.segment(1.5e-9));
+  EXPECT_LONGS_EQUAL(2, trajectory.segment(2e-9));
+  EXPECT_LONGS_EQUAL(2, trajectory.segment(0.25));
+  EXPECT_LONGS_EQUAL(3, trajectory.segment(0.5));
+  EXPECT_LONGS_EQUAL(3, trajectory.segment(700.0));
+  EXPECT_LONGS_EQUAL(3, trajectory.segment(2e3));
+  EXPECT_DOUBLES_EQUAL(q3(0.25), trajectory.sample(0.25).q(j), 1e-9);
+}
+
+// Streaming at a fixed rate covers the whole trajectory.
+TEST(InterpolatedTrajectory, Stream) {
+  using namespace example;
+  Values values;
+  for (size_t k = 0; k < times.size(); k++) {
+    InsertJointAngle(&values, j, k, q5(times[k]));
+  }
+  InterpolatedTrajectory trajectory(robot, values, times);
+
+  auto stream = trajectory.stream(1e-3);
+  EXPECT_LONGS_EQUAL(801, stream.size());
+  size_t count = 0;
+  double last = -1;
+  for (const auto &sample : stream) {
+    EXPECT(sample.t > last);
+    last = sample.t;
+    count++;
+  }
+  EXPECT_LONGS_EQUAL(801, count);
+  EXPECT_DOUBLES_EQUAL(0.8, last, 1e-9);
+}
+
+// Knot times follow the time step of each phase.
+TEST(InterpolatedTrajectory, KnotTimes) {
+  Trajectory trajectory(walk_cycle_example::walk_cycle, 2);
+  Values results;
+  for (size_t p = 0; p < trajectory.numPhases(); p++) {
+    results.insert(PhaseKey(p), p % 2 ? 0.2 : 0.1);
+  }
+  auto times = InterpolatedTrajectory::KnotTimes(trajectory, results);
+  EXPECT_LONGS_EQUAL(11, times.size());
+  EXPECT_DOUBLES_EQUAL(0.2, times[2], 1e-12);
+  EXPECT_DOUBLES_EQUAL(0.4, times[3], 1e-12);
+  EXPECT_DOUBLES_EQUAL(1.6, times.back(), 1e-12);
+
+  CHECK_EXCEPTION(InterpolatedTrajectory::KnotTimes(trajectory, Values()),
+                  std::invalid_argument);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,325 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testLegChains.cpp
+ * @brief Test the dynamics formulation with legs reduced to serial chains.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/dynamics/EliminatedWrenches.h>
+#include <gtdynamics/dynamics/LegChains.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/universal_robot/sdf.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/expressionTesting.h>
+
+#include <stdexcept>
+
+#include "wrenchHelpers.h"
+
+using namespace gtdynamics;
+using gtsam::assert_equal;
+using gtsam::Matrix;
+using gtsam::NonlinearFactorGraph;
+using gtsam::Point3;
+using gtsam::Pose3;
+using gtsam::Rot3;
+using gtsam::Values;
+using gtsam::Vector;
+using gtsam::Vector6;
+
+namespace example {
+/// Values of the keys of a graph only.
+Values Restrict(const Values &values, const NonlinearFactorGraph &graph) {
+  Values result;
+  for (auto &&key : graph.keys()) result.insert(key, values.at(key));
+  return result;
+}
+
+/// Trunk and joint motion of a walker at time step k.
+Values Motion(const Robot &robot, size_t k) {
+  Values values;
+  const auto trunk = robot.link("body");
+  InsertPose(&values, trunk->id(), k,
+             Pose3(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(0.1, 0.2, 0.5)));
+  InsertTwist(&values, trunk->id(), k,
+              (Vector6() << 0.1, -0.2, 0.3, 0.4, 0.1, -0.5).finished());
+  InsertTwistAccel(&values, trunk->id(), k,
+                   (Vector6() << -0.3, 0.2, 0.1, 0.2, -0.4, 1.0).finished());
+  for (auto &&joint : robot.joints()) {
+    const int j = joint->id();
+    InsertJointAngle(&values, j, k, 0.1 * (j % 3 + 1) * (j % 2 ? -1 : 1));
+    InsertJointVel(&values, j, k, 0.3 - 0.1 * (j % 4));
+    InsertJointAccel(&values, j, k, 0.5 - 0.2 * (j % 3));
+  }
+  return values;
+}
+
+/// Motion, with the poses, twists and twist accelerations of all links.
+Values Kinematics(const Robot &robot, size_t k) {
+  const Values motion = Motion(robot, k);
+  Values values = robot.forwardKinematics(motion, k, std::string("body"));
+  for (auto &&key : motion.keys()) {
+    if (!values.exists(key)) values.insert(key, motion.at(key));
+  }
+  for (auto &&leg : LegChains(robot).legs()) {
+    for (auto &&joint : leg.joints) {
+      InsertTwistAccel(&values, joint->child()->id(), k, gtsam::Z_6x1);
+      const Vector6 accel = joint->twistAccelConstraint(k).value(values);
+      values.update(TwistAccelKey(joint->child()->id(), k), accel);
+    }
+  }
+  return values;
+}
+}  // namespace example
+
+// The legs of the A1 are its four three-joint chains.
+TEST(LegChains, A1) {
+  const Robot robot =
+      CreateRobotFromFile(kUrdfPath + std::string("a1/a1.urdf"), "a1");
+  const LegChains chains(robot);
+  EXPECT(chains.trunk() == robot.link("trunk"));
+  EXPECT_LONGS_EQUAL(4, chains.legs().size());
+  for (auto &&leg : chains.legs()) {
+    EXPECT_LONGS_EQUAL(3, leg.joints.size());
+    EXPECT_LONGS_EQUAL(3, leg.chain.length());
+  }
+  EXPECT(chains.legs()[0].foot == robot.link("FL_lower"));
+  EXPECT(chains.legs()[3].foot == robot.link("RR_lower"));
+
+  // Only the trunk and the feet keep pose, twist and acceleration variables.
+  PointOnLinks contact_points;
+  for (auto &&leg : chains.legs()) {
+    contact_points.emplace_back(leg.foot, Point3(0, 0, -0.07));
+  }
+  OptimizerSetting opt;
+  opt.setReduceLegChains();
+  const auto graph = DynamicsGraph(opt, gtsam::Vector3(0, 0, -9.8))
+                         .dynamicsFactorGraph(robot, 0, contact_points, 1.0);
+  const auto full_graph = DynamicsGraph(gtsam::Vector3(0, 0, -9.8))
+                              .dynamicsFactorGraph(robot, 0, contact_points,
+                                                   1.0);
+  EXPECT(!wrench_helpers::HasWrenches(graph));
+  EXPECT(!graph.keys().exists(PoseKey(robot.link("FL_hip")->id(), 0)));
+  EXPECT_LONGS_EQUAL(3 * 5 + 4 * robot.numJoints() + 4, graph.keys().size());
+  EXPECT(graph.keys().size() < full_graph.keys().size());
+}
+
+// Legs must be serial chains, without contact above the feet.
+TEST(LegChains, InvalidRobots) {
+  const Robot tree = CreateBinaryTree(2);
+  CHECK_EXCEPTION(LegChains(tree, {}), std::invalid_argument);
+  const Robot walker = CreateLeggedRobot(4, 3);
+  const PointOnLinks knee{{walker.link("leg0_link1"), Point3(0, 0, 0)}};
+  CHECK_EXCEPTION(LegChains(walker, {}, knee), std::invalid_argument);
+  const Robot fixed_foot = CreateLeggedRobot(4, 3).fixLink("leg1_link2");
+  CHECK_EXCEPTION(LegChains(fixed_foot, {}), std::invalid_argument);
+  EXPECT_LONGS_EQUAL(1, LegChains(CreateSerialChain(4)).legs().size());
+
+  // A closed chain has no trunk, fixed or not.
+  const Robot four_bar = four_bar_linkage_pure::getRobot();
+  CHECK_EXCEPTION(LegChains(four_bar, {}), std::invalid_argument);
+  const Robot fixed_four_bar =
+      four_bar_linkage_pure::getRobot().fixLink("l1");
+  CHECK_EXCEPTION(LegChains(fixed_four_bar, {}), std::invalid_argument);
+  OptimizerSetting opt;
+  opt.setReduceLegChains();
+  const DynamicsGraph graph_builder(opt, gtsam::Vector3(0, 0, -9.8));
+  CHECK_EXCEPTION(graph_builder.qFactors(four_bar, 0), std::invalid_argument);
+  CHECK_EXCEPTION(graph_builder.dynamicsFactors(fixed_four_bar, 0),
+                  std::invalid_argument);
+}
+
+// Foot poses, twists and accelerations match the joint-by-joint kinematics,
+// and the foot pose the product of exponentials of the chain.
+TEST(LegChains, Kinematics) {
+  const Robot robot = CreateLeggedRobot(4, 3);
+  const size_t k = 3;
+  const Values motion = example::Motion(robot, k);
+  const LegChains chains(robot);
+  const auto trunk = chains.trunk();
+
+  // Joint-by-joint poses and twists, then twist accelerations.
+  const Values expected = example::Kinematics(robot, k);
+
+  for (auto &&leg : chains.legs()) {
+    const int i = leg.foot->id();
+    EXPECT(assert_equal(Pose(expected, i, k),
+                        chains.footPose(leg, k).value(motion), 1e-9));
+    EXPECT(assert_equal(Twist(expected, i, k),
+                        chains.footTwist(leg, k).value(motion), 1e-9));
+    EXPECT(assert_equal(TwistAccel(expected, i, k),
+                        chains.footTwistAccel(leg, k).value(motion), 1e-9));
+
+    Vector q(leg.joints.size());
+    for (size_t j = 0; j < leg.joints.size(); j++) {
+      q(j) = JointAngle(motion, leg.joints[j]->id(), k);
+    }
+    EXPECT(assert_equal(Pose(motion, trunk->id(), k) * leg.chain.poe(q),
+                        Pose(expected, i, k), 1e-9));
+  }
+
+  const auto &leg = chains.legs()[1];
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(chains.footPose(leg, k), motion, 1e-7,
+                                      1e-5);
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(chains.footTwistAccel(leg, k), motion,
+                                      1e-7, 1e-5);
+}
+
+// At rest and without gravity, the torques are tau = -J' F for the body
+// Jacobian J of the chain and the contact wrench F on the foot.
+TEST(LegChains, Torques) {
+  const Robot robot = CreateLeggedRobot(4, 3);
+  const size_t k = 0;
+  const auto foot = robot.link("leg2_link2");
+  const LegChains chains(robot, {}, PointOnLinks{{foot, Point3(0.15, 0, 0)}});
+  const auto &leg = chains.legs()[2];
+  EXPECT(leg.foot == foot);
+
+  Values values = example::Motion(robot, k);
+  const auto trunk = chains.trunk();
+  values.update(TwistKey(trunk->id(), k), Vector6(gtsam::Z_6x1));
+  values.update(TwistAccelKey(trunk->id(), k), Vector6(gtsam::Z_6x1));
+  for (auto &&joint : robot.joints()) {
+    values.update(JointVelKey(joint->id(), k), 0.0);
+    values.update(JointAccelKey(joint->id(), k), 0.0);
+  }
+  const Vector6 F = (Vector6() << 0.1, -0.3, 0.2, 1.0, 2.0, 30.0).finished();
+  values.insert(ContactWrenchKey(foot->id(), 0, k), F);
+
+  Vector q(leg.joints.size());
+  for (size_t j = 0; j < leg.joints.size(); j++) {
+    q(j) = JointAngle(values, leg.joints[j]->id(), k);
+  }
+  Matrix J;
+  leg.chain.poe(q, {}, J);
+
+  const auto wrenches = chains.childWrenches(leg, k);
+  for (size_t j = 0; j < leg.joints.size(); j++) {
+    const double torque = leg.joints[j]->cScrewAxis().dot(
+        wrenches[j].value(values));
+    EXPECT_DOUBLES_EQUAL(-J.col(j).dot(F), torque, 1e-9);
+  }
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(wrenches[0], values, 1e-7, 1e-5);
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(chains.trunkWrench(leg, k), values, 1e-7,
+                                      1e-5);
+
+  // Legs without contact transmit no wrench.
+  EXPECT(assert_equal(Vector6(gtsam::Z_6x1),
+                      chains.trunkWrench(chains.legs()[0], k).value(values)));
+}
+
+// The wrenches through the joints of a leg are those of exact inverse
+// dynamics, given by EliminatedWrenches on the link variables, including the
+// weight and inertia of the links of the leg.
+TEST(LegChains, ChildWrenches) {
+  const gtsam::Vector3 gravity(0, 0, -9.8);
+  const Robot robot = CreateLeggedRobot(4, 3);
+  const size_t k = 0;
+  const auto foot = robot.link("leg2_link2");
+  const PointOnLinks contact_points{{foot, Point3(0.15, 0, 0)}};
+  const LegChains chains(robot, gravity, contact_points);
+  const EliminatedWrenches eliminated(robot, gravity, contact_points);
+
+  const Vector6 F = (Vector6() << 0.1, -0.3, 0.2, 1.0, 2.0, 30.0).finished();
+  Values motion = example::Motion(robot, k);
+  motion.insert(ContactWrenchKey(foot->id(), 0, k), F);
+  Values values = example::Kinematics(robot, k);
+  values.insert(ContactWrenchKey(foot->id(), 0, k), F);
+
+  for (auto &&leg : chains.legs()) {
+    const auto wrenches = chains.childWrenches(leg, k);
+    for (size_t j = 0; j < leg.joints.size(); j++) {
+      const auto &joint = leg.joints[j];
+      EXPECT(assert_equal(eliminated.childWrench(joint, k).value(values),
+                          wrenches[j].value(motion), 1e-9));
+    }
+  }
+  const auto &leg = chains.legs()[2];
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(chains.childWrenches(leg, k)[1], motion,
+                                      1e-7, 1e-5);
+}
+
+// For a walker with links of 0.85 kg, at the default density, the reduced
+// formulation gives the trunk acceleration and joint torques of the one with
+// wrench variables.
+TEST(LegChains, MatchesWrenchVariables) {
+  const Robot robot = CreateLeggedRobot(4, 3);
+  const size_t k = 0;
+  const Values motion = example::Motion(robot, k);
+  const Values kinematics =
+      robot.forwardKinematics(motion, k, std::string("body"));
+  const auto trunk = robot.link("body");
+
+  // Vertical contact forces at the feet, without moment at the contacts.
+  PointOnLinks contact_points;
+  Values known_values = motion;
+  known_values.erase(TwistAccelKey(trunk->id(), k));
+  for (size_t l = 0; l < 4; l++) {
+    const auto foot = robot.link("leg" + std::to_string(l) + "_link2");
+    const Point3 point(0.15, 0, 0);
+    contact_points.emplace_back(foot, point);
+    const Pose3 wTfoot = Pose(kinematics, foot->id(), k);
+    const Point3 force =
+        wTfoot.rotation().unrotate(Point3(0.1 * l, -0.2, 20.0 + 5 * l));
+    Vector6 wrench;
+    wrench << point.cross(force), force;
+    known_values.insert(ContactWrenchKey(foot->id(), 0, k), wrench);
+  }
+
+  auto solve = [&](const DynamicsGraph &graph_builder) {
+    NonlinearFactorGraph graph;
+    graph.add(graph_builder.qFactors(robot, k));
+    graph.add(graph_builder.vFactors(robot, k));
+    graph.add(graph_builder.aFactors(robot, k));
+    graph.add(graph_builder.dynamicsFactors(robot, k, contact_points, 10.0));
+    auto model_1 = gtsam::noiseModel::Isotropic::Sigma(1, 1e-4),
+         model_6 = gtsam::noiseModel::Isotropic::Sigma(6, 1e-4);
+    for (auto &&key : known_values.keys()) {
+      if (known_values.at(key).dim() == 1) {
+        graph.addPrior(key, known_values.atDouble(key), model_1);
+      } else if (DynamicsSymbol(key).label() == "p") {
+        graph.addPrior(key, known_values.at<Pose3>(key), model_6);
+      } else {
+        graph.addPrior(key, known_values.at<Vector6>(key), model_6);
+      }
+    }
+    const Values init = example::Restrict(
+        Initializer().ZeroValues(robot, k, 0.0, contact_points), graph);
+    return std::make_pair(
+        graph.size(),
+        gtsam::LevenbergMarquardtOptimizer(graph, init).optimize());
+  };
+
+  const gtsam::Vector3 gravity(0, 0, -9.8);
+  const auto [full_size, expected] = solve(DynamicsGraph(gravity));
+  OptimizerSetting opt;
+  opt.setReduceLegChains();
+  const auto [size, actual] = solve(DynamicsGraph(opt, gravity));
+  EXPECT(size < full_size);
+  EXPECT(actual.size() < expected.size());
+
+  EXPECT(assert_equal(TwistAccel(expected, trunk->id(), k),
+                      TwistAccel(actual, trunk->id(), k), 1e-4));
+  EXPECT(assert_equal(DynamicsGraph::jointTorques(robot, expected, k),
+                      DynamicsGraph::jointTorques(robot, actual, k), 1e-4));
+  const auto foot = contact_points[2].link;
+  EXPECT(assert_equal(Pose(expected, foot->id(), k),
+                      Pose(actual, foot->id(), k), 1e-6));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
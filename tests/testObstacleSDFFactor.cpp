@@ -0,0 +1,199 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testObstacleSDFFactor.cpp
+ * @brief Test the signed distance field and the obstacle avoidance factor.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/factors/ObstacleSDFFactor.h>
+#include <gtdynamics/kinematics/Kinematics.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/Interval.h>
+#include <gtdynamics/utils/SignedDistanceField.h>
+#include <gtdynamics/utils/Slice.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/base/numericalDerivative.h>
+#include <gtsam/nonlinear/factorTesting.h>
+
+#include <utility>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+// Ball of radius 0.5 at (1, 1, 1), sampled on a 3m cube with 5cm cells.
+const Point3 kCenter(1, 1, 1);
+const auto kBall = [](const Point3 &p) { return (p - kCenter).norm() - 0.5; };
+const auto kSdf = std::make_shared<SignedDistanceField>(
+    SignedDistanceField::FromFunction(Point3(-0.5, -0.5, -0.5), 0.05, 61, 61,
+                                      61, kBall));
+}  // namespace example
+
+// Trilinear interpolation is exact on linear fields.
+TEST(SignedDistanceField, Linear) {
+  const Vector3 n(0.2, -0.3, 0.4);
+  auto plane = [&](const Point3 &p) { return n.dot(p) - 0.1; };
+  auto sdf = SignedDistanceField::FromFunction(Point3(0, 0, 0), 0.5, 4, 5, 6,
+                                               plane);
+  EXPECT_LONGS_EQUAL(4, sdf.nx());
+  EXPECT_DOUBLES_EQUAL(plane(Point3(0.5, 1.0, 1.5)), sdf.at(1, 2, 3), 1e-12);
+
+  const Point3 p(0.73, 1.21, 0.37);
+  Matrix13 H;
+  EXPECT_DOUBLES_EQUAL(plane(p), sdf.distance(p, H), 1e-12);
+  EXPECT(assert_equal(Matrix13(n.transpose()), H, 1e-12));
+}
+
+// The gradient matches numerical differentiation of the interpolation.
+TEST(SignedDistanceField, Gradient) {
+  auto f = [](const Point3 &p) { return example::kSdf->distance(p); };
+  for (auto &&p : {Point3(1.61, 0.93, 1.07), Point3(0.42, 0.66, 1.38)}) {
+    Matrix13 H;
+    const double d = example::kSdf->distance(p, H);
+    EXPECT_DOUBLES_EQUAL(example::kBall(p), d, 1e-2);
+    Matrix13 expected = numericalDerivative11<double, Point3>(f, p, 1e-6);
+    EXPECT(assert_equal(expected, H, 1e-6));
+  }
+}
+
+// Queries outside the grid are clamped, with zero gradient along the clamped
+// axes.
+TEST(SignedDistanceField, Clamped) {
+  const Point3 inside(2.5, 1.0, 1.0), outside(4.0, 1.0, 1.0);
+  Matrix13 H;
+  EXPECT_DOUBLES_EQUAL(example::kSdf->distance(inside),
+                       example::kSdf->distance(outside, H), 1e-12);
+  EXPECT_DOUBLES_EQUAL(0.0, H(0, 0), 1e-12);
+}
+
+TEST(SignedDistanceField, InvalidArguments) {
+  CHECK_EXCEPTION(SignedDistanceField(Point3(0, 0, 0), 0.1, 1, 2, 2,
+                                      std::vector<double>(4)),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(SignedDistanceField(Point3(0, 0, 0), 0.0, 2, 2, 2,
+                                      std::vector<double>(8)),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(SignedDistanceField(Point3(0, 0, 0), 0.1, 2, 2, 2,
+                                      std::vector<double>(7)),
+                  std::invalid_argument);
+}
+
+// Spheres near the obstacle are penalized, far ones are not.
+TEST(ObstacleSDFFactor, Error) {
+  const LinkSpheres spheres{{Point3(0, 0, 0), 0.1}, {Point3(1, 0, 0), 0.1}};
+  const double epsilon = 0.2;
+  ObstacleSDFFactor factor(PoseKey(0, 0),
+                           noiseModel::Isotropic::Sigma(2, 0.01),
+                           example::kSdf, spheres, epsilon);
+
+  // First sphere 0.1 from the surface, second one well clear.
+  const Pose3 wTl(Rot3(), Point3(1, 1, 1.6));
+  const Vector error = factor.evaluateError(wTl);
+  EXPECT_DOUBLES_EQUAL(0.2, error(0), 1e-2);
+  EXPECT_DOUBLES_EQUAL(0.0, error(1), 1e-12);
+
+  // Far away from the obstacle, the factor is inactive.
+  EXPECT(assert_equal(Vector2::Zero(),
+                      factor.evaluateError(Pose3(Rot3(), Point3(0, 0, 0))),
+                      1e-12));
+}
+
+TEST(ObstacleSDFFactor, Jacobians) {
+  const LinkSpheres spheres{{Point3(0, 0, 0), 0.1}, {Point3(0.2, 0, 0), 0.1}};
+  ObstacleSDFFactor factor(PoseKey(0, 0),
+                           noiseModel::Isotropic::Sigma(2, 0.01),
+                           example::kSdf, spheres, 0.2);
+  Values values;
+  InsertPose(&values, 0, 0,
+             Pose3(Rot3::RzRyRx(0.3, -0.2, 0.7), Point3(1.13, 0.87, 1.58)));
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-7, 1e-4);
+}
+
+// One sphere at the CoM, and spheres_per_segment along the way to each joint.
+TEST(ObstacleSDFFactor, LinkSphereApproximation) {
+  auto robot = simple_urdf::getRobot();
+  auto l1 = robot.link("l1");
+  LinkSpheres spheres = LinkSphereApproximation(l1, 0.05, 3);
+  EXPECT_LONGS_EQUAL(4, spheres.size());
+
+  // The last sphere is at the joint origin.
+  const Pose3 comTj = robot.joint("j1")->jMp().inverse();
+  EXPECT(assert_equal(comTj.translation(), spheres.back().center, 1e-9));
+}
+
+// One factor per link with spheres, at every time step.
+TEST(ObstacleSDFFactor, Graphs) {
+  auto robot = simple_urdf::getRobot();
+  RobotSpheres spheres;
+  for (auto &&link : robot.links()) {
+    spheres[link->name()] = LinkSphereApproximation(link, 0.05);
+  }
+
+  auto dynamics_graph =
+      DynamicsGraph().obstacleFactors(robot, 3, example::kSdf, spheres);
+  EXPECT_LONGS_EQUAL(2, dynamics_graph.size());
+  EXPECT(dynamics_graph.keys().exists(PoseKey(robot.link("l2")->id(), 3)));
+
+  Kinematics kinematics;
+  auto slice_graph = kinematics.obstacleObjectives(Slice(3), robot,
+                                                   example::kSdf, spheres);
+  EXPECT_LONGS_EQUAL(2, slice_graph.size());
+  auto interval_graph = kinematics.obstacleObjectives(Interval(0, 4), robot,
+                                                      example::kSdf, spheres);
+  EXPECT_LONGS_EQUAL(10, interval_graph.size());
+
+  // Trajectory graphs have them at every step, once obstacles are set.
+  const int num_steps = 4;
+  auto sizes = [&](const OptimizerSetting &opt) {
+    const DynamicsGraph graph_builder(opt);
+    const auto transition = graph_builder.dynamicsFactorGraph(robot, 2);
+    return std::make_pair(
+        graph_builder.trajectoryFG(robot, num_steps, 0.1).size(),
+        graph_builder.multiPhaseTrajectoryFG(robot, {2, 2}, {transition})
+            .size());
+  };
+  OptimizerSetting opt;
+  const auto without = sizes(opt);
+  opt.setObstacles(example::kSdf, spheres);
+  const auto with = sizes(opt);
+  EXPECT_LONGS_EQUAL(without.first + 2 * (num_steps + 1), with.first);
+  EXPECT_LONGS_EQUAL(without.second + 2 * (num_steps + 1), with.second);
+}
+
+// Inverse kinematics moves a link out of an obstacle placed on it.
+TEST(ObstacleSDFFactor, InverseKinematics) {
+  auto robot = simple_urdf::getRobot();
+  auto l2 = robot.link("l2");
+  const Point3 center = l2->bMcom().translation() + Point3(0.1, 0, 0);
+  auto ball = [&](const Point3 &p) { return (p - center).norm() - 0.2; };
+  const auto sdf = std::make_shared<SignedDistanceField>(
+      SignedDistanceField::FromFunction(center - Point3(1.5, 1.5, 1.5), 0.05,
+                                        61, 61, 61, ball));
+  const RobotSpheres spheres{{"l2", LinkSphereApproximation(l2, 0.05)}};
+
+  const Slice slice(0);
+  const Values unaware = Kinematics().inverse(slice, robot, {});
+  KinematicsParameters parameters;
+  parameters.obstacle_sdf = sdf;
+  parameters.obstacle_spheres = spheres;
+  Kinematics kinematics(parameters);
+  const Values avoiding = kinematics.inverse(slice, robot, {});
+
+  const auto obstacles =
+      kinematics.obstacleObjectives(slice, robot, sdf, spheres);
+  EXPECT(obstacles.error(unaware) > 0.0);
+  EXPECT(obstacles.error(avoiding) < obstacles.error(unaware));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,99 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testOptimizeAsync.cpp
+ * @brief Test asynchronous optimization, cancellation and progress reports.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/OptimizeAsync.h>
+#include <gtdynamics/optimizer/PenaltyMethodOptimizer.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <vector>
+
+#include "constrainedExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+// Asynchronous and synchronous optimization agree, with one progress report
+// per outer iteration.
+TEST(OptimizeAsync, Progress) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto init_values = constrained_example::InitValues();
+
+  PenaltyMethodParameters params;
+  const Values expected =
+      PenaltyMethodOptimizer(params).optimize(graph, constraints, init_values);
+
+  std::vector<SolveProgress> reports;
+  params.progress_callback = [&reports](const SolveProgress &progress) {
+    reports.push_back(progress);
+  };
+  auto optimizer = std::make_shared<PenaltyMethodOptimizer>(params);
+  auto result = std::make_shared<ConstrainedOptResult>();
+  auto future =
+      OptimizeAsync(optimizer, graph, constraints, init_values, result);
+  const Values actual = future.get();
+  EXPECT(assert_equal(expected, actual, 1e-9));
+  EXPECT(result->termination_reason == TerminationReason::MAX_ITERATIONS);
+
+  EXPECT_LONGS_EQUAL(params.num_iterations, reports.size());
+  for (size_t i = 0; i < reports.size(); i++) {
+    EXPECT_LONGS_EQUAL(i + 1, reports[i].iteration);
+    EXPECT_DOUBLES_EQUAL(graph.error(result->intermediate_values[i]),
+                         reports[i].cost, 1e-9);
+    if (i > 0) EXPECT(reports[i].elapsed_time >= reports[i - 1].elapsed_time);
+  }
+  EXPECT(reports.back().constraint_violation <=
+         reports.front().constraint_violation);
+}
+
+// A cancelled solve stops before its next iteration, with its best iterate.
+TEST(OptimizeAsync, Cancel) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto init_values = constrained_example::InitValues();
+
+  CancellationToken token;
+  token.cancel();
+  PenaltyMethodParameters params;
+  params.cancellation_token = token;
+  auto result = std::make_shared<ConstrainedOptResult>();
+  const Values initial =
+      OptimizeAsync(std::make_shared<PenaltyMethodOptimizer>(params), graph,
+                    constraints, init_values, result)
+          .get();
+  EXPECT(assert_equal(init_values, initial));
+  EXPECT(result->termination_reason == TerminationReason::CANCELLED);
+
+  // Cancel from the progress report of the first outer iteration.
+  CancellationToken first_token;
+  params.cancellation_token = first_token;
+  params.progress_callback = [first_token](const SolveProgress &) {
+    first_token.cancel();
+  };
+  result = std::make_shared<ConstrainedOptResult>();
+  const Values first =
+      OptimizeAsync(std::make_shared<PenaltyMethodOptimizer>(params), graph,
+                    constraints, init_values, result)
+          .get();
+  EXPECT_LONGS_EQUAL(1, result->intermediate_values.size());
+  EXPECT(result->termination_reason == TerminationReason::CANCELLED);
+  BestIterate best;
+  best.update(graph, constraints, init_values);
+  best.update(graph, constraints, result->intermediate_values.front());
+  EXPECT(assert_equal(best.values(), first));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
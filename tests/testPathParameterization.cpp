@@ -0,0 +1,110 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testPathParameterization.cpp
+ * @brief Test time-optimal path parameterization.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/PathParameterization.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace {
+/// Two-joint arm hanging off a fixed first link.
+Robot Arm(const RobotGeneratorParams &params) {
+  return CreateSerialChain(3, params).fixLink("link0");
+}
+
+/// Straight path in joint space, from zero to the goal.
+std::vector<Vector> StraightPath(const Vector &goal, size_t num_points) {
+  std::vector<Vector> path;
+  for (size_t k = 0; k < num_points; k++) {
+    path.push_back(goal * double(k) / (num_points - 1));
+  }
+  return path;
+}
+}  // namespace
+
+// Without gravity and with stiff actuators, the path is velocity limited.
+TEST(PathParameterization, VelocityLimited) {
+  RobotGeneratorParams robot_params;
+  robot_params.velocity_limit = 2.0;
+  robot_params.torque_limit = 1e4;
+  const Robot robot = Arm(robot_params);
+
+  PathParameterizationParams params;
+  params.gravity = Vector3::Zero();
+  const Vector goal = Vector2(1.0, -0.5);
+  PathParameterization topp(robot, StraightPath(goal, 101), params);
+  auto result = topp.compute();
+
+  EXPECT_LONGS_EQUAL(101, result.t.size());
+  EXPECT_DOUBLES_EQUAL(0.0, result.sd.front(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(0.0, result.sd.back(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(1.0 / 2.0, result.duration(), 2e-2);
+}
+
+// The time-optimal timing saturates, but respects, the torque limits.
+TEST(PathParameterization, TorqueLimited) {
+  RobotGeneratorParams robot_params;
+  robot_params.torque_limit = 5.0;
+  const Robot robot = Arm(robot_params);
+
+  const size_t num_points = 201;
+  const Vector goal = Vector2(1.5, -1.0);
+  PathParameterization topp(robot, StraightPath(goal, num_points));
+  auto result = topp.compute();
+  Values values = topp.values(result);
+
+  double max_torque = 0;
+  for (size_t k = 0; k < num_points; k++) {
+    for (auto &&joint : robot.joints()) {
+      const int j = joint->id();
+      EXPECT(std::abs(JointVel(values, j, k)) <= 10.0 + 1e-6);
+      max_torque = std::max(max_torque, std::abs(Torque(values, j, k)));
+    }
+  }
+  EXPECT(max_torque <= 5.0 + 1e-6);
+  EXPECT(max_torque > 0.95 * 5.0);
+
+  // Time stamps are consistent with the path velocities.
+  for (size_t k = 0; k + 1 < num_points; k++) {
+    const double ds = result.s[k + 1] - result.s[k];
+    EXPECT_DOUBLES_EQUAL(2 * ds / (result.sd[k] + result.sd[k + 1]),
+                         result.t[k + 1] - result.t[k], 1e-9);
+  }
+
+  // Arriving with a non-zero velocity is faster.
+  topp.setBoundaryVelocities(0.0, 1.0);
+  EXPECT(topp.compute().duration() < result.duration());
+}
+
+// Actuators too weak to hold the arm against gravity.
+TEST(PathParameterization, Infeasible) {
+  RobotGeneratorParams robot_params;
+  robot_params.torque_limit = 0.1;
+  PathParameterization topp(Arm(robot_params),
+                            StraightPath(Vector2(0.5, 0.5), 21));
+  CHECK_EXCEPTION(topp.compute(), std::runtime_error);
+  CHECK_EXCEPTION(PathParameterization(Arm(robot_params),
+                                       StraightPath(Vector2(0.5, 0.5), 2)),
+                  std::invalid_argument);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,134 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testProblemCapture.cpp
+ * @brief Test capture and replay of optimization problems.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/ProblemCapture.h>
+#include <gtdynamics/universal_robot/RevoluteJoint.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+
+#include <cstdio>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/// Two joint angles with a prior cost and a between constraint.
+ProblemCapture SimpleCapture() {
+  Robot robot = simple_rr::getRobot();
+  Key q0 = JointAngleKey(0, 0), q1 = JointAngleKey(1, 0);
+
+  NonlinearFactorGraph costs;
+  costs.emplace_shared<PriorFactor<double>>(q0, 1.0,
+                                            noiseModel::Isotropic::Sigma(1, 1));
+  EqualityConstraints constraints;
+  auto factor = std::make_shared<BetweenFactor<double>>(
+      q0, q1, 0.5, noiseModel::Isotropic::Sigma(1, 1));
+  constraints.emplace_shared<FactorZeroErrorConstraint>(factor, Vector1(1e-3));
+
+  Values init;
+  init.insert(q0, 0.0);
+  init.insert(q1, 0.0);
+
+  OptimizationParameters params;
+  params.method = OptimizationParameters::Method::AUGMENTED_LAGRANGIAN;
+  return ProblemCapture(robot, costs, constraints, init, params);
+}
+
+TEST(ProblemCapture, constructor) {
+  ProblemCapture capture = SimpleCapture();
+  EXPECT_LONGS_EQUAL(1, capture.costs.size());
+  EXPECT_LONGS_EQUAL(1, capture.constraint_factors.size());
+  EXPECT(assert_equal(Vector1(1e-3), capture.constraint_tolerances.at(0)));
+  EXPECT_LONGS_EQUAL(1, capture.constraints().dim());
+
+  Values result = capture.solve();
+  EXPECT_DOUBLES_EQUAL(1.0, result.atDouble(JointAngleKey(0, 0)), 1e-3);
+  EXPECT_DOUBLES_EQUAL(1.5, result.atDouble(JointAngleKey(1, 0)), 1e-3);
+}
+
+TEST(ProblemCapture, expressionConstraint) {
+  EqualityConstraints constraints;
+  Double_ q(JointAngleKey(0, 0));
+  constraints.emplace_shared<DoubleExpressionEquality>(q, 1.0);
+  THROWS_EXCEPTION(ProblemCapture(Robot(), NonlinearFactorGraph(),
+                                  constraints, Values()));
+}
+
+#ifdef GTDYNAMICS_ENABLE_BOOST_SERIALIZATION
+
+// Declaration needed for serialization of derived classes.
+BOOST_CLASS_EXPORT(gtdynamics::RevoluteJoint)
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic,
+                        "gtsam_noiseModel_Isotropic")
+BOOST_CLASS_EXPORT_GUID(gtsam::PriorFactor<double>, "gtsam_PriorFactorDouble")
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<double>,
+                        "gtsam_BetweenFactorDouble")
+GTSAM_VALUE_EXPORT(double)
+
+/// Save a capture to a file and load it back.
+ProblemCapture SaveLoad(const ProblemCapture &capture) {
+  const std::string file_path = "testProblemCapture.bin";
+  capture.save(file_path);
+  ProblemCapture loaded = ProblemCapture::Load(file_path);
+  std::remove(file_path.c_str());
+  return loaded;
+}
+
+TEST(ProblemCapture, saveLoad) {
+  ProblemCapture capture = SimpleCapture();
+  LevenbergMarquardtParams &lm = capture.parameters.lm_parameters;
+  lm.setLinearSolverType("MULTIFRONTAL_QR");
+  lm.ordering = Ordering{JointAngleKey(1, 0), JointAngleKey(0, 0)};
+  capture.parameters.ordering_type = OrderingType::TIME;
+  capture.parameters.pcg_parameters = TrajectoryPCGParams();
+  capture.parameters.pcg_parameters->max_iterations = 50;
+  capture.parameters.time_budget = 10.0;
+  const ProblemCapture loaded = SaveLoad(capture);
+
+  EXPECT(capture.robot.equals(loaded.robot));
+  EXPECT(assert_equal(capture.costs, loaded.costs));
+  EXPECT(assert_equal(capture.constraint_factors, loaded.constraint_factors));
+  EXPECT(assert_equal(capture.initial_values, loaded.initial_values));
+  EXPECT(loaded.parameters.method == capture.parameters.method);
+  const LevenbergMarquardtParams &loaded_lm = loaded.parameters.lm_parameters;
+  EXPECT_DOUBLES_EQUAL(lm.lambdaInitial, loaded_lm.lambdaInitial, 1e-9);
+  EXPECT(loaded_lm.linearSolverType == lm.linearSolverType);
+  EXPECT(loaded_lm.ordering &&
+         assert_equal(*lm.ordering, *loaded_lm.ordering));
+  EXPECT(loaded.parameters.ordering_type == OrderingType::TIME);
+  EXPECT(!loaded.parameters.condense);
+  EXPECT(loaded.parameters.pcg_parameters);
+  EXPECT_LONGS_EQUAL(50, loaded.parameters.pcg_parameters->max_iterations);
+  EXPECT(loaded.parameters.time_budget);
+  EXPECT_DOUBLES_EQUAL(10.0, *loaded.parameters.time_budget, 1e-9);
+
+  // Replaying gives the same solution.
+  EXPECT(assert_equal(capture.solve(), loaded.solve(), 1e-6));
+
+  // Condensed solves, exclusive with PCG ones.
+  capture.parameters.pcg_parameters.reset();
+  capture.parameters.condense = true;
+  capture.parameters.time_budget.reset();
+  const ProblemCapture condensed = SaveLoad(capture);
+  EXPECT(condensed.parameters.condense);
+  EXPECT(!condensed.parameters.pcg_parameters);
+  EXPECT(!condensed.parameters.time_budget);
+}
+#endif
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
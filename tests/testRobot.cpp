@@ -86,6 +86,19 @@ TEST(Robot, removeLink) {
   EXPECT(robot.link("l3")->joints().size() == 1);
 }
 
+TEST(Robot, treeRoot) {
+  EXPECT(assert_equal("link_0", simple_rr::getRobot().treeRoot()->name()));
+
+  // Every link of the four-bar is the child of a joint, fixed or not.
+  auto four_bar = four_bar_linkage_pure::getRobot();
+  CHECK_EXCEPTION(four_bar.treeRoot(), std::invalid_argument);
+  CHECK_EXCEPTION(four_bar.fixLink("l1").treeRoot(), std::invalid_argument);
+
+  // Cutting the loop leaves a chain from l1.
+  four_bar.removeJoint(four_bar.joint("j4"));
+  EXPECT(assert_equal("l1", four_bar.treeRoot()->name()));
+}
+
 TEST(Robot, ForwardKinematics) {
   Robot robot =
       CreateRobotFromFile(kUrdfPath + std::string("test/simple_urdf.urdf"));
@@ -282,6 +295,77 @@ TEST(ForwardKinematics, A1) {
       Pose(fk_results, 20, 0), 1e-6));
 }
 
+TEST(Robot, Jacobian) {
+  Robot robot =
+      CreateRobotFromFile(kUrdfPath + std::string("a1/a1.urdf"), "", true);
+  robot = robot.fixLink("trunk");
+  const std::string root = "trunk";
+  const std::vector<std::string> feet = {"FR_lower", "FL_lower", "RR_lower",
+                                         "RL_lower"};
+
+  // Arbitrary joint angles and velocities, indexed by joint id.
+  const size_t n = robot.numJoints();
+  gtsam::Vector q_dot(n);
+  Values values;
+  for (auto&& joint : robot.joints()) {
+    const int j = joint->id();
+    InsertJointAngle(&values, j, 0, 0.1 * j - 0.5);
+    q_dot(j) = 0.3 - 0.05 * j;
+    InsertJointVel(&values, j, 0, q_dot(j));
+  }
+  Values fk_results = robot.forwardKinematics(values, 0, root);
+
+  // Batch version agrees with single links.
+  std::vector<gtsam::Matrix> J, J_dot;
+  robot.jacobians(feet, values, &J, &J_dot, 0, root);
+  EXPECT_LONGS_EQUAL(4, J.size());
+  EXPECT_LONGS_EQUAL(4, J_dot.size());
+
+  const double h = 1e-6;
+  for (size_t e = 0; e < feet.size(); e++) {
+    EXPECT(assert_equal(robot.jacobian(feet[e], values, 0, root), J[e]));
+    EXPECT(
+        assert_equal(robot.jacobianDot(feet[e], values, 0, root), J_dot[e]));
+
+    // The Jacobian maps joint velocities to the link twist.
+    const int i = robot.link(feet[e])->id();
+    EXPECT(assert_equal(Twist(fk_results, i), gtsam::Vector6(J[e] * q_dot),
+                        1e-9));
+
+    // Its time derivative matches central differences along q_dot.
+    Values plus, minus;
+    for (auto&& joint : robot.joints()) {
+      const int j = joint->id();
+      InsertJointAngle(&plus, j, 0, JointAngle(values, j) + h * q_dot(j));
+      InsertJointAngle(&minus, j, 0, JointAngle(values, j) - h * q_dot(j));
+    }
+    const gtsam::Matrix numerical =
+        (robot.jacobian(feet[e], plus, 0, root) -
+         robot.jacobian(feet[e], minus, 0, root)) /
+        (2 * h);
+    EXPECT(assert_equal(numerical, J_dot[e], 1e-5));
+  }
+
+  // Outputs are reused when they have the right size.
+  const double* data = J[0].data();
+  robot.jacobians(feet, values, &J, nullptr, 0, root);
+  EXPECT(data == J[0].data());
+
+  // So is the workspace, whose spanning tree is built once per root link.
+  JacobianWorkspace workspace;
+  std::vector<gtsam::Matrix> J_reused;
+  robot.jacobians(feet, values, &J_reused, nullptr, 0, root, &workspace);
+  EXPECT(assert_equal(J[1], J_reused[1]));
+  EXPECT_LONGS_EQUAL(robot.numLinks(), workspace.links.size());
+  const gtsam::Pose3* poses = workspace.rTl.data();
+  robot.jacobians(feet, values, &J_reused, nullptr, 0, root, &workspace);
+  EXPECT(poses == workspace.rTl.data());
+  EXPECT(assert_equal(robot.jacobian(feet[2], values, 0, root, &workspace),
+                      J[2]));
+  EXPECT(assert_equal(robot.jacobianDot(feet[2], values, 0, root, &workspace),
+                      J_dot[2]));
+}
+
 TEST(Robot, Equality) {
   Robot robot1 = CreateRobotFromFile(
       kSdfPath + std::string("test/four_bar_linkage_pure.sdf"));
@@ -0,0 +1,85 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testRobotGenerator.cpp
+ * @brief Test programmatic robot generation.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+
+using namespace gtdynamics;
+using gtsam::assert_equal;
+using gtsam::Point3;
+using gtsam::Pose3;
+using gtsam::Rot3;
+
+TEST(RobotGenerator, SerialChain) {
+  RobotGeneratorParams params;
+  Robot robot = CreateSerialChain(5, params);
+  EXPECT_LONGS_EQUAL(5, robot.numLinks());
+  EXPECT_LONGS_EQUAL(4, robot.numJoints());
+
+  // Cylinder mass and inertia.
+  auto link = robot.link("link3");
+  const double r = params.link_radius, L = params.link_length;
+  const double mass = params.density * M_PI * r * r * L;
+  EXPECT_DOUBLES_EQUAL(mass, link->mass(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(0.5 * mass * r * r, link->inertia()(0, 0), 1e-9);
+  EXPECT(assert_equal(Pose3(Rot3(), Point3(3.5 * L, 0, 0)), link->bMcom()));
+
+  // Joint limits are set from the parameters.
+  auto joint = robot.joint("joint2");
+  EXPECT_DOUBLES_EQUAL(params.joint_limit,
+                       joint->parameters().scalar_limits.value_upper_limit,
+                       1e-9);
+
+  // Forward kinematics at rest reproduces the rest poses.
+  gtsam::Values values;
+  auto base = robot.link("link0");
+  InsertPose(&values, base->id(), base->bMcom());
+  InsertTwist(&values, base->id(), gtsam::Z_6x1);
+  for (auto&& j : robot.joints()) {
+    InsertJointAngle(&values, j->id(), 0.0);
+    InsertJointVel(&values, j->id(), 0.0);
+  }
+  gtsam::Values fk = robot.forwardKinematics(values, 0, std::string("link0"));
+  EXPECT(assert_equal(link->bMcom(), Pose(fk, link->id()), 1e-9));
+}
+
+TEST(RobotGenerator, BinaryTree) {
+  Robot robot = CreateBinaryTree(3);
+  EXPECT_LONGS_EQUAL(15, robot.numLinks());
+  EXPECT_LONGS_EQUAL(14, robot.numJoints());
+  EXPECT_LONGS_EQUAL(2, robot.link("link0")->joints().size());
+
+  THROWS_EXCEPTION(CreateBinaryTree(8));
+}
+
+TEST(RobotGenerator, LeggedRobot) {
+  RobotGeneratorParams params;
+  Robot robot = CreateLeggedRobot(6, 3, params);
+  EXPECT_LONGS_EQUAL(19, robot.numLinks());
+  EXPECT_LONGS_EQUAL(18, robot.numJoints());
+  EXPECT_LONGS_EQUAL(6, robot.link("body")->joints().size());
+
+  // The last link of each leg points straight down.
+  auto foot_link = robot.link("leg0_link2");
+  const Pose3 bTfoot =
+      foot_link->bMlink() * Pose3(Rot3(), Point3(params.link_length, 0, 0));
+  const double L = params.link_length;
+  EXPECT(assert_equal(Point3(params.body_radius + L, 0, -2 * L),
+                      bTfoot.translation(), 1e-9));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,124 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testSchurCondensing.cpp
+ * @brief Test condensing of per-step dynamics variables.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/Optimizer.h>
+#include <gtdynamics/optimizer/SchurCondensing.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include "trajectoryExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+// Condensing link poses, twists, twist accelerations and wrenches gives the
+// exact solution, over joint variables only.
+TEST(SchurCondensing, SolveCondensed) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const auto linear = graph.linearize(
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps));
+
+  const CondensedGraph condensed = Condense(*linear);
+  EXPECT_LONGS_EQUAL(trajectory_example::num_steps + 1,
+                     condensed.conditionals.size());
+  for (auto &&key : condensed.reduced.keys()) {
+    const std::string label = DynamicsSymbol(key).label();
+    EXPECT(label == "q" || label == "v" || label == "a" || label == "T");
+  }
+
+  const VectorValues expected = linear->optimize();
+  EXPECT(assert_equal(expected, SolveCondensed(*linear), 1e-6));
+  EXPECT(assert_equal(expected, SolveCondensed(*linear, Ordering(),
+                                               kCondensedLabels, 1),
+                      1e-6));
+  EXPECT(assert_equal(
+      expected, SolveCondensed(*linear, Ordering::Colamd(*linear)), 1e-6));
+
+  // Variables coupled across time steps, e.g., by pose collocation factors,
+  // are not condensed.
+  const auto model = noiseModel::Unit::Create(6);
+  GaussianFactorGraph coupled;
+  coupled.add(PoseKey(0, 0), I_6x6, PoseKey(0, 1), I_6x6, Vector6::Zero(),
+              model);
+  coupled.add(PoseKey(0, 0), I_6x6, Vector6::Ones(), model);
+  coupled.add(TwistKey(0, 1), I_6x6, PoseKey(0, 1), -I_6x6, Vector6::Zero(),
+              model);
+  const CondensedGraph partial = Condense(coupled);
+  EXPECT_LONGS_EQUAL(1, partial.conditionals.size());
+  const KeySet reduced_keys = partial.reduced.keys();
+  EXPECT(reduced_keys.exists(PoseKey(0, 0)));
+  EXPECT(reduced_keys.exists(PoseKey(0, 1)));
+  EXPECT(!reduced_keys.exists(TwistKey(0, 1)));
+  EXPECT(assert_equal(coupled.optimize(), SolveCondensed(coupled), 1e-9));
+}
+
+// Optimizing with condensed linear solves gives the same trajectory.
+TEST(SchurCondensing, Optimizer) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps);
+
+  OptimizationParameters parameters;
+  const Values expected = Optimizer(parameters).optimize(graph, init);
+  parameters.condense = true;
+  EXPECT(assert_equal(expected, Optimizer(parameters).optimize(graph, init),
+                      1e-6));
+
+  CondensedLMOptimizer optimizer(graph, init, parameters.lm_parameters);
+  EXPECT(assert_equal(expected, optimizer.optimize(), 1e-6));
+
+  // Condensed and PCG linear solves are exclusive.
+  parameters.pcg_parameters = TrajectoryPCGParams();
+  CHECK_EXCEPTION(Optimizer(parameters).optimize(graph, init),
+                  std::invalid_argument);
+}
+
+// The penalty method and augmented Lagrangian condense too.
+TEST(SchurCondensing, ConstrainedOptimizer) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps);
+
+  // The initial joint angle, zero, as a hard constraint.
+  const Key q0 = JointAngleKey(robot.joints()[0]->id(), 0);
+  EqualityConstraints constraints;
+  constraints.emplace_shared<DoubleExpressionEquality>(Double_(q0), 1e-3);
+
+  for (auto method : {OptimizationParameters::Method::PENALTY,
+                      OptimizationParameters::Method::AUGMENTED_LAGRANGIAN}) {
+    OptimizationParameters parameters;
+    parameters.method = method;
+    const Values expected =
+        Optimizer(parameters).optimize(graph, constraints, init);
+    parameters.condense = true;
+    EXPECT(assert_equal(
+        expected, Optimizer(parameters).optimize(graph, constraints, init),
+        1e-5));
+    parameters.pcg_parameters = TrajectoryPCGParams();
+    CHECK_EXCEPTION(Optimizer(parameters).optimize(graph, constraints, init),
+                    std::invalid_argument);
+  }
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
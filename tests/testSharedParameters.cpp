@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testSharedParameters.cpp
+ * @brief Test immutable parameter blocks shared between factors.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/factors/ContactKinematicsTwistFactor.h>
+#include <gtdynamics/factors/WrenchFactor.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/utils/SharedParameters.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/expressionTesting.h>
+
+#include <vector>
+
+using namespace gtdynamics;
+using gtsam::assert_equal;
+using gtsam::Matrix36;
+using gtsam::Matrix6;
+
+// Equal blocks are interned once, and freed when no longer used.
+TEST(SharedParameters, Share) {
+  const size_t size = SharedParameters::Size();
+  Matrix6 block = Matrix6::Identity() * 0.123;
+  auto a = SharedParameters::Share(block);
+  auto b = SharedParameters::Share(Matrix6(Matrix6::Identity() * 0.123));
+  EXPECT(a == b);
+  EXPECT_LONGS_EQUAL(size + 1, SharedParameters::Size());
+
+  block(2, 3) = 1e-12;
+  auto c = SharedParameters::Share(block);
+  EXPECT(a != c);
+  EXPECT(assert_equal(block, *c));
+  EXPECT_LONGS_EQUAL(size + 2, SharedParameters::Size());
+
+  // Same bits, different shapes.
+  auto d = SharedParameters::Share(gtsam::Vector6::Zero().eval());
+  auto e = SharedParameters::Share(gtsam::Matrix23::Zero().eval());
+  EXPECT(static_cast<const void *>(d.get()) !=
+         static_cast<const void *>(e.get()));
+
+  a.reset();
+  b.reset();
+  c.reset();
+  d.reset();
+  e.reset();
+  EXPECT_LONGS_EQUAL(size, SharedParameters::Size());
+}
+
+TEST(SharedParameters, SharedLinearExpression) {
+  Matrix36 A;
+  A << 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18;
+  const gtsam::Key key = TwistKey(0, 0);
+  const gtsam::Vector3_ expression =
+      SharedLinearExpression(A, gtsam::Vector6_(key));
+  gtsam::Values values;
+  const gtsam::Vector6 x = (gtsam::Vector6() << 1, -1, 2, 0, 3, 1).finished();
+  values.insert(key, x);
+  EXPECT(assert_equal(gtsam::Vector3(A * x), expression.value(values)));
+  EXPECT_CORRECT_EXPRESSION_JACOBIANS(expression, values, 1e-7, 1e-5);
+}
+
+// The wrench factors of identical links, at all time steps, share their
+// inertia, and contact factors at the same contact point their Jacobian.
+TEST(SharedParameters, Factors) {
+  const Robot robot = CreateLeggedRobot(4, 3);
+  const size_t size = SharedParameters::Size();
+  gtsam::NonlinearFactorGraph graph;
+  auto model_3 = gtsam::noiseModel::Unit::Create(3),
+       model_6 = gtsam::noiseModel::Unit::Create(6);
+  const gtsam::Pose3 cTcom(gtsam::Rot3(), gtsam::Point3(-0.15, 0, 0));
+  for (size_t k = 0; k < 10; k++) {
+    for (auto &&name : {"leg0_link1", "leg1_link2", "leg3_link1"}) {
+      const auto link = robot.link(name);
+      graph.add(WrenchFactor(model_6, link, {}, k, gtsam::Vector3(0, 0, -9.8)));
+      graph.emplace_shared<ContactKinematicsTwistFactor>(
+          TwistKey(link->id(), k), model_3, cTcom);
+    }
+  }
+  EXPECT_LONGS_EQUAL(60, graph.size());
+  // Inertia, negative inertia, and contact Jacobian.
+  EXPECT_LONGS_EQUAL(size + 3, SharedParameters::Size());
+
+  graph.resize(0);
+  EXPECT_LONGS_EQUAL(size, SharedParameters::Size());
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
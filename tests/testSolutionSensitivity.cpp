@@ -0,0 +1,150 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testSolutionSensitivity.cpp
+ * @brief Test derivatives of solutions w.r.t. problem parameters.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/factors/PointGoalFactor.h>
+#include <gtdynamics/optimizer/SolutionSensitivity.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <cmath>
+
+#include "trajectoryExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+// Two priors on a scalar: x* = theta s2^2 / (s1^2 + s2^2).
+TEST(SolutionSensitivity, PriorMean) {
+  const double s1 = 0.5, s2 = 2.0;
+  const Key key = JointAngleKey(0, 0);
+  auto graph_function = [&](const Vector &theta) {
+    NonlinearFactorGraph graph;
+    graph.addPrior(key, theta(0), noiseModel::Isotropic::Sigma(1, s1));
+    graph.addPrior(key, 0.0, noiseModel::Isotropic::Sigma(1, s2));
+    return graph;
+  };
+  const Vector theta = Vector1(1.0);
+  Values init;
+  init.insert(key, 0.0);
+  const Values solution =
+      LevenbergMarquardtOptimizer(graph_function(theta), init).optimize();
+
+  const SolutionSensitivity sensitivity(graph_function, theta, solution);
+  const double expected = s2 * s2 / (s1 * s1 + s2 * s2);
+  EXPECT_LONGS_EQUAL(1, sensitivity.numParameters());
+  EXPECT(assert_equal(Matrix1(expected), sensitivity.jacobian(key), 1e-6));
+  const Values updated = sensitivity.update(Vector1(1.5));
+  EXPECT_DOUBLES_EQUAL(1.5 * expected, updated.at<double>(key), 1e-6);
+
+  // The final linearization and factorization of a solve can be reused.
+  const auto linear = graph_function(theta).linearize(solution);
+  const SolutionSensitivity reused(
+      *linear, *linear->eliminateSequential(),
+      SolutionSensitivity::ErrorJacobians(graph_function, theta, solution),
+      theta, solution);
+  EXPECT(assert_equal(Matrix1(expected), reused.jacobian(key), 1e-6));
+  CHECK_EXCEPTION(SolutionSensitivity(*linear, *linear->eliminateSequential(),
+                                      {}, theta, solution),
+                  std::invalid_argument);
+}
+
+// Moving the target of a PointGoalFactor: the first-order update is much closer
+// to a new solve than the old solution, up to second-order terms and the
+// Gauss-Newton approximation of the Hessian.
+TEST(SolutionSensitivity, PointGoal) {
+  const Key key = PoseKey(0, 0);
+  const Point3 point_com(0, 0, 1);
+  auto graph_function = [&](const Vector &theta) {
+    NonlinearFactorGraph graph;
+    graph.addPrior(key, Pose3(), noiseModel::Isotropic::Sigma(6, 1.0));
+    graph.emplace_shared<PointGoalFactor>(
+        key, noiseModel::Isotropic::Sigma(3, 0.1), point_com, Point3(theta));
+    return graph;
+  };
+  auto solve = [&](const Vector &theta) {
+    Values init;
+    init.insert(key, Pose3());
+    LevenbergMarquardtParams params;
+    params.setRelativeErrorTol(1e-12);
+    params.setAbsoluteErrorTol(1e-12);
+    return LevenbergMarquardtOptimizer(graph_function(theta), init, params)
+        .optimize();
+  };
+
+  const Vector theta = Vector3(0.2, 0.1, 1.0);
+  const Values solution = solve(theta);
+  const SolutionSensitivity sensitivity(graph_function, theta, solution);
+  EXPECT_LONGS_EQUAL(6, sensitivity.jacobian(key).rows());
+  EXPECT_LONGS_EQUAL(3, sensitivity.jacobian(key).cols());
+
+  const Vector new_theta = theta + Vector3(1e-3, -2e-3, 1e-3);
+  const Pose3 expected = solve(new_theta).at<Pose3>(key);
+  const Pose3 updated = sensitivity.update(new_theta).at<Pose3>(key);
+  const Pose3 previous = solution.at<Pose3>(key);
+  EXPECT(expected.localCoordinates(updated).norm() <
+         0.1 * expected.localCoordinates(previous).norm());
+}
+
+// The derivative of a pendulum trajectory w.r.t. its time step matches central
+// differences of new solves.
+TEST(SolutionSensitivity, TimeStep) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const Key key = JointAngleKey(robot.joints().front()->id(),
+                                trajectory_example::num_steps);
+  auto graph_function = [&](const Vector &theta) {
+    return trajectory_example::Graph(robot, theta(0));
+  };
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps);
+  auto solve = [&](double dt) {
+    LevenbergMarquardtParams params;
+    params.setRelativeErrorTol(1e-14);
+    params.setAbsoluteErrorTol(1e-14);
+    return LevenbergMarquardtOptimizer(graph_function(Vector1(dt)), init,
+                                       params)
+        .optimize();
+  };
+
+  const double dt = 0.1, h = 1e-4;
+  const SolutionSensitivity sensitivity(graph_function, Vector1(dt),
+                                        solve(dt));
+  const double expected =
+      (solve(dt + h).atDouble(key) - solve(dt - h).atDouble(key)) / (2 * h);
+  EXPECT(std::abs(expected) > 1e-3);
+  EXPECT(assert_equal(Matrix1(expected), sensitivity.jacobian(key), 1e-4));
+}
+
+// A graph function that changes the factors is rejected.
+TEST(SolutionSensitivity, Inconsistent) {
+  const Key key = JointAngleKey(0, 0);
+  auto graph_function = [&](const Vector &theta) {
+    NonlinearFactorGraph graph;
+    graph.addPrior(key, 0.0, noiseModel::Isotropic::Sigma(1, 1.0));
+    if (theta(0) > 0.0) {
+      graph.addPrior(key, theta(0), noiseModel::Isotropic::Sigma(1, 1.0));
+    }
+    return graph;
+  };
+  Values solution;
+  solution.insert(key, 0.0);
+  CHECK_EXCEPTION(SolutionSensitivity(graph_function, Vector1(0.0), solution),
+                  std::invalid_argument);
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
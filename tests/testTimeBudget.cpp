@@ -0,0 +1,197 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testTimeBudget.cpp
+ * @brief Test wall-clock budgets of the optimizers.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/manifold/ManifoldOptimizerType1.h>
+#include <gtdynamics/optimizer/AugmentedLagrangianOptimizer.h>
+#include <gtdynamics/optimizer/MutableLMOptimizer.h>
+#include <gtdynamics/optimizer/PenaltyMethodOptimizer.h>
+#include <gtdynamics/optimizer/TimeBudget.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include "constrainedExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+// An unlimited budget optimizes as usual, an expired one not at all.
+TEST(TimeBudget, IterateWithinBudget) {
+  const auto graph = constrained_example::Cost();
+  const auto init_values = constrained_example::InitValues();
+  LevenbergMarquardtParams params;
+
+  LevenbergMarquardtOptimizer expected(graph, init_values, params);
+  expected.optimize();
+  LevenbergMarquardtOptimizer unlimited(graph, init_values, params);
+  EXPECT(IterateWithinBudget(&unlimited, params, TimeBudget()) ==
+         TerminationReason::CONVERGED);
+  EXPECT(assert_equal(expected.values(), unlimited.values()));
+
+  LevenbergMarquardtOptimizer limited(graph, init_values, params);
+  ConstrainedOptResult result;
+  Values last_complete;
+  EXPECT(IterateWithinBudget(&limited, params, TimeBudget(1e3), &result,
+                             &last_complete) == TerminationReason::CONVERGED);
+  EXPECT(assert_equal(expected.values(), limited.values(), 1e-9));
+  EXPECT(assert_equal(limited.values(), last_complete));
+  EXPECT_LONGS_EQUAL(limited.iterations(), result.iteration_times.size());
+
+  LevenbergMarquardtOptimizer expired(graph, init_values, params);
+  EXPECT(IterateWithinBudget(&expired, params, TimeBudget(0.0)) ==
+         TerminationReason::TIME_BUDGET);
+  EXPECT_LONGS_EQUAL(0, expired.iterations());
+}
+
+// Out of time, the penalty method returns its best iterate so far. Otherwise
+// it stops once feasible with a stationary cost, before its last iteration.
+TEST(TimeBudget, PenaltyMethod) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto init_values = constrained_example::InitValues();
+
+  PenaltyMethodParameters params;
+  const Values expected =
+      PenaltyMethodOptimizer(params).optimize(graph, constraints, init_values);
+
+  params.time_budget = 1e3;
+  ConstrainedOptResult result;
+  const Values actual = PenaltyMethodOptimizer(params).optimize(
+      graph, constraints, init_values, &result);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+  EXPECT(result.termination_reason == TerminationReason::CONVERGED);
+  EXPECT(result.iteration_times.size() < params.num_iterations);
+  EXPECT_LONGS_EQUAL(result.intermediate_values.size(),
+                     result.iteration_times.size());
+  EXPECT(result.elapsed_time >= result.iteration_times.back());
+
+  params.time_budget = 0.0;
+  ConstrainedOptResult expired;
+  const Values initial = PenaltyMethodOptimizer(params).optimize(
+      graph, constraints, init_values, &expired);
+  EXPECT(assert_equal(init_values, initial));
+  EXPECT(expired.termination_reason == TerminationReason::TIME_BUDGET);
+  EXPECT(expired.intermediate_values.empty());
+}
+
+// Likewise for the augmented Lagrangian method.
+TEST(TimeBudget, AugmentedLagrangian) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto init_values = constrained_example::InitValues();
+
+  AugmentedLagrangianParameters params;
+  const Values expected = AugmentedLagrangianOptimizer(params).optimize(
+      graph, constraints, init_values);
+
+  params.time_budget = 1e3;
+  ConstrainedOptResult result;
+  const Values actual = AugmentedLagrangianOptimizer(params).optimize(
+      graph, constraints, init_values, &result);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+  EXPECT(result.termination_reason == TerminationReason::CONVERGED);
+  EXPECT(result.intermediate_values.size() < params.num_iterations);
+
+  params.time_budget = 0.0;
+  ConstrainedOptResult expired;
+  const Values initial = AugmentedLagrangianOptimizer(params).optimize(
+      graph, constraints, init_values, &expired);
+  EXPECT(assert_equal(init_values, initial));
+  EXPECT(expired.termination_reason == TerminationReason::TIME_BUDGET);
+}
+
+// A manifold optimizer stopped between iterations returns the last complete
+// iterate, on the constraint manifold.
+TEST(TimeBudget, ManifoldOptimizerType1) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto init_values = constrained_example::InitValues();
+
+  LevenbergMarquardtParams nopt_params;
+  ManifoldOptimizerParameters params;
+  const Values expected = ManifoldOptimizerType1(params, nopt_params)
+                              .optimize(graph, constraints, init_values);
+
+  params.time_budget = 1e3;
+  ConstrainedOptResult result;
+  const Values actual = ManifoldOptimizerType1(params, nopt_params)
+                            .optimize(graph, constraints, init_values, &result);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+  EXPECT(result.termination_reason == TerminationReason::CONVERGED);
+  EXPECT(!result.iteration_times.empty());
+
+  // Cancelled after its first iteration, it returns that iterate.
+  LevenbergMarquardtParams one_iteration = nopt_params;
+  one_iteration.maxIterations = 1;
+  const Values first = ManifoldOptimizerType1(params, one_iteration)
+                           .optimize(graph, constraints, init_values);
+  CancellationToken token;
+  params.time_budget.reset();
+  params.cancellation_token = token;
+  params.progress_callback = [&token](const SolveProgress &) {
+    token.cancel();
+  };
+  ConstrainedOptResult cancelled;
+  const Values stopped =
+      ManifoldOptimizerType1(params, nopt_params)
+          .optimize(graph, constraints, init_values, &cancelled);
+  EXPECT(assert_equal(first, stopped, 1e-9));
+  EXPECT(cancelled.termination_reason == TerminationReason::CANCELLED);
+  EXPECT_LONGS_EQUAL(1, cancelled.iteration_times.size());
+  EXPECT(constraints.at(0)->feasible(stopped));
+}
+
+// A mutable LM optimizer stops between iterations once its budget expires.
+TEST(TimeBudget, MutableLMOptimizer) {
+  const auto graph = constrained_example::Cost();
+  const auto init_values = constrained_example::InitValues();
+  LevenbergMarquardtParams params;
+
+  MutableLMOptimizer unlimited(graph, init_values, params);
+  const Values expected = unlimited.optimize();
+
+  MutableLMOptimizer limited(graph, init_values, params);
+  limited.setTimeBudget(TimeBudget(1e3));
+  EXPECT(assert_equal(expected, limited.optimize(), 1e-9));
+  EXPECT(limited.terminationReason() == TerminationReason::CONVERGED);
+  EXPECT_LONGS_EQUAL(unlimited.iterations(), limited.iterations());
+
+  // Out of time, the initial values are the best iterate so far.
+  MutableLMOptimizer expired(graph, init_values, params);
+  expired.setTimeBudget(TimeBudget(0.0));
+  EXPECT(assert_equal(init_values, expired.optimize()));
+  EXPECT(expired.terminationReason() == TerminationReason::TIME_BUDGET);
+  EXPECT_LONGS_EQUAL(0, expired.iterations());
+}
+
+// The best iterate prefers feasible values, then lower cost.
+TEST(TimeBudget, BestIterate) {
+  const auto graph = constrained_example::Cost();
+  const auto constraints = constrained_example::Constraints();
+  const auto infeasible = constrained_example::InitValues();
+  Values feasible;
+  feasible.insert(constrained_example::x1_key, 0.0);
+  feasible.insert(constrained_example::x2_key, 0.0);
+
+  BestIterate best;
+  best.update(graph, constraints, infeasible);
+  EXPECT(!best.feasible());
+  best.update(graph, constraints, feasible);
+  EXPECT(best.feasible());
+  best.update(graph, constraints, infeasible);
+  EXPECT(assert_equal(feasible, best.values()));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
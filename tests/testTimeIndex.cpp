@@ -0,0 +1,88 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testTimeIndex.cpp
+ * @brief Test the time step index of trajectory keys.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/utils/TimeIndex.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+/// Two joint angles and a link pose at time steps 2 to 5, and two phases.
+Values Trajectory() {
+  Values values;
+  for (int k = 2; k <= 5; k++) {
+    InsertJointAngle(&values, 0, k, double(k));
+    InsertJointAngle(&values, 1, k, 10.0 + k);
+    InsertPose(&values, 0, k, Pose3(Rot3(), Point3(k, 0, 0)));
+  }
+  values.insert(PhaseKey(0), 0.1);
+  values.insert(PhaseKey(1), 0.2);
+  return values;
+}
+}  // namespace example
+
+TEST(TimeIndex, Keys) {
+  const Values values = example::Trajectory();
+  TimeIndex index(values);
+  EXPECT_LONGS_EQUAL(2, index.firstStep());
+  EXPECT_LONGS_EQUAL(5, index.lastStep());
+  EXPECT_LONGS_EQUAL(4, index.numSteps());
+
+  EXPECT_LONGS_EQUAL(3, index.keys(3).size());
+  EXPECT_LONGS_EQUAL(2, index.keys(3, "q").size());
+  EXPECT(index.keys(3, "p") == KeyVector{PoseKey(0, 3)});
+  EXPECT(index.keys(1).empty());
+  EXPECT(index.keys(3, "T").empty());
+  EXPECT(index.untimedKeys() == KeyVector({PhaseKey(0), PhaseKey(1)}));
+  EXPECT(index.labels() == std::vector<std::string>({"p", "q"}));
+
+  Values step = index.values(values, 4);
+  EXPECT_LONGS_EQUAL(3, step.size());
+  EXPECT_DOUBLES_EQUAL(14.0, JointAngle(step, 1, 4), 1e-12);
+  EXPECT_LONGS_EQUAL(6, index.values(values, 2, 3).size());
+}
+
+// Shifting back by 3 steps keeps steps 3 to 5, as 0 to 2.
+TEST(TimeIndex, Shift) {
+  const Values values = example::Trajectory();
+  TimeIndex index(values);
+  Values shifted = index.shift(values, -3);
+  EXPECT_LONGS_EQUAL(3 * 3 + 2, shifted.size());
+  EXPECT_DOUBLES_EQUAL(13.0, JointAngle(shifted, 1, 0), 1e-12);
+  EXPECT(assert_equal(Pose3(Rot3(), Point3(5, 0, 0)), Pose(shifted, 0, 2)));
+  EXPECT(!shifted.exists(JointAngleKey(0, 3)));
+  EXPECT_DOUBLES_EQUAL(0.2, shifted.atDouble(PhaseKey(1)), 1e-12);
+
+  EXPECT_LONGS_EQUAL(WrenchKey(2, 1, 7),
+                     TimeIndex::ShiftKey(WrenchKey(2, 1, 4), 3));
+  CHECK_EXCEPTION(TimeIndex::ShiftKey(PoseKey(0, 1), -2),
+                  std::invalid_argument);
+
+  // The shift map rekeys factor graphs.
+  NonlinearFactorGraph graph;
+  graph.emplace_shared<BetweenFactor<double>>(
+      JointAngleKey(0, 4), JointAngleKey(0, 5), 1.0,
+      noiseModel::Unit::Create(1));
+  auto rekeyed = graph.rekey(index.shiftMap(-4));
+  EXPECT(rekeyed.keys().exists(JointAngleKey(0, 0)));
+  EXPECT(rekeyed.keys().exists(JointAngleKey(0, 1)));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
@@ -0,0 +1,102 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testTracer.cpp
+ * @brief Test timeline tracer and its Chrome trace-event export.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/MutableLMOptimizer.h>
+#include <gtdynamics/utils/Tracer.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <sstream>
+#include <string>
+
+using namespace gtsam;
+using namespace gtdynamics;
+
+/* ************************************************************************* */
+TEST(Tracer, disabled) {
+  Tracer tracer;
+  EXPECT(!tracer.enabled());
+  tracer.record("span", 0.0, 1.0);
+  EXPECT_LONGS_EQUAL(0, tracer.events().size());
+}
+
+/* ************************************************************************* */
+TEST(Tracer, ringBuffer) {
+  Tracer tracer;
+  tracer.enable(3);
+  for (size_t i = 0; i < 5; i++) {
+    tracer.record("span", i, 1.0);
+  }
+  auto events = tracer.events();
+  EXPECT_LONGS_EQUAL(3, events.size());
+  EXPECT_LONGS_EQUAL(2, tracer.numDropped());
+  // Oldest events are dropped first.
+  EXPECT_DOUBLES_EQUAL(2.0, events.front().start_us, 1e-9);
+  EXPECT_DOUBLES_EQUAL(4.0, events.back().start_us, 1e-9);
+
+  tracer.clear();
+  EXPECT_LONGS_EQUAL(0, tracer.events().size());
+  EXPECT_LONGS_EQUAL(0, tracer.numDropped());
+}
+
+/* ************************************************************************* */
+TEST(Tracer, chromeTrace) {
+  Tracer tracer;
+  tracer.enable();
+  tracer.setThreadName("main");
+  tracer.record("LM_iterate", 1.0, 2.5);
+
+  std::stringstream ss;
+  tracer.writeChromeTrace(ss);
+  const std::string json = ss.str();
+  EXPECT(json.find("\"traceEvents\"") != std::string::npos);
+  EXPECT(json.find("\"name\":\"LM_iterate\"") != std::string::npos);
+  EXPECT(json.find("\"ph\":\"X\"") != std::string::npos);
+  EXPECT(json.find("\"dur\":2.500") != std::string::npos);
+  EXPECT(json.find("\"args\":{\"name\":\"main\"}") != std::string::npos);
+}
+
+/* ************************************************************************* */
+// Optimizer iterations are recorded in the process-wide tracer.
+TEST(Tracer, optimizerSpans) {
+  Key x1_key = 1, x2_key = 2;
+  NonlinearFactorGraph graph;
+  auto noise = noiseModel::Unit::Create(6);
+  graph.addPrior<Pose3>(x1_key, Pose3(), noise);
+  graph.emplace_shared<BetweenFactor<Pose3>>(
+      x1_key, x2_key, Pose3(Rot3(), Point3(0, 0, 1)), noise);
+  Values values;
+  values.insert(x1_key, Pose3());
+  values.insert(x2_key, Pose3());
+
+  Tracer &tracer = Tracer::Instance();
+  tracer.enable();
+  MutableLMOptimizer optimizer(graph, values);
+  optimizer.optimize();
+  tracer.disable();
+
+  size_t num_iterate = 0;
+  for (const auto &event : tracer.events()) {
+    if (std::string(event.name) == "LM_iterate") num_iterate++;
+    EXPECT(event.duration_us >= 0.0);
+  }
+  EXPECT(num_iterate > 0);
+  tracer.clear();
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
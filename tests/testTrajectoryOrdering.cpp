@@ -0,0 +1,128 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testTrajectoryOrdering.cpp
+ * @brief Test time-structured elimination orderings.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/MutableLMOptimizer.h>
+#include <gtdynamics/optimizer/Optimizer.h>
+#include <gtdynamics/optimizer/TrajectoryOrdering.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+
+#include <algorithm>
+
+#include "trajectoryExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace example {
+/// Depth of a Bayes tree clique, i.e., its longest path to a leaf.
+size_t Depth(const GaussianBayesTree::sharedClique &clique) {
+  size_t depth = 0;
+  for (auto &&child : clique->children) depth = std::max(depth, Depth(child));
+  return depth + 1;
+}
+}  // namespace example
+
+// Keys are ordered by time step, and by variable type within a step.
+TEST(TrajectoryOrdering, TimeOrdering) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const KeyVector keys = trajectory_example::Graph(robot).keyVector();
+  EXPECT(IsTrajectory(keys));
+
+  const Ordering ordering = TimeOrdering(keys);
+  EXPECT_LONGS_EQUAL(keys.size(), ordering.size());
+  EXPECT_LONGS_EQUAL(0, DynamicsSymbol(ordering.front()).time());
+  EXPECT_LONGS_EQUAL(trajectory_example::num_steps,
+                     DynamicsSymbol(ordering.back()).time());
+  for (size_t i = 1; i < ordering.size(); i++) {
+    EXPECT(DynamicsSymbol(ordering[i - 1]).time() <=
+           DynamicsSymbol(ordering[i]).time());
+  }
+  const std::string first_label = DynamicsSymbol(ordering.front()).label();
+  EXPECT(first_label == "F" || first_label == "T");
+
+  // The middle step of the nested dissection comes last.
+  const Ordering dissection = NestedDissectionTimeOrdering(keys);
+  EXPECT_LONGS_EQUAL(keys.size(), dissection.size());
+  EXPECT_LONGS_EQUAL(trajectory_example::num_steps / 2,
+                     DynamicsSymbol(dissection.back()).time());
+
+  // Phase durations come last.
+  const Ordering with_phase = TimeOrdering({PhaseKey(0), JointAngleKey(0, 1),
+                                            JointAngleKey(0, 0)});
+  const KeyVector expected{JointAngleKey(0, 0), JointAngleKey(0, 1),
+                           PhaseKey(0)};
+  EXPECT(KeyVector(with_phase.begin(), with_phase.end()) == expected);
+
+  // Keys that are not DynamicsSymbols are left to COLAMD.
+  EXPECT(!IsTrajectory({Symbol('x', 1), Symbol('x', 2)}));
+  NonlinearFactorGraph graph;
+  graph.addPrior<double>(Symbol('x', 1), 0.0);
+  EXPECT(!TrajectoryOrdering(graph, OrderingType::AUTOMATIC));
+}
+
+// All orderings give the same solution.
+TEST(TrajectoryOrdering, Optimizer) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps);
+
+  OptimizationParameters parameters;
+  const Values expected = Optimizer(parameters).optimize(graph, init);
+  for (auto type : {OrderingType::TIME, OrderingType::NESTED_DISSECTION,
+                    OrderingType::AUTOMATIC}) {
+    parameters.ordering_type = type;
+    EXPECT(assert_equal(expected, Optimizer(parameters).optimize(graph, init),
+                        1e-6));
+  }
+}
+
+// Nested dissection gives a balanced Bayes tree, for parallel elimination.
+TEST(TrajectoryOrdering, NestedDissection) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const auto linear = graph.linearize(
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps));
+
+  // Elimination in time order is a chain, while the two halves of the nested
+  // dissection are independent subtrees below the middle step.
+  const auto time_tree =
+      linear->eliminateMultifrontal(TimeOrdering(graph.keyVector()));
+  const auto dissection_tree = linear->eliminateMultifrontal(
+      NestedDissectionTimeOrdering(graph.keyVector()));
+  EXPECT(example::Depth(dissection_tree->roots().front()) <
+         example::Depth(time_tree->roots().front()));
+  EXPECT(assert_equal(time_tree->optimize(), dissection_tree->optimize(),
+                      1e-6));
+
+  // MutableLMOptimizer takes an ordering type.
+  MutableLMOptimizer optimizer;
+  optimizer.setGraph(graph, OrderingType::NESTED_DISSECTION);
+  EXPECT(optimizer.params().ordering);
+  EXPECT(assert_equal(NestedDissectionTimeOrdering(graph.keyVector()),
+                      *optimizer.params().ordering));
+  optimizer.setGraph(graph, OrderingType::COLAMD);
+  EXPECT(assert_equal(graph.orderingCOLAMD(), *optimizer.params().ordering));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
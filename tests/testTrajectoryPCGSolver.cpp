@@ -0,0 +1,102 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testTrajectoryPCGSolver.cpp
+ * @brief Test the matrix-free PCG solver for trajectory problems.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/optimizer/Optimizer.h>
+#include <gtdynamics/optimizer/TrajectoryPCGSolver.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/Initializer.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include "trajectoryExample.h"
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+// Both preconditioners converge to the direct solution.
+TEST(TrajectoryPCGSolver, Solve) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const auto linear = graph.linearize(
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps));
+  const VectorValues expected = linear->optimize();
+
+  TrajectoryPCGParams params;
+  params.preconditioner = TrajectoryPCGParams::BLOCK_JACOBI;
+  TrajectoryPCGSolver jacobi(*linear, params);
+  EXPECT(assert_equal(expected, jacobi.solve(), 1e-6));
+  EXPECT(jacobi.residual() <= params.relative_tolerance);
+
+  params.preconditioner = TrajectoryPCGParams::BLOCK_TRIDIAGONAL;
+  TrajectoryPCGSolver tridiagonal(*linear, params);
+  EXPECT(assert_equal(expected, tridiagonal.solve(), 1e-6));
+  EXPECT(tridiagonal.iterations() < jacobi.iterations());
+  EXPECT(tridiagonal.preconditionerSize() > jacobi.preconditionerSize());
+
+  // The Hessian-vector product is linear and symmetric.
+  const Vector x = Vector::LinSpaced(expected.dim(), -1.0, 1.0);
+  const Vector z = Vector::Ones(expected.dim());
+  const Vector y = tridiagonal.multiplyHessian(x);
+  EXPECT(assert_equal(Vector(2 * y), tridiagonal.multiplyHessian(2 * x), 1e-9));
+  EXPECT_DOUBLES_EQUAL(z.dot(y), x.dot(tridiagonal.multiplyHessian(z)), 1e-6);
+}
+
+// Hard constraints have no finite whitened Jacobian.
+TEST(TrajectoryPCGSolver, Constrained) {
+  GaussianFactorGraph graph;
+  graph.add(JointAngleKey(0, 0), I_1x1, Vector1(1.0),
+            noiseModel::Constrained::All(1));
+  CHECK_EXCEPTION(TrajectoryPCGSolver(graph), std::invalid_argument);
+}
+
+// A rank-deficient system stops at a solution instead of dividing by zero.
+TEST(TrajectoryPCGSolver, RankDeficient) {
+  const Key q0 = JointAngleKey(0, 0), q1 = JointAngleKey(1, 0);
+  GaussianFactorGraph graph;
+  graph.add(q0, I_1x1, q1, -I_1x1, Vector1(1.0), noiseModel::Unit::Create(1));
+  TrajectoryPCGParams params;
+  params.relative_tolerance = 0.0;
+  params.max_iterations = 10;
+  TrajectoryPCGSolver solver(graph, params);
+  const VectorValues solution = solver.solve();
+  const double x0 = solution.at(q0)(0), x1 = solution.at(q1)(0);
+  EXPECT(std::isfinite(x0) && std::isfinite(x1));
+  EXPECT_DOUBLES_EQUAL(1.0, x0 - x1, 1e-9);
+}
+
+// Optimizing with PCG linear solves gives the same trajectory.
+TEST(TrajectoryPCGSolver, Optimizer) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  const auto graph = trajectory_example::Graph(robot);
+  Initializer initializer;
+  const Values init =
+      initializer.ZeroValuesTrajectory(robot, trajectory_example::num_steps);
+
+  OptimizationParameters parameters;
+  const Values expected = Optimizer(parameters).optimize(graph, init);
+  parameters.pcg_parameters = TrajectoryPCGParams();
+  EXPECT(assert_equal(expected, Optimizer(parameters).optimize(graph, init),
+                      1e-4));
+
+  PCGLMOptimizer optimizer(graph, init, parameters.lm_parameters);
+  EXPECT(assert_equal(expected, optimizer.optimize(), 1e-4));
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
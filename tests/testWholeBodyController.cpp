@@ -0,0 +1,140 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  testWholeBodyController.cpp
+ * @brief Test the whole-body QP controller.
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtdynamics/dynamics/WholeBodyController.h>
+#include <gtdynamics/universal_robot/RobotGenerator.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/base/TestableAssertions.h>
+
+using namespace gtdynamics;
+using namespace gtsam;
+
+namespace {
+const Vector3 kGravity(0, 0, -9.8);
+
+/// Walker with bent knees at rest, and its four feet as contact points.
+struct Walker {
+  Robot robot;
+  PointOnLinks feet;
+  Values state;
+
+  explicit Walker(const RobotGeneratorParams &params = RobotGeneratorParams())
+      : robot(CreateLeggedRobot(4, 3, params)) {
+    Values values;
+    auto body = robot.link("body");
+    InsertPose(&values, body->id(), Pose3(Rot3(), Point3(0, 0, 0.5)));
+    InsertTwist(&values, body->id(), Z_6x1);
+    for (size_t l = 0; l < 4; l++) {
+      const std::string leg = "leg" + std::to_string(l);
+      InsertJointAngle(&values, robot.joint(leg + "_joint0")->id(), 0.0);
+      InsertJointAngle(&values, robot.joint(leg + "_joint1")->id(), 0.3);
+      InsertJointAngle(&values, robot.joint(leg + "_joint2")->id(), -0.6);
+      feet.emplace_back(robot.link(leg + "_link2"),
+                        Point3(params.link_length / 2, 0, 0));
+    }
+    for (auto &&joint : robot.joints()) {
+      InsertJointVel(&values, joint->id(), 0.0);
+    }
+    state = robot.forwardKinematics(values, 0, std::string("body"));
+  }
+
+  /// Sum of the contact forces in the world frame.
+  Vector3 totalContactForce(const VectorValues &result) const {
+    Vector3 total = Z_3x1;
+    for (auto &&foot : feet) {
+      const int i = foot.link->id();
+      total += Pose(state, i).rotation() *
+               Vector3(result.at(ContactWrenchKey(i, 0, 0)).tail<3>());
+    }
+    return total;
+  }
+};
+}  // namespace
+
+// With tight acceleration tasks, the torque equals inverse dynamics.
+TEST(WholeBodyController, FixedBase) {
+  auto robot = simple_urdf_eq_mass::getRobot().fixLink("l1");
+  auto l1 = robot.link("l1");
+  const int j = robot.joint("j1")->id();
+
+  Values values;
+  InsertPose(&values, l1->id(), l1->bMcom());
+  InsertTwist(&values, l1->id(), Z_6x1);
+  InsertJointAngle(&values, j, 0.0);
+  InsertJointVel(&values, j, 0.0);
+  Values state = robot.forwardKinematics(values, 0, std::string("l1"));
+
+  WholeBodyControllerParams params;
+  params.gravity = kGravity;
+  WholeBodyController controller(robot, {}, params);
+  controller.setJointAccelTask("j1", 4.0, 1e-6);
+  VectorValues result = controller.compute(state);
+
+  Values desired_accels = state;
+  InsertJointAccel(&desired_accels, j, 4.0);
+  Values expected =
+      DynamicsGraph(kGravity).linearSolveID(robot, 0, desired_accels);
+  EXPECT_DOUBLES_EQUAL(4.0, JointAccel(result, j, 0)[0], 1e-4);
+  EXPECT_DOUBLES_EQUAL(Torque(expected, j), Torque(result, j, 0)[0], 1e-3);
+  EXPECT_LONGS_EQUAL(0, controller.numActive());
+}
+
+// The feet carry the weight of a standing walker within the friction cone.
+TEST(WholeBodyController, Standing) {
+  Walker walker;
+  WholeBodyControllerParams params;
+  params.gravity = kGravity;
+  WholeBodyController controller(walker.robot, walker.feet, params);
+  controller.setLinkAccelTask("body", Z_6x1, 1e-4);
+  VectorValues result = controller.compute(walker.state);
+
+  double mass = 0;
+  for (auto &&link : walker.robot.links()) mass += link->mass();
+  EXPECT(assert_equal(Vector3(-mass * kGravity),
+                      walker.totalContactForce(result), 1e-2));
+  for (auto &&joint : walker.robot.joints()) {
+    EXPECT_DOUBLES_EQUAL(0, JointAccel(result, joint->id(), 0)[0], 1e-3);
+  }
+  for (auto &&constraint : controller.inequalities(walker.state)) {
+    EXPECT(constraint.violation(result) < 1e-4);
+  }
+
+  // Warm start: the same state is solved in a single iteration.
+  VectorValues again = controller.compute(walker.state);
+  EXPECT_LONGS_EQUAL(1, controller.iterations());
+  EXPECT(assert_equal(result, again, 1e-9));
+}
+
+// Torques saturate at their limits, at the expense of the tasks.
+TEST(WholeBodyController, TorqueLimits) {
+  RobotGeneratorParams robot_params;
+  robot_params.torque_limit = 1.0;
+  Walker walker(robot_params);
+
+  WholeBodyControllerParams params;
+  params.gravity = kGravity;
+  WholeBodyController controller(walker.robot, walker.feet, params);
+  controller.setLinkAccelTask("body", Z_6x1, 1e-4);
+  VectorValues result = controller.compute(walker.state);
+
+  EXPECT(controller.numActive() > 0);
+  for (auto &&joint : walker.robot.joints()) {
+    EXPECT(std::abs(Torque(result, joint->id(), 0)[0]) < 1.0 + 1e-3);
+  }
+}
+
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
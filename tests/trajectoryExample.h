@@ -0,0 +1,47 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  trajectoryExample.h
+ * @brief Forward dynamics trajectory of a pendulum, for testing the linear
+ * solvers and orderings of trajectory graphs.
+ */
+
+#pragma once
+
+#include <gtdynamics/dynamics/DynamicsGraph.h>
+#include <gtdynamics/universal_robot/RobotModels.h>
+#include <gtdynamics/utils/values.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+namespace gtdynamics {
+namespace trajectory_example {
+
+/// Number of time steps of the trajectory.
+const int num_steps = 5;
+
+/// Forward dynamics trajectory of a one-link pendulum of time step dt, with
+/// priors.
+gtsam::NonlinearFactorGraph Graph(const Robot &robot, double dt = 0.1) {
+  DynamicsGraph graph_builder(simple_urdf_eq_mass::gravity,
+                              simple_urdf_eq_mass::planar_axis);
+  gtsam::Values known_values;
+  for (auto &&joint : robot.joints()) {
+    InsertJointAngle(&known_values, joint->id(), 0, 0.0);
+    InsertJointVel(&known_values, joint->id(), 0, 0.0);
+    for (int k = 0; k <= num_steps; k++) {
+      InsertTorque(&known_values, joint->id(), k, 1.0 + k);
+    }
+  }
+  auto graph = graph_builder.trajectoryFG(robot, num_steps, dt);
+  graph.add(graph_builder.trajectoryFDPriors(robot, num_steps, known_values));
+  return graph;
+}
+
+}  // namespace trajectory_example
+}  // namespace gtdynamics
@@ -0,0 +1,31 @@
+/* ----------------------------------------------------------------------------
+ * GTDynamics Copyright 2020, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file  wrenchHelpers.h
+ * @brief Helpers for testing the dynamics formulations without joint wrench
+ * variables.
+ */
+
+#pragma once
+
+#include <gtdynamics/utils/DynamicsSymbol.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+
+namespace gtdynamics {
+namespace wrench_helpers {
+
+/// Whether any key of the graph is a joint wrench.
+inline bool HasWrenches(const gtsam::NonlinearFactorGraph &graph) {
+  for (auto &&key : graph.keys()) {
+    if (DynamicsSymbol(key).label() == "F") return true;
+  }
+  return false;
+}
+
+}  // namespace wrench_helpers
+}  // namespace gtdynamics